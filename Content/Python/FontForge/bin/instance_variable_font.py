@@ -0,0 +1,89 @@
+import argparse
+import concurrent.futures
+import json
+import os
+import pathlib
+import sys
+
+parser = argparse.ArgumentParser(
+        description="Write static instances of a variable font. Each worker process parses the font once and the instances are written in parallel."
+    )
+parser.add_argument("input_filename", help="Path to the variable font file (.ttf or .otf)")
+parser.add_argument("jobs_filename", help='JSON list of {"output": path, "spec": "wght=700,wdth=75,ital=1" or a named instance}')
+
+try:
+  from fontTools.ttLib import TTFont
+  from fontTools.varLib import instancer
+except ImportError:
+  print("fontTools is required for variable fonts. Install it with: ffpython -m pip install fonttools")
+  sys.exit(2)
+
+
+def to_path(arg):
+  if '\\' in arg or ':' in arg:
+    return os.path.abspath(pathlib.Path(pathlib.PureWindowsPath(arg)))
+  return os.path.abspath(pathlib.Path(pathlib.PurePosixPath(arg)))
+
+
+def resolve_limits(font, spec):
+  axes = {axis.axisTag: axis for axis in font["fvar"].axes}
+  # Every axis is pinned, so each instance is fully static.
+  limits = {tag: axis.defaultValue for tag, axis in axes.items()}
+  if "=" not in spec:
+    for named in font["fvar"].instances:
+      if font["name"].getDebugName(named.subfamilyNameID) == spec:
+        limits.update(named.coordinates)
+        return limits
+    raise ValueError(f"No named instance '{spec}'")
+  for entry in spec.split(","):
+    tag, value = entry.strip().split("=")
+    value = float(value)
+    # Fonts without an ital axis usually slant instead.
+    if tag == "ital" and "ital" not in axes and "slnt" in axes:
+      tag, value = "slnt", (axes["slnt"].minValue if value else axes["slnt"].defaultValue)
+    if tag in axes:
+      limits[tag] = min(max(value, axes[tag].minValue), axes[tag].maxValue)
+  return limits
+
+
+# One parsed font per worker process, instancing never shares a TTFont across threads.
+worker_font = None
+
+
+def open_worker_font(input_filename):
+  global worker_font
+  worker_font = TTFont(input_filename, lazy=False)
+
+
+def write_instance(job):
+  limits = resolve_limits(worker_font, job["spec"])
+  instance = instancer.instantiateVariableFont(worker_font, limits, inplace=False)
+  instance.save(to_path(job["output"]))
+  return job["output"], limits
+
+
+if __name__ == "__main__":
+  input_filename = to_path(sys.argv[1])
+  jobs_filename = to_path(sys.argv[2])
+
+  with open(jobs_filename, "r", encoding="utf-8") as f:
+    jobs = json.load(f)
+
+  print(f"Inpath: {input_filename}, {len(jobs)} instances")
+  if "fvar" not in TTFont(input_filename):
+    print("Not a variable font")
+    sys.exit(1)
+
+  failed = 0
+  workers = min(len(jobs), os.cpu_count() or 1) or 1
+  with concurrent.futures.ProcessPoolExecutor(max_workers=workers, initializer=open_worker_font, initargs=(input_filename,)) as pool:
+    futures = [pool.submit(write_instance, job) for job in jobs]
+    for future in concurrent.futures.as_completed(futures):
+      try:
+        output, limits = future.result()
+        print(f"Wrote {output} at {limits}")
+      except Exception as error:
+        failed += 1
+        print(f"Instance failed: {error}")
+
+  sys.exit(1 if failed else 0)
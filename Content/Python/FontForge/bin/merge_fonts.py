@@ -0,0 +1,82 @@
+import fontforge
+import argparse
+import pathlib
+import os
+import sys
+import tempfile
+
+parser = argparse.ArgumentParser(
+        description="Merge a Latin font and a CJK font into one face using FontForge."
+    )
+parser.add_argument("latin_filename", help="Font whose glyphs, names and line spacing win")
+parser.add_argument("cjk_filename", help="Font that fills in every code point the Latin font does not map")
+parser.add_argument("output_filename", help="Path for the merged font file")
+
+# TrueType and CFF glyph ids are 16 bit.
+MAX_GLYPHS = 65535
+
+
+def to_path(arg):
+  if '\\' in arg or ':' in arg:
+    return os.path.abspath(pathlib.Path(pathlib.PureWindowsPath(arg)))
+  return os.path.abspath(pathlib.Path(pathlib.PurePosixPath(arg)))
+
+
+latin_filename = to_path(sys.argv[1])
+cjk_filename = to_path(sys.argv[2])
+output_filename = to_path(sys.argv[3])
+
+print(f"Latin: {latin_filename}, CJK: {cjk_filename}, Outpath: {output_filename}")
+
+latin = fontforge.open(latin_filename)
+cjk = fontforge.open(cjk_filename)
+
+# Outlines are merged in font units, so the CJK font is scaled to the Latin em first.
+if cjk.em != latin.em:
+  print(f"Scaling CJK font from {cjk.em} to {latin.em} units per em")
+  cjk.em = latin.em
+
+# Names already in the Latin font would shadow the CJK glyphs, only unmapped code points are brought over.
+mapped = {glyph.unicode for glyph in latin.glyphs() if glyph.unicode >= 0}
+removed = [glyph.glyphname for glyph in cjk.glyphs() if glyph.unicode in mapped or glyph.glyphname in latin]
+for name in removed:
+  if name != ".notdef":
+    cjk.removeGlyph(name)
+
+total = sum(1 for _ in latin.glyphs()) + sum(1 for _ in cjk.glyphs())
+if total > MAX_GLYPHS:
+  print(f"The merged font would have {total} glyphs, more than {MAX_GLYPHS}")
+  sys.exit(3)
+
+# Line spacing covers both scripts, so CJK glyphs are not clipped in Latin-sized rows.
+ascent = max(latin.hhea_ascent, cjk.hhea_ascent)
+descent = min(latin.hhea_descent, cjk.hhea_descent)
+win_ascent = max(latin.os2_winascent, cjk.os2_winascent)
+win_descent = max(latin.os2_windescent, cjk.os2_windescent)
+typo_ascent = max(latin.os2_typoascent, cjk.os2_typoascent)
+typo_descent = min(latin.os2_typodescent, cjk.os2_typodescent)
+
+with tempfile.TemporaryDirectory() as temp_dir:
+  scaled = os.path.join(temp_dir, "cjk.sfd")
+  cjk.save(scaled)
+  latin.mergeFonts(scaled)
+
+latin.hhea_ascent_add = False
+latin.hhea_descent_add = False
+latin.os2_winascent_add = False
+latin.os2_windescent_add = False
+latin.os2_typoascent_add = False
+latin.os2_typodescent_add = False
+latin.hhea_ascent = ascent
+latin.hhea_descent = descent
+latin.os2_winascent = win_ascent
+latin.os2_windescent = win_descent
+latin.os2_typoascent = typo_ascent
+latin.os2_typodescent = typo_descent
+
+latin.familyname = f"{latin.familyname} {cjk.familyname}"
+latin.fullname = f"{latin.fullname} {cjk.familyname}"
+latin.fontname = f"{latin.fontname}-{cjk.fontname}"[:63]
+
+print(f"Merged {total} glyphs")
+latin.generate(output_filename)
@@ -0,0 +1,52 @@
+import fontforge
+import argparse
+import pathlib
+import os
+import sys
+
+parser = argparse.ArgumentParser(
+        description="Keep only the glyphs needed for a list of code points using FontForge."
+    )
+parser.add_argument("input_filename", help="Path to the input font file (.ttf or .otf)")
+parser.add_argument("output_filename", help="Path for the trimmed font file")
+parser.add_argument("codepoints_filename", help="Text file with one hexadecimal code point per line")
+
+
+def to_path(arg):
+  if '\\' in arg or ':' in arg:
+    return os.path.abspath(pathlib.Path(pathlib.PureWindowsPath(arg)))
+  return os.path.abspath(pathlib.Path(pathlib.PurePosixPath(arg)))
+
+
+input_filename = to_path(sys.argv[1])
+output_filename = to_path(sys.argv[2])
+codepoints_filename = to_path(sys.argv[3])
+
+print(f"Inpath: {input_filename}, Outpath: {output_filename}, Codepoints: {codepoints_filename}")
+
+with open(codepoints_filename, "r") as f:
+  codepoints = {int(line, 16) for line in f if line.strip()}
+
+font = fontforge.open(input_filename)
+
+# Glyphs mapped to a wanted code point, plus .notdef and anything they reference as components.
+keep = {".notdef"}
+for glyph in font.glyphs():
+  if glyph.unicode in codepoints or (glyph.altuni and any(alt[0] in codepoints for alt in glyph.altuni)):
+    keep.add(glyph.glyphname)
+pending = list(keep)
+while pending:
+  name = pending.pop()
+  if name not in font:
+    continue
+  for reference in font[name].references:
+    if reference[0] not in keep:
+      keep.add(reference[0])
+      pending.append(reference[0])
+
+removed = [glyph.glyphname for glyph in font.glyphs() if glyph.glyphname not in keep]
+for name in removed:
+  font.removeGlyph(name)
+
+print(f"Kept {len(keep)} glyphs, removed {len(removed)}")
+font.generate(output_filename)
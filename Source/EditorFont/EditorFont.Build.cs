@@ -45,11 +45,19 @@ public class EditorFont : ModuleRules
 				"Slate",
 				"SlateCore",
                 "DesktopPlatform",
+				"Json",
+				// Engine-independent scan, validate, hash, install and conversion planning.
+				"EditorFontCore",
 				// ... add private dependencies that you statically link with here ...	
 			}
 			);
 		
 		
+		// Font stats open faces with their own FreeType library to count what Slate would allocate.
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "FreeType2");
+		// The text benchmark shapes its corpus with the same HarfBuzz build Slate uses.
+		AddEngineThirdPartyPrivateStaticDependencies(Target, "HarfBuzz");
+
 		DynamicallyLoadedModuleNames.AddRange(
 			new string[]
 			{
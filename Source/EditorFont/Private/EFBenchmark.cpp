@@ -0,0 +1,287 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFBenchmark.h"
+
+#include "EFFontScanner.h"
+#include "EFWorkQueue.h"
+#include "UDevEditor.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+
+double FEFBenchmark::FResult::Percentile(double Fraction) const
+{
+    if (SamplesMs.Num() == 0) { return 0.0; }
+    TArray<double> Sorted = SamplesMs;
+    Sorted.Sort();
+    // Nearest-rank, so p95 of 20 samples is the 19th.
+    const int32 Rank = FMath::Clamp(FMath::CeilToInt(Fraction * Sorted.Num()), 1, Sorted.Num());
+    return Sorted[Rank - 1];
+}
+
+double FEFBenchmark::FResult::Mean() const
+{
+    if (SamplesMs.Num() == 0) { return 0.0; }
+    double Total = 0.0;
+    for (double Sample : SamplesMs) { Total += Sample; }
+    return Total / SamplesMs.Num();
+}
+
+double FEFBenchmark::FResult::Throughput() const
+{
+    const double MeanMs = Mean();
+    return MeanMs > 0.0 ? ItemsPerSample * 1000.0 / MeanMs : 0.0;
+}
+
+FEFBenchmark::FEFBenchmark(UDevEditor* InSettings, const FOptions& InOptions)
+    : Settings(InSettings)
+    , Options(InOptions)
+{
+    if (Options.OutputDir.IsEmpty())
+    {
+        Options.OutputDir = FPaths::ProjectSavedDir() / TEXT("EditorFont/Benchmark");
+    }
+    SandboxDir = FPaths::ProjectSavedDir() / TEXT("EditorFont/Benchmark/Sandbox");
+}
+
+bool FEFBenchmark::Run(TSharedRef<FJsonObject> Report)
+{
+    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+
+    // Everything the timed paths touch on the settings object is put back afterwards, and none of it is saved meanwhile.
+    const FString SavedFontPath = Settings->FontPath;
+    const TArray<FEFFontSnapshot> SavedSnapshots = Settings->FontSnapshots;
+    const int32 SavedSnapshotCursor = Settings->SnapshotCursor;
+    const TMap<FName, FString> SavedToggleStates = Settings->ToggleStates;
+    TMap<FNameProperty*, FName> SavedSlots;
+    for (FNameProperty* Slot : Settings->GetFontSlotProperties())
+    {
+        SavedSlots.Add(Slot, Slot->GetPropertyValue_InContainer(Settings));
+    }
+    TGuardValue<bool> SuppressConfigSave(Settings->bSuppressConfigSave, true);
+    // A locked font path keeps ResetToDefaults from pointing it at, and creating, the TempFonts folder.
+    Settings->ToggleStates.Add(GET_MEMBER_NAME_CHECKED(UDevEditor, FontPath), TEXT("False"));
+    Settings->FontDestinationOverride = SandboxDir;
+    PlatformFile.CreateDirectoryTree(*(SandboxDir / TEXT("Slate/Fonts")));
+    PlatformFile.CreateDirectoryTree(*(SandboxDir / TEXT("Editor/Slate/Fonts")));
+
+    for (int32 NumFiles : Options.LibrarySizes)
+    {
+        const FString LibraryDir = FPaths::ProjectSavedDir() / FString::Printf(TEXT("EditorFont/Benchmark/Library_%d"), NumFiles);
+        if (!GenerateLibrary(LibraryDir, NumFiles))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Failed to generate a %d file library in %s"), NumFiles, *LibraryDir);
+            continue;
+        }
+        Settings->FontPath = LibraryDir;
+        TimeScan(LibraryDir, NumFiles);
+        TimeInstall(LibraryDir, NumFiles);
+        TimeFlush(NumFiles);
+        TimeReset(NumFiles);
+        TimeConversion(LibraryDir, NumFiles);
+        PlatformFile.DeleteDirectoryRecursively(*LibraryDir);
+    }
+
+    Settings->FontDestinationOverride.Reset();
+    Settings->FontPath = SavedFontPath;
+    Settings->FontSnapshots = SavedSnapshots;
+    Settings->SnapshotCursor = SavedSnapshotCursor;
+    Settings->ToggleStates = SavedToggleStates;
+    for (const TPair<FNameProperty*, FName>& Slot : SavedSlots)
+    {
+        Slot.Key->SetPropertyValue_InContainer(Settings, Slot.Value);
+    }
+    PlatformFile.DeleteDirectoryRecursively(*SandboxDir);
+
+    TArray<TSharedPtr<FJsonValue>> Entries;
+    for (const FResult& Result : Results)
+    {
+        Entries.Add(MakeShared<FJsonValueObject>(ToJson(Result)));
+    }
+    Report->SetArrayField(TEXT("results"), Entries);
+    const bool bPassed = CheckBaseline(Report);
+    WriteOutputs(Report);
+    return bPassed;
+}
+
+bool FEFBenchmark::GenerateLibrary(const FString& LibraryDir, int32 NumFiles) const
+{
+    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const FString Source = Settings->Defaults / TEXT("Roboto-Regular.ttf");
+    if (!PlatformFile.FileExists(*Source)) { return false; }
+    PlatformFile.DeleteDirectoryRecursively(*LibraryDir);
+    if (!PlatformFile.CreateDirectoryTree(*LibraryDir)) { return false; }
+    for (int32 Index = 0; Index < NumFiles; Index++)
+    {
+        if (!PlatformFile.CopyFile(*(LibraryDir / FString::Printf(TEXT("Synthetic_%05d.ttf"), Index)), *Source))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+FEFBenchmark::FResult& FEFBenchmark::AddResult(const FString& Path, int32 LibrarySize, int32 ItemsPerSample)
+{
+    FResult& Result = Results.AddDefaulted_GetRef();
+    Result.Path = Path;
+    Result.LibrarySize = LibrarySize;
+    Result.ItemsPerSample = ItemsPerSample;
+    return Result;
+}
+
+void FEFBenchmark::TimeScan(const FString& LibraryDir, int32 NumFiles)
+{
+    FResult& Result = AddResult(TEXT("Scan"), NumFiles, NumFiles);
+    for (int32 Iteration = 0; Iteration < Options.Iterations; Iteration++)
+    {
+        TArray<FString> Fonts;
+        // Time the walk itself, not the reuse of the previous result.
+        FEFFontScanner::Get().Invalidate();
+        const double Start = FPlatformTime::Seconds();
+        Settings->GetFontsFromFolder(Fonts, LibraryDir);
+        Result.SamplesMs.Add((FPlatformTime::Seconds() - Start) * 1000.0);
+    }
+}
+
+void FEFBenchmark::TimeInstall(const FString& LibraryDir, int32 NumFiles)
+{
+    FNameProperty* Slot = FindFProperty<FNameProperty>(UDevEditor::StaticClass(), GET_MEMBER_NAME_CHECKED(UDevEditor, RegularFont));
+    if (Slot == nullptr) { return; }
+    FResult& Result = AddResult(TEXT("InstallSlot"), NumFiles, 1);
+    for (int32 Iteration = 0; Iteration < Options.Iterations; Iteration++)
+    {
+        const FString Source = LibraryDir / FString::Printf(TEXT("Synthetic_%05d.ttf"), Iteration % NumFiles);
+        const double Start = FPlatformTime::Seconds();
+        Settings->InstallFontFile(Slot, Source);
+        Result.SamplesMs.Add((FPlatformTime::Seconds() - Start) * 1000.0);
+    }
+}
+
+void FEFBenchmark::TimeFlush(int32 NumFiles)
+{
+    if (!FSlateApplication::IsInitialized())
+    {
+        // Headless runs have no font cache to flush.
+        return;
+    }
+    FResult& Result = AddResult(TEXT("FlushFontCache"), NumFiles, 1);
+    for (int32 Iteration = 0; Iteration < Options.Iterations; Iteration++)
+    {
+        const double Start = FPlatformTime::Seconds();
+        Settings->FlushFontCache();
+        Result.SamplesMs.Add((FPlatformTime::Seconds() - Start) * 1000.0);
+    }
+}
+
+void FEFBenchmark::TimeReset(int32 NumFiles)
+{
+    FResult& Result = AddResult(TEXT("ResetToDefaults"), NumFiles, Settings->GetFontSlotProperties().Num());
+    for (int32 Iteration = 0; Iteration < Options.Iterations; Iteration++)
+    {
+        const double Start = FPlatformTime::Seconds();
+        Settings->ResetToDefaults();
+        FEFWorkQueue::Get().Flush();
+        Result.SamplesMs.Add((FPlatformTime::Seconds() - Start) * 1000.0);
+    }
+}
+
+void FEFBenchmark::TimeConversion(const FString& LibraryDir, int32 NumFiles)
+{
+    const int32 NumSamples = FMath::Min(Options.ConversionSamples, NumFiles);
+    if (NumSamples <= 0) { return; }
+    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const FString ConvertDir = LibraryDir / TEXT("Convert");
+    PlatformFile.CreateDirectoryTree(*ConvertDir);
+    for (int32 Index = 0; Index < NumSamples; Index++)
+    {
+        const FString Name = FString::Printf(TEXT("Synthetic_%05d.ttf"), Index);
+        PlatformFile.CopyFile(*(ConvertDir / Name), *(LibraryDir / Name));
+    }
+    // FontForge dominates this path, a single pass over the sample folder is enough.
+    FResult& Result = AddResult(TEXT("ConvertFolder"), NumFiles, NumSamples);
+    const double Start = FPlatformTime::Seconds();
+    const int32 ErrorCount = Settings->ConvertFontFolder(nullptr, ConvertDir);
+    FEFWorkQueue::Get().Flush();
+    Result.SamplesMs.Add((FPlatformTime::Seconds() - Start) * 1000.0);
+    if (ErrorCount != 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Conversion benchmark had %d errors, is FontForge available?"), ErrorCount);
+    }
+}
+
+TSharedRef<FJsonObject> FEFBenchmark::ToJson(const FResult& Result) const
+{
+    TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+    Entry->SetStringField(TEXT("path"), Result.Path);
+    Entry->SetNumberField(TEXT("librarySize"), Result.LibrarySize);
+    Entry->SetNumberField(TEXT("samples"), Result.SamplesMs.Num());
+    Entry->SetNumberField(TEXT("p50Ms"), Result.Percentile(0.50));
+    Entry->SetNumberField(TEXT("p95Ms"), Result.Percentile(0.95));
+    Entry->SetNumberField(TEXT("meanMs"), Result.Mean());
+    Entry->SetNumberField(TEXT("throughputPerSec"), Result.Throughput());
+    return Entry;
+}
+
+bool FEFBenchmark::CheckBaseline(TSharedRef<FJsonObject> Report) const
+{
+    if (Options.BaselineFile.IsEmpty()) { return true; }
+    FString BaselineJson;
+    TSharedPtr<FJsonObject> Baseline;
+    if (!FFileHelper::LoadFileToString(BaselineJson, *Options.BaselineFile)
+        || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline) || !Baseline.IsValid())
+    {
+        UE_LOG(LogTemp, Error, TEXT("Could not read benchmark baseline. %s"), *Options.BaselineFile);
+        return false;
+    }
+
+    TMap<FString, double> BaselineP95;
+    const TArray<TSharedPtr<FJsonValue>>* Entries = nullptr;
+    if (Baseline->TryGetArrayField(TEXT("results"), Entries))
+    {
+        for (const TSharedPtr<FJsonValue>& Value : *Entries)
+        {
+            const TSharedPtr<FJsonObject> Entry = Value->AsObject();
+            BaselineP95.Add(FString::Printf(TEXT("%s@%d"), *Entry->GetStringField(TEXT("path")), (int32)Entry->GetNumberField(TEXT("librarySize"))), Entry->GetNumberField(TEXT("p95Ms")));
+        }
+    }
+
+    TArray<TSharedPtr<FJsonValue>> Regressions;
+    for (const FResult& Result : Results)
+    {
+        const double* Previous = BaselineP95.Find(FString::Printf(TEXT("%s@%d"), *Result.Path, Result.LibrarySize));
+        const double Current = Result.Percentile(0.95);
+        if (Previous && *Previous > 0.0 && Current > *Previous * (1.0 + Options.Tolerance))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Regression in %s (%d files): p95 %.3f ms, baseline %.3f ms"), *Result.Path, Result.LibrarySize, Current, *Previous);
+            TSharedRef<FJsonObject> Entry = ToJson(Result);
+            Entry->SetNumberField(TEXT("baselineP95Ms"), *Previous);
+            Regressions.Add(MakeShared<FJsonValueObject>(Entry));
+        }
+    }
+    Report->SetArrayField(TEXT("regressions"), Regressions);
+    return Regressions.Num() == 0;
+}
+
+void FEFBenchmark::WriteOutputs(TSharedRef<FJsonObject> Report) const
+{
+    TArray<FString> Csv;
+    Csv.Add(TEXT("path,librarySize,samples,p50Ms,p95Ms,meanMs,throughputPerSec"));
+    for (const FResult& Result : Results)
+    {
+        Csv.Add(FString::Printf(TEXT("%s,%d,%d,%.4f,%.4f,%.4f,%.2f"), *Result.Path, Result.LibrarySize, Result.SamplesMs.Num(),
+            Result.Percentile(0.50), Result.Percentile(0.95), Result.Mean(), Result.Throughput()));
+    }
+    FFileHelper::SaveStringArrayToFile(Csv, *(Options.OutputDir / TEXT("results.csv")));
+
+    FString Json;
+    FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&Json));
+    FFileHelper::SaveStringToFile(Json, *(Options.OutputDir / TEXT("results.json")));
+    UE_LOG(LogTemp, Display, TEXT("Benchmark results written to %s"), *Options.OutputDir);
+}
@@ -0,0 +1,107 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFCompositeFont.h"
+
+#include "EFTrace.h"
+#include "Fonts/FontCache.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Rendering/SlateRenderer.h"
+#include "Styling/CoreStyle.h"
+
+
+FEFCompositeFontBackend& FEFCompositeFontBackend::Get()
+{
+    static FEFCompositeFontBackend Backend;
+    return Backend;
+}
+
+TArray<FFontData*> FEFCompositeFontBackend::FindEntries(const FProperty* Slot) const
+{
+    TArray<FFontData*> Entries;
+    if (!Slot->HasMetaData(TEXT("Typeface"))) { return Entries; }
+    const FName Typeface(*Slot->GetMetaData(TEXT("Typeface")));
+    const FString Culture = Slot->GetMetaData(TEXT("Culture"));
+
+    // Every FSlateFontInfo in the editor shares this one definition, so editing it in place re-targets them all.
+    FCompositeFont& DefaultFont = const_cast<FCompositeFont&>(FCoreStyle::GetDefaultFont().Get());
+    auto Collect = [&Entries, Typeface](FTypeface& Face, bool bAnyName)
+    {
+        for (FTypefaceEntry& Entry : Face.Fonts)
+        {
+            if (bAnyName || Entry.Name == Typeface) { Entries.Add(&Entry.Font); }
+        }
+    };
+    if (Culture.IsEmpty())
+    {
+        Collect(DefaultFont.DefaultTypeface, false);
+    }
+    else if (Culture == TEXT("*"))
+    {
+        Collect(DefaultFont.FallbackTypeface.Typeface, true);
+    }
+    else
+    {
+        for (FCompositeSubFont& SubFont : DefaultFont.SubTypefaces)
+        {
+            TArray<FString> Cultures;
+            SubFont.Cultures.ParseIntoArray(Cultures, TEXT(";"));
+            if (Cultures.Contains(Culture)) { Collect(SubFont.Typeface, false); }
+        }
+    }
+    return Entries;
+}
+
+bool FEFCompositeFontBackend::Bind(const FProperty* Slot, const FString& FontFile)
+{
+    EF_TRACE_SCOPE("EditorFont::BindTypeface");
+    TArray<FFontData*> Entries = FindEntries(Slot);
+    if (Entries.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("The default font has no %s typeface for %s"), *Slot->GetMetaData(TEXT("Typeface")), *Slot->GetName());
+        return false;
+    }
+    const FString FullPath = FPaths::ConvertRelativePathToFull(FontFile);
+    for (FFontData* Entry : Entries)
+    {
+        if (!Originals.Contains(Entry)) { Originals.Add(Entry, *Entry); }
+        if (Entry->GetFontFilename() == FullPath) { continue; }
+        // Lazy, Slate opens the face the first time it draws a character from it. A culture nobody uses is never loaded.
+        *Entry = FFontData(FullPath, Entry->GetHinting(), EFontLoadingPolicy::LazyLoad);
+        bDirty = true;
+    }
+    return true;
+}
+
+bool FEFCompositeFontBackend::Restore(const FProperty* Slot)
+{
+    TArray<FFontData*> Entries = FindEntries(Slot);
+    for (FFontData* Entry : Entries)
+    {
+        if (const FFontData* Original = Originals.Find(Entry))
+        {
+            if (!(*Entry == *Original))
+            {
+                *Entry = *Original;
+                bDirty = true;
+            }
+        }
+    }
+    return Entries.Num() > 0;
+}
+
+FString FEFCompositeFontBackend::GetBoundFile(const FProperty* Slot) const
+{
+    TArray<FFontData*> Entries = FindEntries(Slot);
+    return Entries.Num() > 0 ? Entries[0]->GetFontFilename() : FString();
+}
+
+void FEFCompositeFontBackend::Flush()
+{
+    if (!bDirty || !FSlateApplication::IsInitialized()) { return; }
+    EF_TRACE_SCOPE("EditorFont::FlushCompositeFont");
+    TRACE_COUNTER_INCREMENT(EditorFont_FlushCount);
+    FSlateApplication::Get().GetRenderer()->GetFontCache()->FlushCompositeFont(FCoreStyle::GetDefaultFont().Get());
+    // Cached text layouts still measure with the old faces.
+    FSlateApplication::Get().InvalidateAllWidgets(false);
+    bDirty = false;
+}
@@ -0,0 +1,107 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFConfigWriter.h"
+
+#include "EFTrace.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+
+
+FEFConfigWriter& FEFConfigWriter::Get()
+{
+    static FEFConfigWriter Writer;
+    return Writer;
+}
+
+void FEFConfigWriter::MarkDirty(UObject* Settings, const FString& Filename)
+{
+    check(IsInGameThread());
+    if (Settings == nullptr) { return; }
+    PendingObject = Settings;
+    PendingFilename = Filename;
+    LastDirtyTime = FPlatformTime::Seconds();
+    bDirty = true;
+    if (!TickerHandle.IsValid())
+    {
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FEFConfigWriter::Tick));
+    }
+}
+
+bool FEFConfigWriter::HasPendingWrite() const
+{
+    return bDirty;
+}
+
+bool FEFConfigWriter::Tick(float DeltaTime)
+{
+    if (!bDirty)
+    {
+        TickerHandle.Reset();
+        return false;
+    }
+    if (FPlatformTime::Seconds() - LastDirtyTime < CoalesceWindow)
+    {
+        return true;
+    }
+    Save();
+    TickerHandle.Reset();
+    return false;
+}
+
+void FEFConfigWriter::Flush()
+{
+    check(IsInGameThread());
+    Save();
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+}
+
+void FEFConfigWriter::Save()
+{
+    check(IsInGameThread());
+    if (!bDirty) { return; }
+    bDirty = false;
+    UObject* Object = PendingObject.Get();
+    if (Object == nullptr) { return; }
+    EF_TRACE_SCOPE("EditorFont::WriteConfig");
+    // SaveConfig keeps GConfig and the file in step, so nothing has to be reloaded after it.
+    Object->SaveConfig(CPF_Config, *PendingFilename);
+    RecordStamp(PendingFilename);
+}
+
+bool FEFConfigWriter::ShouldReload(const FString& Filename) const
+{
+    if (HasPendingWrite())
+    {
+        // Memory is ahead of the file, reading it back would undo the pending change.
+        return false;
+    }
+    const FFileStatData Stat = IFileManager::Get().GetStatData(*Filename);
+    if (!Stat.bIsValid)
+    {
+        return true;
+    }
+    const TPair<FDateTime, int64>* Stamp = FileStamps.Find(Filename);
+    return Stamp == nullptr || Stamp->Key != Stat.ModificationTime || Stamp->Value != Stat.FileSize;
+}
+
+void FEFConfigWriter::NotifyLoaded(const FString& Filename)
+{
+    RecordStamp(Filename);
+}
+
+void FEFConfigWriter::RecordStamp(const FString& Filename)
+{
+    const FFileStatData Stat = IFileManager::Get().GetStatData(*Filename);
+    if (Stat.bIsValid)
+    {
+        FileStamps.Add(Filename, TPair<FDateTime, int64>(Stat.ModificationTime, Stat.FileSize));
+    }
+    else
+    {
+        FileStamps.Remove(Filename);
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFContentCache.h"
+
+#include "EFCoreBridge.h"
+#include "EFCoreHash.h"
+#include "HAL/FileManager.h"
+#include "Misc/Guid.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+
+FEFContentCache& FEFContentCache::Get()
+{
+    static FEFContentCache Cache;
+    return Cache;
+}
+
+FString FEFContentCache::GetRoot() const
+{
+    FScopeLock Lock(&Mutex);
+    if (!SharedRoot.IsEmpty()) { return SharedRoot / TEXT("Cache"); }
+    return FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("EditorFont/Cache"));
+}
+
+void FEFContentCache::SetSharedRoot(const FString& Directory)
+{
+    FScopeLock Lock(&Mutex);
+    SharedRoot = Directory.IsEmpty() ? FString() : FPaths::ConvertRelativePathToFull(Directory);
+    FPaths::NormalizeDirectoryName(SharedRoot);
+}
+
+FString FEFContentCache::GetSharedRoot() const
+{
+    FScopeLock Lock(&Mutex);
+    return SharedRoot;
+}
+
+FString FEFContentCache::GetDefaultSharedRoot()
+{
+    return FPaths::ConvertRelativePathToFull(FString(FPlatformProcess::UserSettingsDir()) / TEXT("EditorFont"));
+}
+
+FString FEFContentCache::GetEntryPath(const FString& Bucket, const FString& Key, const FString& Extension) const
+{
+    // Two-character fan-out keeps directories small on big libraries.
+    return GetRoot() / Bucket / Key.Left(2) / (Key + Extension);
+}
+
+FString FEFContentCache::Find(const FString& Bucket, const FString& Key, const FString& Extension) const
+{
+    FString Path = GetEntryPath(Bucket, Key, Extension);
+    return IFileManager::Get().FileExists(*Path) ? Path : FString();
+}
+
+FString FEFContentCache::MakeStagingPath(const FString& Extension) const
+{
+    const FString StagingDir = GetRoot() / TEXT("Staging");
+    IFileManager::Get().MakeDirectory(*StagingDir, true);
+    return StagingDir / (FGuid::NewGuid().ToString() + Extension);
+}
+
+bool FEFContentCache::Publish(const FString& Bucket, const FString& Key, const FString& Extension, const FString& FinishedFile) const
+{
+    const FString Path = GetEntryPath(Bucket, Key, Extension);
+    if (IFileManager::Get().FileExists(*Path))
+    {
+        // Someone else produced the same content first, theirs is as good as ours.
+        IFileManager::Get().Delete(*FinishedFile);
+        return true;
+    }
+    IFileManager::Get().MakeDirectory(*FPaths::GetPath(Path), true);
+    if (!IFileManager::Get().Move(*Path, *FinishedFile, false, true))
+    {
+        IFileManager::Get().Delete(*FinishedFile);
+        return IFileManager::Get().FileExists(*Path);
+    }
+    return true;
+}
+
+FString FEFContentCache::HashFile(const FString& Filename)
+{
+    // FMD5Hash printed upper case, kept so pack manifests and snapshots written before still compare equal.
+    return FEFCoreBridge::FromUtf8(EFCore::HashFile(FEFCoreBridge::ToPath(Filename))).ToUpper();
+}
+
+FString FEFContentCache::HashString(const FString& Value)
+{
+    // Same bytes FMD5::HashAnsiString hashed, so existing cache keys stay valid.
+    const auto Ansi = StringCast<ANSICHAR>(*Value);
+    return FEFCoreBridge::FromUtf8(EFCore::HashBytes(Ansi.Get(), Ansi.Length()));
+}
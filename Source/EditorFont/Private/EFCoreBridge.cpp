@@ -0,0 +1,39 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFCoreBridge.h"
+
+#include "Misc/Paths.h"
+
+
+std::filesystem::path FEFCoreBridge::ToPath(const FString& Path)
+{
+    const FString Full = FPaths::ConvertRelativePathToFull(Path);
+#if PLATFORM_WINDOWS
+    return std::filesystem::path(*Full);
+#else
+    return std::filesystem::path(ToUtf8(Full));
+#endif
+}
+
+FString FEFCoreBridge::FromPath(const std::filesystem::path& Path)
+{
+#if PLATFORM_WINDOWS
+    FString Result(Path.native().c_str());
+    FPaths::NormalizeFilename(Result);
+    return Result;
+#else
+    return FromUtf8(Path.native());
+#endif
+}
+
+std::string FEFCoreBridge::ToUtf8(const FString& Value)
+{
+    const FTCHARToUTF8 Converted(*Value);
+    return std::string(Converted.Get(), Converted.Length());
+}
+
+FString FEFCoreBridge::FromUtf8(const std::string& Value)
+{
+    const FUTF8ToTCHAR Converted(Value.data(), int32(Value.size()));
+    return FString(Converted.Length(), Converted.Get());
+}
@@ -0,0 +1,141 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFCoverage.h"
+
+#include "EFSfnt.h"
+#include "Algo/BinarySearch.h"
+#include "Math/VectorRegister.h"
+
+
+FEFCoverage FEFCoverage::FromFont(const FEFSfntReader& Reader)
+{
+    FEFCoverage Coverage;
+    Reader.ForEachMappedRange([&Coverage](uint32 First, uint32 Last) { Coverage.AddRange(First, Last); });
+    return Coverage;
+}
+
+const FEFCoverage& FEFCoverage::GetScriptRequirement(EScript Script)
+{
+    auto Make = [](std::initializer_list<TPair<uint32, uint32>> Ranges)
+    {
+        FEFCoverage Coverage;
+        Coverage.AddRange(0x0020, 0x007E);
+        for (const TPair<uint32, uint32>& Range : Ranges)
+        {
+            Coverage.AddRange(Range.Key, Range.Value);
+        }
+        return Coverage;
+    };
+    static const FEFCoverage Arabic = Make({ { 0x0621, 0x063A }, { 0x0641, 0x064A }, { 0x0660, 0x0669 } });
+    static const FEFCoverage Thai = Make({ { 0x0E01, 0x0E3A }, { 0x0E3F, 0x0E5B } });
+    static const FEFCoverage Japanese = Make({ { 0x3001, 0x3003 }, { 0x3041, 0x3096 }, { 0x30A1, 0x30FA } });
+    static const FEFCoverage Korean = Make({ { 0x3131, 0x318E }, { 0xAC00, 0xD7A3 } });
+    switch (Script)
+    {
+    case EScript::Arabic: return Arabic;
+    case EScript::Thai: return Thai;
+    case EScript::Japanese: return Japanese;
+    default: return Korean;
+    }
+}
+
+FEFCoverage::FBlock& FEFCoverage::FindOrAddBlock(uint16 BlockIndex)
+{
+    const int32 Position = Algo::LowerBound(BlockIndices, BlockIndex);
+    if (Position == BlockIndices.Num() || BlockIndices[Position] != BlockIndex)
+    {
+        BlockIndices.Insert(BlockIndex, Position);
+        Blocks.Insert(FBlock(), Position);
+    }
+    return Blocks[Position];
+}
+
+void FEFCoverage::AddRange(uint32 First, uint32 Last)
+{
+    Last = FMath::Min<uint32>(Last, 0x10FFFF);
+    for (uint32 CodePoint = First; CodePoint <= Last; )
+    {
+        FBlock& Block = FindOrAddBlock(uint16(CodePoint >> 8));
+        const uint32 BlockEnd = FMath::Min<uint32>(Last, (CodePoint | 0xFF));
+        for (; CodePoint <= BlockEnd; CodePoint++)
+        {
+            const uint32 Bit = CodePoint & 0xFF;
+            Block.Words[Bit >> 5] |= 1u << (Bit & 31);
+        }
+    }
+}
+
+bool FEFCoverage::Contains(uint32 CodePoint) const
+{
+    const int32 Position = Algo::BinarySearch(BlockIndices, uint16(CodePoint >> 8));
+    if (Position == INDEX_NONE || CodePoint > 0x10FFFF) { return false; }
+    const uint32 Bit = CodePoint & 0xFF;
+    return (Blocks[Position].Words[Bit >> 5] & (1u << (Bit & 31))) != 0;
+}
+
+bool FEFCoverage::ContainsAll(const FEFCoverage& Required) const
+{
+    // Both block lists are sorted, so one merge walk finds every pair.
+    int32 Mine = 0;
+    for (int32 Index = 0; Index < Required.BlockIndices.Num(); Index++)
+    {
+        const uint16 Wanted = Required.BlockIndices[Index];
+        while (Mine < BlockIndices.Num() && BlockIndices[Mine] < Wanted) { Mine++; }
+        if (Mine == BlockIndices.Num() || BlockIndices[Mine] != Wanted) { return false; }
+
+        const FBlock& Have = Blocks[Mine];
+        const FBlock& Need = Required.Blocks[Index];
+        for (int32 Half = 0; Half < 8; Half += 4)
+        {
+            const VectorRegister4Int HaveBits = VectorIntLoad(&Have.Words[Half]);
+            const VectorRegister4Int NeedBits = VectorIntLoad(&Need.Words[Half]);
+            const VectorRegister4Int Equal = VectorIntCompareEQ(VectorIntAnd(HaveBits, NeedBits), NeedBits);
+            if (VectorMaskBits(VectorCastIntToFloat(Equal)) != 0xF) { return false; }
+        }
+    }
+    return true;
+}
+
+int32 FEFCoverage::NumCodePoints() const
+{
+    int32 Count = 0;
+    for (const FBlock& Block : Blocks)
+    {
+        for (uint32 Word : Block.Words)
+        {
+            Count += FMath::CountBits(Word);
+        }
+    }
+    return Count;
+}
+
+FArchive& operator<<(FArchive& Ar, FEFCoverage& Coverage)
+{
+    Ar << Coverage.BlockIndices;
+    int32 NumBlocks = Coverage.Blocks.Num();
+    Ar << NumBlocks;
+    if (Ar.IsLoading())
+    {
+        // Lookups binary search BlockIndices, a corrupt cache must not get that far.
+        bool bValid = NumBlocks == Coverage.BlockIndices.Num();
+        for (int32 Index = 1; bValid && Index < Coverage.BlockIndices.Num(); Index++)
+        {
+            bValid = Coverage.BlockIndices[Index - 1] < Coverage.BlockIndices[Index];
+        }
+        if (!bValid)
+        {
+            Ar.SetError();
+            Coverage = FEFCoverage();
+            return Ar;
+        }
+        Coverage.Blocks.SetNum(NumBlocks);
+    }
+    for (FEFCoverage::FBlock& Block : Coverage.Blocks)
+    {
+        for (uint32& Word : Block.Words)
+        {
+            Ar << Word;
+        }
+    }
+    return Ar;
+}
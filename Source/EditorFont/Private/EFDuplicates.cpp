@@ -0,0 +1,112 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFDuplicates.h"
+
+#include "EFTrace.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+
+const TCHAR* FEFDuplicateGroup::LexKind(EKind Kind)
+{
+    switch (Kind)
+    {
+    case EKind::Identical: return TEXT("Identical");
+    case EKind::SameOutlines: return TEXT("SameOutlines");
+    }
+    return TEXT("Unknown");
+}
+
+TArray<FEFDuplicateGroup> FEFDuplicateFinder::FindGroups(const TArray<FEFFontIndexEntry>& Entries, const TSet<FString>& Preferred)
+{
+    EF_TRACE_SCOPE("EditorFont::FindDuplicates");
+    TArray<const FEFFontIndexEntry*> Remaining;
+    for (const FEFFontIndexEntry& Entry : Entries)
+    {
+        if (!Entry.ContentHash.IsEmpty()) { Remaining.Add(&Entry); }
+    }
+
+    TArray<FEFDuplicateGroup> Groups;
+    auto RunTier = [&Remaining, &Groups, &Preferred](FEFDuplicateGroup::EKind Kind, TFunctionRef<FString(const FEFFontIndexEntry&)> MakeKey)
+    {
+        TMap<FString, TArray<const FEFFontIndexEntry*>> Buckets;
+        for (const FEFFontIndexEntry* Entry : Remaining)
+        {
+            const FString Key = MakeKey(*Entry);
+            if (!Key.IsEmpty()) { Buckets.FindOrAdd(Key).Add(Entry); }
+        }
+        // Keepers and preferred paths go on to the next tier, duplicates are settled.
+        TArray<const FEFFontIndexEntry*> Next;
+        for (TPair<FString, TArray<const FEFFontIndexEntry*>>& Bucket : Buckets)
+        {
+            TArray<const FEFFontIndexEntry*>& Members = Bucket.Value;
+            if (Members.Num() > 1)
+            {
+                Members.Sort([&Preferred](const FEFFontIndexEntry& A, const FEFFontIndexEntry& B)
+                    {
+                        const bool bPreferA = Preferred.Contains(A.Path);
+                        if (bPreferA != Preferred.Contains(B.Path)) { return bPreferA; }
+                        if (A.Timestamp != B.Timestamp) { return A.Timestamp < B.Timestamp; }
+                        return A.Path.Len() < B.Path.Len();
+                    });
+            }
+            FEFDuplicateGroup Group;
+            Group.Kind = Kind;
+            Group.Keep = Members[0]->Path;
+            Next.Add(Members[0]);
+            for (int32 Index = 1; Index < Members.Num(); Index++)
+            {
+                if (Preferred.Contains(Members[Index]->Path))
+                {
+                    Next.Add(Members[Index]);
+                    continue;
+                }
+                Group.Duplicates.Add(Members[Index]->Path);
+                Group.DuplicateBytes += Members[Index]->Size;
+            }
+            if (Group.Duplicates.Num() > 0) { Groups.Add(MoveTemp(Group)); }
+        }
+        for (const FEFFontIndexEntry* Entry : Remaining)
+        {
+            if (MakeKey(*Entry).IsEmpty()) { Next.Add(Entry); }
+        }
+        Remaining = MoveTemp(Next);
+    };
+
+    // Keyed by extension too, the slot lists are per format and each format keeps its own copy.
+    auto WithExtension = [](const FEFFontIndexEntry& Entry, const FString& Hash)
+        {
+            return Hash.IsEmpty() ? FString() : FPaths::GetExtension(Entry.Path).ToLower() + TEXT("|") + Hash;
+        };
+    RunTier(FEFDuplicateGroup::EKind::Identical, [&WithExtension](const FEFFontIndexEntry& Entry) { return WithExtension(Entry, Entry.ContentHash); });
+    RunTier(FEFDuplicateGroup::EKind::SameOutlines, [&WithExtension](const FEFFontIndexEntry& Entry) { return WithExtension(Entry, Entry.OutlineHash); });
+
+    Groups.Sort([](const FEFDuplicateGroup& A, const FEFDuplicateGroup& B) { return A.Keep < B.Keep; });
+    return Groups;
+}
+
+int32 FEFDuplicateFinder::RemoveDuplicates(const TArray<FEFDuplicateGroup>& Groups, const TArray<FString>& Roots, int64& OutBytes)
+{
+    EF_TRACE_SCOPE("EditorFont::RemoveDuplicates");
+    OutBytes = 0;
+    int32 Removed = 0;
+    for (const FEFDuplicateGroup& Group : Groups)
+    {
+        for (const FString& Duplicate : Group.Duplicates)
+        {
+            if (!Roots.ContainsByPredicate([&Duplicate](const FString& Root) { return FPaths::IsUnderDirectory(Duplicate, Root); })) { continue; }
+            const int64 Size = IFileManager::Get().FileSize(*Duplicate);
+            if (IFileManager::Get().Delete(*Duplicate, false, false, true))
+            {
+                UE_LOG(LogTemp, Log, TEXT("Removed %s, same font as %s (%s)"), *Duplicate, *Group.Keep, FEFDuplicateGroup::LexKind(Group.Kind));
+                OutBytes += FMath::Max<int64>(Size, 0);
+                Removed++;
+            }
+            else
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Failed to remove duplicate font %s"), *Duplicate);
+            }
+        }
+    }
+    return Removed;
+}
@@ -0,0 +1,73 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFFamilyMapper.h"
+
+
+FEFSfntReader::FStyle FEFFamilyMapper::GetSlotStyle(const FProperty* Slot)
+{
+    FEFSfntReader::FStyle Style;
+    Style.bFixedPitch = Slot->GetBoolMetaData(TEXT("Monospace"));
+    TArray<FString> Entries;
+    Slot->GetMetaData(TEXT("Axes")).ParseIntoArray(Entries, TEXT(","));
+    for (const FString& Entry : Entries)
+    {
+        FString Tag;
+        FString Value;
+        if (!Entry.TrimStartAndEnd().Split(TEXT("="), &Tag, &Value)) { continue; }
+        const float Number = FCString::Atof(*Value);
+        if (Tag == TEXT("wght"))
+        {
+            Style.WeightClass = uint16(FMath::Clamp(Number, 1.0f, 1000.0f));
+        }
+        else if (Tag == TEXT("wdth"))
+        {
+            // OS/2 width classes 1-9 are 50, 62.5, 75, 87.5, 100, 112.5, 125, 150 and 200 percent.
+            static const float Percents[] = { 50.0f, 62.5f, 75.0f, 87.5f, 100.0f, 112.5f, 125.0f, 150.0f, 200.0f };
+            int32 Closest = 0;
+            for (int32 Index = 1; Index < UE_ARRAY_COUNT(Percents); Index++)
+            {
+                if (FMath::Abs(Percents[Index] - Number) < FMath::Abs(Percents[Closest] - Number)) { Closest = Index; }
+            }
+            Style.WidthClass = uint16(Closest + 1);
+        }
+        else if (Tag == TEXT("ital"))
+        {
+            Style.bItalic = Number != 0.0f;
+        }
+    }
+    return Style;
+}
+
+int32 FEFFamilyMapper::GetDistance(const FEFSfntReader::FStyle& Wanted, const FEFSfntReader::FStyle& Candidate)
+{
+    return FMath::Abs(int32(Wanted.WeightClass) - int32(Candidate.WeightClass))
+        + 1000 * FMath::Abs(int32(Wanted.WidthClass) - int32(Candidate.WidthClass))
+        + (Wanted.bItalic != Candidate.bItalic ? 100000 : 0);
+}
+
+TMap<FNameProperty*, FString> FEFFamilyMapper::MapFamily(const TArray<FEFFontIndexEntry>& Members, const TArray<FNameProperty*>& Slots)
+{
+    TMap<FNameProperty*, FString> Mapping;
+    for (FNameProperty* Slot : Slots)
+    {
+        if (!Slot->HasMetaData(TEXT("Axes"))) { continue; }
+        const FEFSfntReader::FStyle Wanted = GetSlotStyle(Slot);
+        const FEFFontIndexEntry* Best = nullptr;
+        int32 BestDistance = MAX_int32;
+        for (const FEFFontIndexEntry& Member : Members)
+        {
+            if (Wanted.bFixedPitch && !Member.Style.bFixedPitch) { continue; }
+            const int32 Distance = GetDistance(Wanted, Member.Style);
+            if (Distance < BestDistance)
+            {
+                Best = &Member;
+                BestDistance = Distance;
+            }
+        }
+        if (Best)
+        {
+            Mapping.Add(Slot, Best->Path);
+        }
+    }
+    return Mapping;
+}
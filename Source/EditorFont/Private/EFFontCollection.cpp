@@ -0,0 +1,247 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFFontCollection.h"
+
+#include "EFContentCache.h"
+#include "EFSfnt.h"
+#include "EFTrace.h"
+#include "Async/MappedFileHandle.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+
+namespace
+{
+    constexpr uint32 TagTtcf = FEFSfntReader::MakeTag('t', 't', 'c', 'f');
+    constexpr uint32 TagHead = FEFSfntReader::MakeTag('h', 'e', 'a', 'd');
+    constexpr uint32 TagOtto = FEFSfntReader::MakeTag('O', 'T', 'T', 'O');
+    constexpr uint32 ChecksumMagic = 0xB1B0AFBA;
+
+    struct FHashedFile
+    {
+        int64 Size = 0;
+        FDateTime Timestamp;
+        FString Hash;
+    };
+    FCriticalSection HashMutex;
+    TMap<FString, FHashedFile> Hashes;
+
+    /** Face count from the first bytes of the file, 0 if it is not a collection. */
+    int32 ReadFaceCount(const FString& Collection)
+    {
+        TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*Collection, FILEREAD_Silent));
+        if (!Reader || Reader->TotalSize() < 12) { return 0; }
+        uint8 Header[12];
+        Reader->Serialize(Header, sizeof(Header));
+        if (Reader->IsError() || FEFSfntReader::ReadU32(Header) != TagTtcf) { return 0; }
+        const uint32 NumFonts = FEFSfntReader::ReadU32(Header + 8);
+        return 12 + uint64(NumFonts) * 4 <= uint64(Reader->TotalSize()) ? int32(NumFonts) : 0;
+    }
+}
+
+bool FEFFontCollection::IsCollectionFile(const FString& Path)
+{
+    const FString Extension = FPaths::GetExtension(Path, true);
+    return Extension == TEXT(".ttc") || Extension == TEXT(".otc");
+}
+
+FString FEFFontCollection::MakeFacePath(const FString& Collection, int32 FaceIndex)
+{
+    return FString::Printf(TEXT("%s#%d"), *Collection, FaceIndex);
+}
+
+bool FEFFontCollection::SplitFacePath(const FString& Path, FString& OutFile, int32& OutFaceIndex)
+{
+    OutFile = Path;
+    OutFaceIndex = 0;
+    int32 Hash = INDEX_NONE;
+    if (!Path.FindLastChar(TEXT('#'), Hash)) { return false; }
+    const FString Index = Path.Mid(Hash + 1);
+    const FString File = Path.Left(Hash);
+    if (Index.IsEmpty() || !Index.IsNumeric() || !IsCollectionFile(File)) { return false; }
+    OutFile = File;
+    OutFaceIndex = FCString::Atoi(*Index);
+    return true;
+}
+
+FString FEFFontCollection::GetFilePart(const FString& Path)
+{
+    FString File;
+    int32 FaceIndex = 0;
+    SplitFacePath(Path, File, FaceIndex);
+    return File;
+}
+
+TArray<FString> FEFFontCollection::ExpandFaces(const TArray<FString>& Paths)
+{
+    TArray<int32> Collections;
+    for (int32 Index = 0; Index < Paths.Num(); Index++)
+    {
+        if (IsCollectionFile(Paths[Index])) { Collections.Add(Index); }
+    }
+    if (Collections.Num() == 0) { return Paths; }
+
+    EF_TRACE_SCOPE("EditorFont::ExpandCollections");
+    TArray<int32> FaceCounts;
+    FaceCounts.SetNumZeroed(Collections.Num());
+    ParallelFor(Collections.Num(), [&](int32 Index)
+        {
+            FaceCounts[Index] = ReadFaceCount(Paths[Collections[Index]]);
+        });
+
+    TArray<FString> Expanded;
+    Expanded.Reserve(Paths.Num());
+    int32 NextCollection = 0;
+    for (int32 Index = 0; Index < Paths.Num(); Index++)
+    {
+        if (NextCollection < Collections.Num() && Collections[NextCollection] == Index)
+        {
+            for (int32 Face = 0; Face < FaceCounts[NextCollection]; Face++)
+            {
+                Expanded.Add(MakeFacePath(Paths[Index], Face));
+            }
+            NextCollection++;
+            continue;
+        }
+        Expanded.Add(Paths[Index]);
+    }
+    return Expanded;
+}
+
+FString FEFFontCollection::GetCollectionHash(const FString& Collection)
+{
+    const FFileStatData Stat = IFileManager::Get().GetStatData(*Collection);
+    if (!Stat.bIsValid) { return FString(); }
+    {
+        FScopeLock Lock(&HashMutex);
+        const FHashedFile* Known = Hashes.Find(Collection);
+        if (Known && Known->Size == Stat.FileSize && Known->Timestamp == Stat.ModificationTime) { return Known->Hash; }
+    }
+    FHashedFile Hashed;
+    Hashed.Size = Stat.FileSize;
+    Hashed.Timestamp = Stat.ModificationTime;
+    Hashed.Hash = FEFContentCache::HashFile(Collection);
+    FScopeLock Lock(&HashMutex);
+    Hashes.Add(Collection, Hashed);
+    return Hashed.Hash;
+}
+
+bool FEFFontCollection::WriteFace(TConstArrayView<uint8> Collection, int32 FaceIndex, FArchive& Out)
+{
+    FEFSfntReader Reader;
+    if (!Reader.Open(Collection, FaceIndex)) { return false; }
+    TArray<FEFSfntReader::FTable> Tables = Reader.GetTables();
+    Tables.Sort([](const FEFSfntReader::FTable& A, const FEFSfntReader::FTable& B) { return A.Tag < B.Tag; });
+    const int32 NumTables = Tables.Num();
+
+    // Records that point at the same bytes in the collection keep sharing them in the face.
+    TMap<uint32, uint32> Placed;
+    TArray<const FEFSfntReader::FTable*> Unique;
+    TArray<uint8> Directory;
+    Directory.SetNumZeroed(12 + NumTables * 16);
+    uint32 Offset = Directory.Num();
+    for (int32 Index = 0; Index < NumTables; Index++)
+    {
+        const FEFSfntReader::FTable& Table = Tables[Index];
+        uint32* Existing = Placed.Find(Table.Offset);
+        if (Existing == nullptr)
+        {
+            Existing = &Placed.Add(Table.Offset, Offset);
+            Unique.Add(&Table);
+            Offset += Align(Table.Length, 4);
+        }
+        uint8* Record = Directory.GetData() + 12 + Index * 16;
+        FEFSfntWriter::WriteU32(Record, Table.Tag);
+        FEFSfntWriter::WriteU32(Record + 4, Table.Checksum);
+        FEFSfntWriter::WriteU32(Record + 8, *Existing);
+        FEFSfntWriter::WriteU32(Record + 12, Table.Length);
+    }
+    const uint16 EntrySelector = uint16(FMath::FloorLog2(uint32(FMath::Max(NumTables, 1))));
+    const uint16 SearchRange = uint16(16 << EntrySelector);
+    FEFSfntWriter::WriteU32(Directory.GetData(), Reader.GetSfntVersion());
+    FEFSfntWriter::WriteU16(Directory.GetData() + 4, uint16(NumTables));
+    FEFSfntWriter::WriteU16(Directory.GetData() + 6, SearchRange);
+    FEFSfntWriter::WriteU16(Directory.GetData() + 8, EntrySelector);
+    FEFSfntWriter::WriteU16(Directory.GetData() + 10, uint16(NumTables * 16 - SearchRange));
+
+    // The table checksums carry over, so the file checksum needs only the new directory.
+    uint32 FileChecksum = FEFSfntWriter::CalcChecksum(Directory);
+    for (const FEFSfntReader::FTable* Table : Unique)
+    {
+        FileChecksum += Table->Checksum;
+    }
+
+    Out.Serialize(Directory.GetData(), Directory.Num());
+    static const uint8 Padding[4] = { 0, 0, 0, 0 };
+    for (const FEFSfntReader::FTable* Table : Unique)
+    {
+        const uint8* Source = Collection.GetData() + Table->Offset;
+        if (Table->Tag == TagHead && Table->Length >= 12)
+        {
+            TArray<uint8> Head(Source, Table->Length);
+            FEFSfntWriter::WriteU32(Head.GetData() + 8, ChecksumMagic - FileChecksum);
+            Out.Serialize(Head.GetData(), Head.Num());
+        }
+        else
+        {
+            Out.Serialize(const_cast<uint8*>(Source), Table->Length);
+        }
+        Out.Serialize(const_cast<uint8*>(Padding), Align(Table->Length, 4) - Table->Length);
+    }
+    return !Out.IsError();
+}
+
+FString FEFFontCollection::ResolveFace(const FString& Path)
+{
+    FString File;
+    int32 FaceIndex = 0;
+    if (!SplitFacePath(Path, File, FaceIndex)) { return Path; }
+    EF_TRACE_SCOPE("EditorFont::ResolveFace");
+    const FString CollectionHash = GetCollectionHash(File);
+    if (CollectionHash.IsEmpty()) { return FString(); }
+    FEFContentCache& Cache = FEFContentCache::Get();
+    const FString Key = FString::Printf(TEXT("%s_%d"), *CollectionHash, FaceIndex);
+    for (const TCHAR* Extension : { TEXT(".ttf"), TEXT(".otf") })
+    {
+        const FString Cached = Cache.Find(TEXT("Faces"), Key, Extension);
+        if (!Cached.IsEmpty()) { return Cached; }
+    }
+
+    // Mapping avoids reading the whole collection for one face. Some platforms cannot map, they load it.
+    TUniquePtr<IMappedFileHandle> Handle(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*File));
+    TUniquePtr<IMappedFileRegion> Region(Handle ? Handle->MapRegion() : nullptr);
+    TArray<uint8> Loaded;
+    TConstArrayView<uint8> Data;
+    if (Region)
+    {
+        Data = MakeArrayView(Region->GetMappedPtr(), int32(Region->GetMappedSize()));
+    }
+    else if (FFileHelper::LoadFileToArray(Loaded, *File, FILEREAD_Silent))
+    {
+        Data = Loaded;
+    }
+    FEFSfntReader Reader;
+    if (!Reader.Open(Data, FaceIndex))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No face %d in %s"), FaceIndex, *File);
+        return FString();
+    }
+    const FString Extension = Reader.GetSfntVersion() == TagOtto ? TEXT(".otf") : TEXT(".ttf");
+    const FString Staging = Cache.MakeStagingPath(Extension);
+    bool bWritten = false;
+    {
+        TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*Staging));
+        bWritten = Writer && WriteFace(Data, FaceIndex, *Writer);
+    }
+    if (!bWritten || !Cache.Publish(TEXT("Faces"), Key, Extension, Staging))
+    {
+        IFileManager::Get().Delete(*Staging);
+        UE_LOG(LogTemp, Warning, TEXT("Failed to extract face %d of %s"), FaceIndex, *File);
+        return FString();
+    }
+    return Cache.GetEntryPath(TEXT("Faces"), Key, Extension);
+}
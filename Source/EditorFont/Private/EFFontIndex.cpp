@@ -0,0 +1,238 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFFontIndex.h"
+
+#include "EFContentCache.h"
+#include "EFFontCollection.h"
+#include "EFFontPack.h"
+#include "EFSfnt.h"
+#include "EFTrace.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/SecureHash.h"
+#include "Misc/ScopeLock.h"
+
+
+namespace
+{
+    constexpr uint32 IndexMagic = 0x45464958; // "EFIX"
+    constexpr int32 IndexVersion = 4;
+}
+
+FArchive& operator<<(FArchive& Ar, FEFFontIndexEntry& Entry)
+{
+    Ar << Entry.Path;
+    Ar << Entry.Size;
+    Ar << Entry.Timestamp;
+    Ar << Entry.GlyphCount;
+    Ar << Entry.bVariable;
+    Ar << Entry.FamilyName;
+    Ar << Entry.Style.WeightClass << Entry.Style.WidthClass << Entry.Style.bItalic << Entry.Style.bFixedPitch;
+    Ar << Entry.Coverage;
+    Ar << Entry.ContentHash << Entry.OutlineHash << Entry.CmapHash;
+    return Ar;
+}
+
+FEFFontIndex& FEFFontIndex::Get()
+{
+    static FEFFontIndex Index;
+    return Index;
+}
+
+FString FEFFontIndex::GetIndexFile() const
+{
+    return FEFContentCache::Get().GetRoot() / TEXT("FontIndex.bin");
+}
+
+bool FEFFontIndex::ReadIndexFile(const FString& IndexFile, TArray<FEFFontIndexEntry>& OutEntries)
+{
+    TUniquePtr<FArchive> Reader(IFileManager::Get().CreateFileReader(*IndexFile, FILEREAD_Silent));
+    if (!Reader) { return false; }
+    uint32 Magic = 0;
+    int32 Version = 0;
+    *Reader << Magic << Version;
+    if (Magic != IndexMagic || Version != IndexVersion) { return false; }
+    *Reader << OutEntries;
+    return !Reader->IsError();
+}
+
+void FEFFontIndex::Load()
+{
+    bLoaded = true;
+    TArray<FEFFontIndexEntry> Loaded;
+    if (!ReadIndexFile(GetIndexFile(), Loaded)) { return; }
+    for (FEFFontIndexEntry& Entry : Loaded)
+    {
+        Entries.Add(Entry.Path, MoveTemp(Entry));
+    }
+}
+
+void FEFFontIndex::Unload()
+{
+    FScopeLock Lock(&Mutex);
+    Entries.Reset();
+    bLoaded = false;
+}
+
+void FEFFontIndex::Save()
+{
+    const FString IndexFile = GetIndexFile();
+    // A shared cache has other editors saving the same file. Whatever they saved since is merged in, our entries win.
+    // Two saves can still race between the read and the rename, the loser's new entries are just parsed again later.
+    TArray<FEFFontIndexEntry> OnDisk;
+    if (ReadIndexFile(IndexFile, OnDisk))
+    {
+        for (FEFFontIndexEntry& Entry : OnDisk)
+        {
+            if (!Entries.Contains(Entry.Path)) { Entries.Add(Entry.Path, MoveTemp(Entry)); }
+        }
+    }
+    TArray<FEFFontIndexEntry> ToSave;
+    Entries.GenerateValueArray(ToSave);
+    const FString TempFile = FEFContentCache::Get().MakeStagingPath(TEXT(".bin"));
+    {
+        TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*TempFile));
+        if (!Writer) { return; }
+        uint32 Magic = IndexMagic;
+        int32 Version = IndexVersion;
+        *Writer << Magic << Version;
+        *Writer << ToSave;
+    }
+    IFileManager::Get().Move(*IndexFile, *TempFile, true, true);
+}
+
+bool FEFFontIndex::ParseFont(const FString& Path, FEFFontIndexEntry& OutEntry)
+{
+    FString File;
+    int32 FaceIndex = 0;
+    FString PackFile, MemberName;
+    TSharedPtr<FEFFontPack> Pack;
+    TArray<uint8> Loaded;
+    TConstArrayView<uint8> Data;
+    if (FEFFontPack::SplitMemberPath(Path, PackFile, MemberName))
+    {
+        // Pack members are parsed in place, from the mapping.
+        Pack = FEFFontPack::Open(PackFile);
+        const FEFFontPack::FMember* Member = Pack ? Pack->FindMember(MemberName) : nullptr;
+        if (Member == nullptr) { return false; }
+        Data = Pack->GetMemberData(*Member);
+        File = PackFile;
+    }
+    else
+    {
+        FEFFontCollection::SplitFacePath(Path, File, FaceIndex);
+        if (!FFileHelper::LoadFileToArray(Loaded, *File, FILEREAD_Silent)) { return false; }
+        Data = Loaded;
+    }
+    FEFSfntReader Reader;
+    if (!Reader.Open(Data, FaceIndex)) { return false; }
+    OutEntry.GlyphCount = Reader.GetGlyphCount();
+    OutEntry.bVariable = Reader.FindTable(FEFSfntReader::MakeTag('f', 'v', 'a', 'r')) != nullptr;
+    OutEntry.FamilyName = Reader.GetFamilyName();
+    OutEntry.Style = Reader.GetStyle();
+    OutEntry.Coverage = FEFCoverage::FromFont(Reader);
+
+    // The file is already in memory, hashing it here spares the duplicate finder a second read.
+    if (File == Path)
+    {
+        OutEntry.ContentHash = FMD5::HashBytes(Data.GetData(), Data.Num());
+    }
+    FMD5 Outline;
+    for (const uint32 Tag : { FEFSfntReader::MakeTag('g', 'l', 'y', 'f'), FEFSfntReader::MakeTag('l', 'o', 'c', 'a'), FEFSfntReader::MakeTag('C', 'F', 'F', ' '), FEFSfntReader::MakeTag('C', 'F', 'F', '2'), FEFSfntReader::MakeTag('c', 'm', 'a', 'p') })
+    {
+        const TConstArrayView<uint8> Table = Reader.GetTableData(Tag);
+        if (Table.Num() == 0) { continue; }
+        Outline.Update(reinterpret_cast<const uint8*>(&Tag), sizeof(Tag));
+        Outline.Update(Table.GetData(), Table.Num());
+    }
+    FMD5Hash OutlineHash;
+    OutlineHash.Set(Outline);
+    OutEntry.OutlineHash = LexToString(OutlineHash);
+    const TConstArrayView<uint8> Cmap = Reader.GetTableData(FEFSfntReader::MakeTag('c', 'm', 'a', 'p'));
+    OutEntry.CmapHash = Cmap.Num() > 0 ? FMD5::HashBytes(Cmap.GetData(), Cmap.Num()) : FString();
+    return true;
+}
+
+void FEFFontIndex::Refresh(const TArray<FString>& Paths)
+{
+    EF_TRACE_SCOPE("EditorFont::RefreshFontIndex");
+    TArray<FEFFontIndexEntry> Stale;
+    {
+        FScopeLock Lock(&Mutex);
+        if (!bLoaded) { Load(); }
+        for (const FString& Path : Paths)
+        {
+            // Faces of a collection and members of a pack are stale together, when their file changes.
+            const FFileStatData Stat = IFileManager::Get().GetStatData(*FEFFontCollection::GetFilePart(FEFFontPack::GetPackFile(Path)));
+            if (!Stat.bIsValid) { continue; }
+            const FEFFontIndexEntry* Existing = Entries.Find(Path);
+            if (Existing && Existing->Size == Stat.FileSize && Existing->Timestamp == Stat.ModificationTime) { continue; }
+            FEFFontIndexEntry& Entry = Stale.AddDefaulted_GetRef();
+            Entry.Path = Path;
+            Entry.Size = Stat.FileSize;
+            Entry.Timestamp = Stat.ModificationTime;
+        }
+    }
+    if (Stale.Num() == 0) { return; }
+
+    TArray<bool> Parsed;
+    Parsed.SetNumZeroed(Stale.Num());
+    ParallelFor(Stale.Num(), [&Stale, &Parsed](int32 Index)
+        {
+            Parsed[Index] = ParseFont(Stale[Index].Path, Stale[Index]);
+        });
+
+    FScopeLock Lock(&Mutex);
+    for (int32 Index = 0; Index < Stale.Num(); Index++)
+    {
+        // Unreadable files still get an entry, with no coverage, so they are not re-parsed every time.
+        if (!Parsed[Index])
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Not a readable font: %s"), *Stale[Index].Path);
+        }
+        Entries.Add(Stale[Index].Path, MoveTemp(Stale[Index]));
+    }
+    Save();
+}
+
+bool FEFFontIndex::GetEntry(const FString& Path, FEFFontIndexEntry& OutEntry) const
+{
+    FScopeLock Lock(&Mutex);
+    const FEFFontIndexEntry* Entry = Entries.Find(Path);
+    if (Entry == nullptr || Entry->GlyphCount == 0) { return false; }
+    OutEntry = *Entry;
+    return true;
+}
+
+TArray<FEFFontIndexEntry> FEFFontIndex::GetEntries(const TArray<FString>& Paths) const
+{
+    TArray<FEFFontIndexEntry> Found;
+    FScopeLock Lock(&Mutex);
+    for (const FString& Path : Paths)
+    {
+        const FEFFontIndexEntry* Entry = Entries.Find(Path);
+        if (Entry && Entry->GlyphCount > 0)
+        {
+            Found.Add(*Entry);
+        }
+    }
+    return Found;
+}
+
+TArray<FString> FEFFontIndex::FilterByCoverage(const TArray<FString>& Paths, const FEFCoverage& Required)
+{
+    EF_TRACE_SCOPE("EditorFont::FilterByCoverage");
+    Refresh(Paths);
+    TArray<FString> Matching;
+    FScopeLock Lock(&Mutex);
+    for (const FString& Path : Paths)
+    {
+        const FEFFontIndexEntry* Entry = Entries.Find(Path);
+        if (Entry && Entry->Coverage.ContainsAll(Required))
+        {
+            Matching.Add(Path);
+        }
+    }
+    return Matching;
+}
@@ -0,0 +1,62 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFFontMerger.h"
+
+#include "EFContentCache.h"
+#include "EFTrace.h"
+#include "UDevEditor.h"
+#include "HAL/FileManager.h"
+#include "Misc/Paths.h"
+
+
+namespace
+{
+    // Bumped whenever merge_fonts.py changes its output, so older cache entries are not reused.
+    constexpr int32 MergerVersion = 1;
+}
+
+FEFFontMerger::FOptions FEFFontMerger::MakeOptions(const UDevEditor* Settings)
+{
+    FOptions Options;
+    Options.FontForgeExecutable = Settings->GetFontForgeExecutable();
+    Options.Script = Settings->GetFontForgeScript(TEXT("merge_fonts.py"));
+    return Options;
+}
+
+FString FEFFontMerger::MergeFonts(const FOptions& Options, const FString& LatinFont, const FString& CjkFont)
+{
+    EF_TRACE_SCOPE("EditorFont::MergeFonts");
+    const FString LatinHash = FEFContentCache::HashFile(LatinFont);
+    const FString CjkHash = FEFContentCache::HashFile(CjkFont);
+    if (LatinHash.IsEmpty() || CjkHash.IsEmpty()) { return FString(); }
+
+    // Slate loads either outline format, the merged face keeps the Latin font's.
+    const FString Extension = FPaths::GetExtension(LatinFont, true);
+    const FString Key = LatinHash + FEFContentCache::HashString(FString::Printf(TEXT("v%d|%s"), MergerVersion, *CjkHash));
+    FEFContentCache& Cache = FEFContentCache::Get();
+    const FString Cached = Cache.Find(TEXT("Merged"), Key, Extension);
+    if (!Cached.IsEmpty())
+    {
+        return Cached;
+    }
+
+    const FString Output = Cache.MakeStagingPath(Extension);
+    const FString Args = FString::Printf(TEXT("-lang=py -script \"%s\" \"%s\" \"%s\" \"%s\""), *Options.Script, *LatinFont, *CjkFont, *Output);
+    const int32 ReturnCode = UDevEditor::LaunchAndCaptureProcessOutput(Options.FontForgeExecutable, Args, true);
+    if (ReturnCode == 3)
+    {
+        UE_LOG(LogTemp, Error, TEXT("%s and %s together have more glyphs than one font can hold, subset the CJK font first"), *FPaths::GetCleanFilename(LatinFont), *FPaths::GetCleanFilename(CjkFont));
+    }
+    if (ReturnCode != 0 || !FPaths::FileExists(Output))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FontForge failed to merge %s with %s (exit code %d)"), *LatinFont, *CjkFont, ReturnCode);
+        IFileManager::Get().Delete(*Output);
+        return FString();
+    }
+    UE_LOG(LogTemp, Log, TEXT("Merged %s with %s: %lld bytes"), *FPaths::GetCleanFilename(LatinFont), *FPaths::GetCleanFilename(CjkFont), IFileManager::Get().FileSize(*Output));
+    if (!Cache.Publish(TEXT("Merged"), Key, Extension, Output))
+    {
+        return FString();
+    }
+    return Cache.GetEntryPath(TEXT("Merged"), Key, Extension);
+}
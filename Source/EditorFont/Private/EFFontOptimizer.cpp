@@ -0,0 +1,284 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFFontOptimizer.h"
+
+#include "EFContentCache.h"
+#include "EFSfnt.h"
+#include "EFTrace.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+
+namespace
+{
+    // Bumped whenever the output changes, so older cache entries are not reused.
+    constexpr int32 OptimizerVersion = 1;
+
+    constexpr uint32 TagHead = FEFSfntReader::MakeTag('h', 'e', 'a', 'd');
+    constexpr uint32 TagMaxp = FEFSfntReader::MakeTag('m', 'a', 'x', 'p');
+    constexpr uint32 TagGlyf = FEFSfntReader::MakeTag('g', 'l', 'y', 'f');
+    constexpr uint32 TagLoca = FEFSfntReader::MakeTag('l', 'o', 'c', 'a');
+    constexpr uint32 TagGasp = FEFSfntReader::MakeTag('g', 'a', 's', 'p');
+    constexpr uint32 TagCff = FEFSfntReader::MakeTag('C', 'F', 'F', ' ');
+    constexpr uint32 TagCff2 = FEFSfntReader::MakeTag('C', 'F', 'F', '2');
+
+    // Slate renders outlines through FreeType and shapes with HarfBuzz, neither reads these.
+    const uint32 UnusedTables[] = {
+        FEFSfntReader::MakeTag('D', 'S', 'I', 'G'),
+        FEFSfntReader::MakeTag('P', 'C', 'L', 'T'),
+        FEFSfntReader::MakeTag('J', 'S', 'T', 'F'),
+    };
+    // Bitmap and color glyphs, only dropped when the font also has outlines to fall back on.
+    const uint32 BitmapTables[] = {
+        FEFSfntReader::MakeTag('E', 'B', 'D', 'T'),
+        FEFSfntReader::MakeTag('E', 'B', 'L', 'C'),
+        FEFSfntReader::MakeTag('E', 'B', 'S', 'C'),
+        FEFSfntReader::MakeTag('C', 'B', 'D', 'T'),
+        FEFSfntReader::MakeTag('C', 'B', 'L', 'C'),
+        FEFSfntReader::MakeTag('s', 'b', 'i', 'x'),
+        FEFSfntReader::MakeTag('S', 'V', 'G', ' '),
+        FEFSfntReader::MakeTag('C', 'O', 'L', 'R'),
+        FEFSfntReader::MakeTag('C', 'P', 'A', 'L'),
+    };
+    // The bytecode, its variations and the tables precomputed from running it.
+    const uint32 HintingTables[] = {
+        FEFSfntReader::MakeTag('f', 'p', 'g', 'm'),
+        FEFSfntReader::MakeTag('p', 'r', 'e', 'p'),
+        FEFSfntReader::MakeTag('c', 'v', 't', ' '),
+        FEFSfntReader::MakeTag('c', 'v', 'a', 'r'),
+        FEFSfntReader::MakeTag('h', 'd', 'm', 'x'),
+        FEFSfntReader::MakeTag('V', 'D', 'M', 'X'),
+        FEFSfntReader::MakeTag('L', 'T', 'S', 'H'),
+    };
+
+    // Composite glyph component flags.
+    constexpr uint16 ArgsAreWords = 0x0001;
+    constexpr uint16 HaveScale = 0x0008;
+    constexpr uint16 MoreComponents = 0x0020;
+    constexpr uint16 HaveXYScale = 0x0040;
+    constexpr uint16 HaveTwoByTwo = 0x0080;
+    constexpr uint16 HaveInstructions = 0x0100;
+
+    bool IsListed(TConstArrayView<uint32> Tags, uint32 Tag)
+    {
+        return Tags.Contains(Tag);
+    }
+}
+
+bool FEFFontOptimizer::CopyGlyph(TConstArrayView<uint8> Glyph, bool bStripInstructions, TArray<uint8>& Out)
+{
+    if (Glyph.Num() == 0) { return true; }
+    if (Glyph.Num() < 10) { return false; }
+    const uint8* Data = Glyph.GetData();
+    const int32 Size = Glyph.Num();
+    const int16 NumContours = FEFSfntReader::ReadS16(Data);
+
+    if (NumContours >= 0)
+    {
+        int32 Pos = 10 + NumContours * 2;
+        if (Pos + 2 > Size) { return false; }
+        const int32 NumPoints = NumContours > 0 ? FEFSfntReader::ReadU16(Data + Pos - 2) + 1 : 0;
+        const int32 InstructionLength = FEFSfntReader::ReadU16(Data + Pos);
+        const int32 InstructionStart = Pos + 2;
+        Pos = InstructionStart + InstructionLength;
+        if (Pos > Size) { return false; }
+
+        // Flags are run-length coded, the coordinate sizes follow from them.
+        int32 XBytes = 0;
+        int32 YBytes = 0;
+        for (int32 Point = 0; Point < NumPoints;)
+        {
+            if (Pos >= Size) { return false; }
+            const uint8 Flag = Data[Pos++];
+            int32 Repeat = 1;
+            if (Flag & 0x08)
+            {
+                if (Pos >= Size) { return false; }
+                Repeat += Data[Pos++];
+            }
+            XBytes += Repeat * ((Flag & 0x02) ? 1 : ((Flag & 0x10) ? 0 : 2));
+            YBytes += Repeat * ((Flag & 0x04) ? 1 : ((Flag & 0x20) ? 0 : 2));
+            Point += Repeat;
+        }
+        const int32 End = Pos + XBytes + YBytes;
+        if (End > Size) { return false; }
+
+        if (!bStripInstructions)
+        {
+            Out.Append(Data, End);
+            return true;
+        }
+        const int32 Start = Out.Num();
+        Out.Append(Data, InstructionStart);
+        FEFSfntWriter::WriteU16(Out.GetData() + Start + InstructionStart - 2, 0);
+        Out.Append(Data + InstructionStart + InstructionLength, End - InstructionStart - InstructionLength);
+        return true;
+    }
+
+    int32 Pos = 10;
+    uint16 Flags = 0;
+    TArray<int32> FlagOffsets;
+    do
+    {
+        if (Pos + 4 > Size) { return false; }
+        Flags = FEFSfntReader::ReadU16(Data + Pos);
+        FlagOffsets.Add(Pos);
+        Pos += 4 + ((Flags & ArgsAreWords) ? 4 : 2);
+        if (Flags & HaveScale) { Pos += 2; }
+        else if (Flags & HaveXYScale) { Pos += 4; }
+        else if (Flags & HaveTwoByTwo) { Pos += 8; }
+        if (Pos > Size) { return false; }
+    } while (Flags & MoreComponents);
+
+    int32 End = Pos;
+    if (Flags & HaveInstructions)
+    {
+        if (Pos + 2 > Size) { return false; }
+        End = Pos + 2 + FEFSfntReader::ReadU16(Data + Pos);
+        if (End > Size) { return false; }
+    }
+    if (!bStripInstructions)
+    {
+        Out.Append(Data, End);
+        return true;
+    }
+    const int32 Start = Out.Num();
+    Out.Append(Data, Pos);
+    for (int32 FlagOffset : FlagOffsets)
+    {
+        FEFSfntWriter::WriteU16(Out.GetData() + Start + FlagOffset, FEFSfntReader::ReadU16(Data + FlagOffset) & ~HaveInstructions);
+    }
+    return true;
+}
+
+bool FEFFontOptimizer::CompactGlyphs(TConstArrayView<uint8> Glyf, TConstArrayView<uint8> Loca, bool bLongLoca, int32 NumGlyphs, bool bStripInstructions,
+    TArray<uint8>& OutGlyf, TArray<uint8>& OutLoca, bool& bOutLongLoca)
+{
+    if (Loca.Num() < (NumGlyphs + 1) * (bLongLoca ? 4 : 2)) { return false; }
+    auto ReadOffset = [&Loca, bLongLoca](int32 Index) -> uint32
+    {
+        return bLongLoca ? FEFSfntReader::ReadU32(Loca.GetData() + Index * 4) : uint32(FEFSfntReader::ReadU16(Loca.GetData() + Index * 2)) * 2;
+    };
+
+    TArray<uint32> Offsets;
+    Offsets.Reserve(NumGlyphs + 1);
+    OutGlyf.Reset();
+    OutGlyf.Reserve(Glyf.Num());
+    for (int32 Index = 0; Index < NumGlyphs; Index++)
+    {
+        const uint32 Start = ReadOffset(Index);
+        const uint32 End = ReadOffset(Index + 1);
+        if (Start > End || End > uint32(Glyf.Num())) { return false; }
+        Offsets.Add(OutGlyf.Num());
+        if (!CopyGlyph(Glyf.Slice(Start, End - Start), bStripInstructions, OutGlyf)) { return false; }
+        OutGlyf.AddZeroed(Align(OutGlyf.Num(), 4) - OutGlyf.Num());
+    }
+    Offsets.Add(OutGlyf.Num());
+
+    // The short format stores offsets / 2, it fits whenever the compacted glyf is under 128 KB.
+    bOutLongLoca = OutGlyf.Num() > 0x1FFFE;
+    OutLoca.SetNumZeroed(Offsets.Num() * (bOutLongLoca ? 4 : 2));
+    for (int32 Index = 0; Index < Offsets.Num(); Index++)
+    {
+        if (bOutLongLoca) { FEFSfntWriter::WriteU32(OutLoca.GetData() + Index * 4, Offsets[Index]); }
+        else { FEFSfntWriter::WriteU16(OutLoca.GetData() + Index * 2, uint16(Offsets[Index] / 2)); }
+    }
+    return true;
+}
+
+bool FEFFontOptimizer::Optimize(TConstArrayView<uint8> Font, const FOptions& Options, FArchive& Out)
+{
+    FEFSfntReader Reader;
+    if (!Reader.Open(Font)) { return false; }
+    TConstArrayView<uint8> Head = Reader.GetTableData(TagHead);
+    if (Head.Num() < 54) { return false; }
+
+    const bool bHasGlyf = Reader.FindTable(TagGlyf) != nullptr && Reader.FindTable(TagLoca) != nullptr;
+    const bool bHasOutlines = bHasGlyf || Reader.FindTable(TagCff) != nullptr || Reader.FindTable(TagCff2) != nullptr;
+    const bool bStripHinting = Options.bStripHinting && bHasGlyf;
+
+    FEFSfntWriter Writer(Reader.GetSfntVersion());
+    TArray<uint8> NewHead(Head.GetData(), Head.Num());
+    for (const FEFSfntReader::FTable& Table : Reader.GetTables())
+    {
+        const uint32 Tag = Table.Tag;
+        if (IsListed(UnusedTables, Tag)) { continue; }
+        if (bHasOutlines && IsListed(BitmapTables, Tag)) { continue; }
+        if (bStripHinting && IsListed(HintingTables, Tag)) { continue; }
+        if (Tag == TagHead || Tag == TagGlyf || Tag == TagLoca) { continue; }
+
+        const TConstArrayView<uint8> Source = Reader.GetTableData(Tag);
+        TArray<uint8> Data(Source.GetData(), Source.Num());
+        if (bStripHinting && Tag == TagMaxp && Data.Num() >= 32)
+        {
+            // Nothing left to run: one zone, no twilight points, storage, functions, stack or instructions.
+            FEFSfntWriter::WriteU16(Data.GetData() + 14, 1);
+            for (int32 Offset = 16; Offset <= 26; Offset += 2)
+            {
+                FEFSfntWriter::WriteU16(Data.GetData() + Offset, 0);
+            }
+        }
+        else if (bStripHinting && Tag == TagGasp)
+        {
+            // One range for every size: grayscale with symmetric smoothing, what an unhinted font wants.
+            Data.SetNumZeroed(8);
+            FEFSfntWriter::WriteU16(Data.GetData(), 1);
+            FEFSfntWriter::WriteU16(Data.GetData() + 2, 1);
+            FEFSfntWriter::WriteU16(Data.GetData() + 4, 0xFFFF);
+            FEFSfntWriter::WriteU16(Data.GetData() + 6, 0x000A);
+        }
+        Writer.AddTable(Tag, MoveTemp(Data));
+    }
+
+    if (bHasGlyf)
+    {
+        TArray<uint8> Glyf;
+        TArray<uint8> Loca;
+        bool bLongLoca = false;
+        const bool bSourceLongLoca = FEFSfntReader::ReadS16(Head.GetData() + 50) != 0;
+        if (!CompactGlyphs(Reader.GetTableData(TagGlyf), Reader.GetTableData(TagLoca), bSourceLongLoca, Reader.GetGlyphCount(), bStripHinting, Glyf, Loca, bLongLoca))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("glyf/loca could not be parsed, leaving the font as it is"));
+            return false;
+        }
+        FEFSfntWriter::WriteU16(NewHead.GetData() + 50, bLongLoca ? 1 : 0);
+        Writer.AddTable(TagGlyf, MoveTemp(Glyf));
+        Writer.AddTable(TagLoca, MoveTemp(Loca));
+    }
+    Writer.AddTable(TagHead, MoveTemp(NewHead));
+    return Writer.Write(Out);
+}
+
+FString FEFFontOptimizer::OptimizeFont(const FString& SourceFont, const FOptions& Options)
+{
+    EF_TRACE_SCOPE("EditorFont::OptimizeFont");
+    const FString SourceHash = FEFContentCache::HashFile(SourceFont);
+    if (SourceHash.IsEmpty()) { return FString(); }
+    const FString Extension = FPaths::GetExtension(SourceFont, true);
+    const FString Key = SourceHash + FEFContentCache::HashString(FString::Printf(TEXT("v%d|hinting=%d"), OptimizerVersion, Options.bStripHinting ? 0 : 1));
+    FEFContentCache& Cache = FEFContentCache::Get();
+    const FString Cached = Cache.Find(TEXT("Optimized"), Key, Extension);
+    if (!Cached.IsEmpty())
+    {
+        return Cached;
+    }
+
+    TArray<uint8> Font;
+    if (!FFileHelper::LoadFileToArray(Font, *SourceFont, FILEREAD_Silent)) { return FString(); }
+    const FString Staging = Cache.MakeStagingPath(Extension);
+    bool bWritten = false;
+    {
+        TUniquePtr<FArchive> Out(IFileManager::Get().CreateFileWriter(*Staging));
+        bWritten = Out && Optimize(Font, Options, *Out);
+    }
+    if (!bWritten || !Cache.Publish(TEXT("Optimized"), Key, Extension, Staging))
+    {
+        IFileManager::Get().Delete(*Staging);
+        UE_LOG(LogTemp, Warning, TEXT("Failed to optimize %s"), *SourceFont);
+        return FString();
+    }
+    const FString Optimized = Cache.GetEntryPath(TEXT("Optimized"), Key, Extension);
+    UE_LOG(LogTemp, Log, TEXT("Optimized %s: %d -> %lld bytes"), *FPaths::GetCleanFilename(SourceFont), Font.Num(), IFileManager::Get().FileSize(*Optimized));
+    return Optimized;
+}
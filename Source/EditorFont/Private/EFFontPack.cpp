@@ -0,0 +1,272 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFFontPack.h"
+
+#include "EFContentCache.h"
+#include "EFTrace.h"
+#include "Async/MappedFileHandle.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+
+
+namespace
+{
+    constexpr uint32 PackMagic = 0x4B504645; // "EFPK"
+    constexpr int32 PackVersion = 1;
+    // Page aligned members can be handed to a loader without copying.
+    constexpr uint32 PackAlignment = 4096;
+    const TCHAR* PackExtension = TEXT(".efpack");
+
+    struct FOpenPack
+    {
+        int64 Size = 0;
+        FDateTime Timestamp;
+        TSharedPtr<FEFFontPack> Pack;
+    };
+    FCriticalSection OpenMutex;
+    TMap<FString, FOpenPack> OpenPacks;
+
+    void SerializeToc(FArchive& Ar, TArray<FEFFontPack::FMember>& Members, TMap<FString, FString>& Slots)
+    {
+        int32 NumMembers = Members.Num();
+        Ar << NumMembers;
+        if (Ar.IsLoading())
+        {
+            if (NumMembers < 0 || NumMembers > 65536) { Ar.SetError(); return; }
+            Members.SetNum(NumMembers);
+        }
+        for (FEFFontPack::FMember& Member : Members)
+        {
+            Ar << Member.Name << Member.Offset << Member.Size << Member.Hash;
+        }
+        Ar << Slots;
+    }
+}
+
+FEFFontPack::~FEFFontPack() = default;
+
+bool FEFFontPack::IsPackFile(const FString& Path)
+{
+    return FPaths::GetExtension(Path, true) == PackExtension;
+}
+
+bool FEFFontPack::SplitMemberPath(const FString& Path, FString& OutPack, FString& OutMember)
+{
+    const FString Marker = FString(PackExtension) + TEXT("/");
+    const int32 Found = Path.Find(Marker, ESearchCase::IgnoreCase, ESearchDir::FromEnd);
+    if (Found == INDEX_NONE) { return false; }
+    OutPack = Path.Left(Found + Marker.Len() - 1);
+    OutMember = Path.Mid(Found + Marker.Len());
+    return !OutMember.IsEmpty() && !OutMember.Contains(TEXT("/"));
+}
+
+bool FEFFontPack::IsPackMember(const FString& Path)
+{
+    FString Pack, Member;
+    return SplitMemberPath(Path, Pack, Member);
+}
+
+FString FEFFontPack::GetPackFile(const FString& Path)
+{
+    FString Pack, Member;
+    return SplitMemberPath(Path, Pack, Member) ? Pack : Path;
+}
+
+bool FEFFontPack::Write(const FString& PackFile, const TArray<TPair<FString, FString>>& Fonts, const TMap<FString, FString>& Slots)
+{
+    EF_TRACE_SCOPE("EditorFont::WriteFontPack");
+    TArray<FMember> Members;
+    for (const TPair<FString, FString>& Font : Fonts)
+    {
+        FMember& Member = Members.AddDefaulted_GetRef();
+        Member.Name = Font.Key;
+        Member.Size = uint64(FMath::Max<int64>(IFileManager::Get().FileSize(*Font.Value), 0));
+        Member.Hash = FEFContentCache::HashFile(Font.Value);
+        if (Member.Hash.IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Cannot read %s for the pack"), *Font.Value);
+            return false;
+        }
+    }
+
+    // Offsets are fixed size, so the table of contents is as long with placeholders as with the real values.
+    TMap<FString, FString> SlotsCopy = Slots;
+    TArray<uint8> Toc;
+    {
+        FMemoryWriter Writer(Toc);
+        SerializeToc(Writer, Members, SlotsCopy);
+    }
+    const uint64 HeaderSize = sizeof(uint32) * 4;
+    uint64 Offset = Align(HeaderSize + Toc.Num(), uint64(PackAlignment));
+    for (FMember& Member : Members)
+    {
+        Member.Offset = Offset;
+        Offset = Align(Offset + Member.Size, uint64(PackAlignment));
+    }
+    Toc.Reset();
+    {
+        FMemoryWriter Writer(Toc);
+        SerializeToc(Writer, Members, SlotsCopy);
+    }
+
+    const FString Staging = PackFile + TEXT(".tmp");
+    {
+        TUniquePtr<FArchive> Out(IFileManager::Get().CreateFileWriter(*Staging));
+        if (!Out) { return false; }
+        uint32 Magic = PackMagic;
+        int32 Version = PackVersion;
+        uint32 Alignment = PackAlignment;
+        uint32 TocSize = uint32(Toc.Num());
+        *Out << Magic << Version << Alignment << TocSize;
+        Out->Serialize(Toc.GetData(), Toc.Num());
+        TArray<uint8> Padding;
+        Padding.SetNumZeroed(PackAlignment);
+        for (int32 Index = 0; Index < Members.Num(); Index++)
+        {
+            Out->Serialize(Padding.GetData(), int64(Members[Index].Offset) - Out->Tell());
+            TArray<uint8> Font;
+            if (!FFileHelper::LoadFileToArray(Font, *Fonts[Index].Value) || uint64(Font.Num()) != Members[Index].Size)
+            {
+                Out.Reset();
+                IFileManager::Get().Delete(*Staging);
+                return false;
+            }
+            Out->Serialize(Font.GetData(), Font.Num());
+        }
+        if (Out->IsError())
+        {
+            Out.Reset();
+            IFileManager::Get().Delete(*Staging);
+            return false;
+        }
+    }
+    return IFileManager::Get().Move(*PackFile, *Staging, true, true);
+}
+
+bool FEFFontPack::Map(const FString& PackFile)
+{
+    Handle.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*PackFile));
+    Region.Reset(Handle ? Handle->MapRegion() : nullptr);
+    if (Region)
+    {
+        // Members are sliced with int32 offsets, a pack that large is not one we wrote.
+        if (Region->GetMappedSize() > MAX_int32) { return false; }
+        Data = MakeArrayView(Region->GetMappedPtr(), int32(Region->GetMappedSize()));
+    }
+    else if (FFileHelper::LoadFileToArray(Loaded, *PackFile, FILEREAD_Silent))
+    {
+        Data = Loaded;
+    }
+    if (Data.Num() < 16) { return false; }
+
+    FMemoryReaderView Reader(Data);
+    uint32 Magic = 0;
+    int32 Version = 0;
+    uint32 Alignment = 0;
+    uint32 TocSize = 0;
+    Reader << Magic << Version << Alignment << TocSize;
+    if (Magic != PackMagic || Version != PackVersion || uint64(TocSize) + 16 > uint64(Data.Num())) { return false; }
+    SerializeToc(Reader, Members, Slots);
+    if (Reader.IsError()) { return false; }
+    // Checked without adding the two, a crafted offset near 2^64 would wrap the sum back into range.
+    const uint64 Num = uint64(Data.Num());
+    for (const FMember& Member : Members)
+    {
+        if (Member.Offset > Num || Member.Size > Num - Member.Offset) { return false; }
+    }
+    return true;
+}
+
+TSharedPtr<FEFFontPack> FEFFontPack::Open(const FString& PackFile)
+{
+    const FFileStatData Stat = IFileManager::Get().GetStatData(*PackFile);
+    if (!Stat.bIsValid) { return nullptr; }
+    FScopeLock Lock(&OpenMutex);
+    FOpenPack& Open = OpenPacks.FindOrAdd(PackFile);
+    if (Open.Pack && Open.Size == Stat.FileSize && Open.Timestamp == Stat.ModificationTime) { return Open.Pack; }
+
+    EF_TRACE_SCOPE("EditorFont::OpenFontPack");
+    // Readers holding the old mapping keep it alive until they are done.
+    Open.Pack = MakeShared<FEFFontPack>();
+    Open.Size = Stat.FileSize;
+    Open.Timestamp = Stat.ModificationTime;
+    if (!Open.Pack->Map(PackFile))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Not a readable font pack: %s"), *PackFile);
+        OpenPacks.Remove(PackFile);
+        return nullptr;
+    }
+    return Open.Pack;
+}
+
+const FEFFontPack::FMember* FEFFontPack::FindMember(const FString& Name) const
+{
+    return Members.FindByPredicate([&Name](const FMember& Member) { return Member.Name == Name; });
+}
+
+TConstArrayView<uint8> FEFFontPack::GetMemberData(const FMember& Member) const
+{
+    // Map rejected any member outside Data, so both fit in int32.
+    return Data.Slice(int32(Member.Offset), int32(Member.Size));
+}
+
+TArray<FString> FEFFontPack::ExpandMembers(const TArray<FString>& Paths)
+{
+    TArray<FString> Expanded;
+    Expanded.Reserve(Paths.Num());
+    for (const FString& Path : Paths)
+    {
+        if (!IsPackFile(Path))
+        {
+            Expanded.Add(Path);
+            continue;
+        }
+        if (const TSharedPtr<FEFFontPack> Pack = Open(Path))
+        {
+            for (const FMember& Member : Pack->GetMembers())
+            {
+                Expanded.Add(Path / Member.Name);
+            }
+        }
+    }
+    return Expanded;
+}
+
+bool FEFFontPack::ExtractMember(const FString& MemberPath, const FString& Target)
+{
+    FString PackFile, Name;
+    if (!SplitMemberPath(MemberPath, PackFile, Name)) { return false; }
+    const TSharedPtr<FEFFontPack> Pack = Open(PackFile);
+    const FMember* Member = Pack ? Pack->FindMember(Name) : nullptr;
+    if (Member == nullptr)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No %s in %s"), *Name, *PackFile);
+        return false;
+    }
+    EF_TRACE_SCOPE("EditorFont::ExtractPackMember");
+    return FFileHelper::SaveArrayToFile(Pack->GetMemberData(*Member), *Target);
+}
+
+FString FEFFontPack::ResolveMember(const FString& MemberPath)
+{
+    FString PackFile, Name;
+    if (!SplitMemberPath(MemberPath, PackFile, Name)) { return MemberPath; }
+    const TSharedPtr<FEFFontPack> Pack = Open(PackFile);
+    const FMember* Member = Pack ? Pack->FindMember(Name) : nullptr;
+    if (Member == nullptr) { return FString(); }
+    FEFContentCache& Cache = FEFContentCache::Get();
+    const FString Extension = FPaths::GetExtension(Name, true);
+    const FString Cached = Cache.Find(TEXT("Packs"), Member->Hash, Extension);
+    if (!Cached.IsEmpty()) { return Cached; }
+    const FString Staging = Cache.MakeStagingPath(Extension);
+    if (!FFileHelper::SaveArrayToFile(Pack->GetMemberData(*Member), *Staging) || !Cache.Publish(TEXT("Packs"), Member->Hash, Extension, Staging))
+    {
+        return FString();
+    }
+    return Cache.GetEntryPath(TEXT("Packs"), Member->Hash, Extension);
+}
@@ -0,0 +1,213 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFFontScanner.h"
+
+#include "EFCoreBridge.h"
+#include "EFCoreFontFile.h"
+#include "EFFontCollection.h"
+#include "EFFontPack.h"
+#include "EFTrace.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#if PLATFORM_WINDOWS
+#include "Windows/AllowWindowsPlatformTypes.h"
+#include "Windows/WindowsHWrapper.h"
+#include "Windows/HideWindowsPlatformTypes.h"
+#elif PLATFORM_UNIX || PLATFORM_MAC
+#include <stdlib.h>
+#endif
+
+
+namespace
+{
+    constexpr double ScanReuseSeconds = 2.0;
+    // Backstop for loops the resolved paths cannot see, such as bind mounts.
+    constexpr int32 MaxDepth = 32;
+
+    // Resolved paths have the case they have on disk, so they compare exactly on every platform.
+    struct FExactPathKeyFuncs : BaseKeyFuncs<FString, FString, false>
+    {
+        static const FString& GetSetKey(const FString& Element) { return Element; }
+        static bool Matches(const FString& A, const FString& B) { return A.Equals(B, ESearchCase::CaseSensitive); }
+        static uint32 GetKeyHash(const FString& Key) { return FCrc::StrCrc32(*Key); }
+    };
+}
+
+FEFFontScanner& FEFFontScanner::Get()
+{
+    static FEFFontScanner Scanner;
+    return Scanner;
+}
+
+const TArray<FString>& FEFFontScanner::GetFontExtensions()
+{
+    static const TArray<FString> Extensions = []()
+        {
+            TArray<FString> Result;
+            for (const std::string& Extension : EFCore::GetFontExtensions())
+            {
+                Result.Add(FEFCoreBridge::FromUtf8(Extension));
+            }
+            // Packs are the plugin's own format, the core only knows sfnt files.
+            Result.Add(TEXT(".efpack"));
+            return Result;
+        }();
+    return Extensions;
+}
+
+TArray<FString> FEFFontScanner::GetSystemFontDirectories()
+{
+    TArray<FString> Candidates;
+#if PLATFORM_WINDOWS
+    Candidates.Add(FPlatformMisc::GetEnvironmentVariable(TEXT("WINDIR")) / TEXT("Fonts"));
+    Candidates.Add(FPlatformMisc::GetEnvironmentVariable(TEXT("LOCALAPPDATA")) / TEXT("Microsoft/Windows/Fonts"));
+#elif PLATFORM_MAC
+    Candidates.Add(TEXT("/System/Library/Fonts"));
+    Candidates.Add(TEXT("/Library/Fonts"));
+    Candidates.Add(FPlatformMisc::GetEnvironmentVariable(TEXT("HOME")) / TEXT("Library/Fonts"));
+#else
+    Candidates.Add(TEXT("/usr/share/fonts"));
+    Candidates.Add(TEXT("/usr/local/share/fonts"));
+    Candidates.Add(FPlatformMisc::GetEnvironmentVariable(TEXT("HOME")) / TEXT(".local/share/fonts"));
+    Candidates.Add(FPlatformMisc::GetEnvironmentVariable(TEXT("HOME")) / TEXT(".fonts"));
+#endif
+    IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    return Candidates.FilterByPredicate([&PlatformFile](const FString& Directory) { return PlatformFile.DirectoryExists(*Directory); });
+}
+
+FString FEFFontScanner::ResolveDirectory(const FString& Directory)
+{
+    FString Resolved;
+#if PLATFORM_WINDOWS
+    HANDLE Handle = ::CreateFileW(*Directory, 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, nullptr);
+    if (Handle == INVALID_HANDLE_VALUE) { return FString(); }
+    TCHAR Buffer[MAX_PATH * 4];
+    const DWORD Length = ::GetFinalPathNameByHandleW(Handle, Buffer, UE_ARRAY_COUNT(Buffer), FILE_NAME_NORMALIZED);
+    ::CloseHandle(Handle);
+    if (Length > 0 && Length < UE_ARRAY_COUNT(Buffer))
+    {
+        Resolved = Buffer;
+        Resolved.RemoveFromStart(TEXT("\\\\?\\"));
+    }
+#elif PLATFORM_UNIX || PLATFORM_MAC
+    if (char* Real = realpath(TCHAR_TO_UTF8(*Directory), nullptr))
+    {
+        Resolved = UTF8_TO_TCHAR(Real);
+        free(Real);
+    }
+    else
+    {
+        return FString();
+    }
+#endif
+    if (Resolved.IsEmpty())
+    {
+        if (!FPlatformFileManager::Get().GetPlatformFile().DirectoryExists(*Directory)) { return FString(); }
+        Resolved = FPaths::ConvertRelativePathToFull(Directory);
+    }
+    FPaths::NormalizeDirectoryName(Resolved);
+    return Resolved;
+}
+
+TArray<FString> FEFFontScanner::Walk(const TArray<FString>& Roots)
+{
+    EF_TRACE_SCOPE("EditorFont::ScanFontLibrary");
+    // Directories are keyed by resolved path but listed by the path they were reached through,
+    // so fonts under a root keep that root as their prefix.
+    TSet<FString, FExactPathKeyFuncs> Visited;
+    TArray<FString> Frontier;
+    for (const FString& Root : Roots)
+    {
+        const FString Resolved = ResolveDirectory(Root);
+        if (Resolved.IsEmpty()) { continue; }
+        bool bAlreadyVisited = false;
+        Visited.Add(Resolved, &bAlreadyVisited);
+        if (bAlreadyVisited) { continue; }
+        FString Logical = FPaths::ConvertRelativePathToFull(Root);
+        FPaths::NormalizeDirectoryName(Logical);
+        Frontier.Add(Logical);
+    }
+
+    TArray<FString> Files;
+    for (int32 Depth = 0; Frontier.Num() > 0 && Depth < MaxDepth; Depth++)
+    {
+        TArray<TArray<TPair<FString, FString>>> SubDirectories;
+        TArray<TArray<FString>> FoundFiles;
+        SubDirectories.SetNum(Frontier.Num());
+        FoundFiles.SetNum(Frontier.Num());
+        ParallelFor(Frontier.Num(), [&](int32 Index)
+            {
+                TArray<FString> Children;
+                FPlatformFileManager::Get().GetPlatformFile().IterateDirectory(*Frontier[Index], [&](const TCHAR* Name, bool bIsDirectory)
+                    {
+                        const FString Path(Name);
+                        if (FPaths::GetCleanFilename(Path).StartsWith(TEXT("."))) { return true; }
+                        if (bIsDirectory)
+                        {
+                            Children.Add(Path);
+                        }
+                        // The extension test ignores case, so .TTF and .Otf match too.
+                        else if (EFCore::IsFontFileName(FEFCoreBridge::ToUtf8(FPaths::GetExtension(Path, true))) || FEFFontPack::IsPackFile(Path))
+                        {
+                            FoundFiles[Index].Add(Path);
+                        }
+                        return true;
+                    });
+                // Resolving here keeps the realpath calls on the workers.
+                for (const FString& Child : Children)
+                {
+                    FString Resolved = ResolveDirectory(Child);
+                    if (!Resolved.IsEmpty()) { SubDirectories[Index].Emplace(Child, MoveTemp(Resolved)); }
+                }
+            });
+
+        Frontier.Reset();
+        for (int32 Index = 0; Index < SubDirectories.Num(); Index++)
+        {
+            Files.Append(MoveTemp(FoundFiles[Index]));
+            for (TPair<FString, FString>& Directory : SubDirectories[Index])
+            {
+                bool bAlreadyVisited = false;
+                Visited.Add(Directory.Value, &bAlreadyVisited);
+                if (!bAlreadyVisited) { Frontier.Add(MoveTemp(Directory.Key)); }
+            }
+        }
+    }
+    if (Frontier.Num() > 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Font scan stopped at depth %d, %d directories were not listed"), MaxDepth, Frontier.Num());
+    }
+    Files.Sort();
+    return Files;
+}
+
+TArray<FString> FEFFontScanner::Scan(const TArray<FString>& Roots, bool* bOutRescanned)
+{
+    FScopeLock Lock(&Mutex);
+    const double Now = FPlatformTime::Seconds();
+    // Expired sets go, so folders browsed once do not pile up.
+    for (auto It = Cache.CreateIterator(); It; ++It)
+    {
+        if (Now - It.Value().Time >= ScanReuseSeconds) { It.RemoveCurrent(); }
+    }
+    const FString Key = FString::Join(Roots, TEXT("|"));
+    const FCachedScan* Cached = Cache.Find(Key);
+    if (bOutRescanned) { *bOutRescanned = Cached == nullptr; }
+    if (Cached) { return Cached->Files; }
+
+    FCachedScan& Scanned = Cache.Add(Key);
+    Scanned.Files = FEFFontPack::ExpandMembers(FEFFontCollection::ExpandFaces(Walk(Roots)));
+    Scanned.Time = FPlatformTime::Seconds();
+    UE_LOG(LogTemp, Log, TEXT("Scanned %d roots: %d fonts in %.1f ms"), Roots.Num(), Scanned.Files.Num(), (Scanned.Time - Now) * 1000.0);
+    return Scanned.Files;
+}
+
+void FEFFontScanner::Invalidate()
+{
+    FScopeLock Lock(&Mutex);
+    Cache.Reset();
+}
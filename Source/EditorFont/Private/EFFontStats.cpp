@@ -0,0 +1,185 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFFontStats.h"
+
+#include "EFSfnt.h"
+#include "EFTrace.h"
+#include "EFWorkQueue.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+#if WITH_FREETYPE
+THIRD_PARTY_INCLUDES_START
+#include "ft2build.h"
+#include FT_FREETYPE_H
+#include FT_MODULE_H
+THIRD_PARTY_INCLUDES_END
+#endif
+
+
+#if WITH_FREETYPE
+namespace
+{
+    // Every block carries its size in front so frees can be counted.
+    constexpr SIZE_T HeaderSize = 16;
+
+    struct FCountingMemory
+    {
+        FT_MemoryRec_ Rec;
+        int64 LiveBytes = 0;
+    };
+
+    void* CountingAlloc(FT_Memory Memory, long Size)
+    {
+        uint8* Block = static_cast<uint8*>(FMemory::Malloc(Size + HeaderSize));
+        *reinterpret_cast<long*>(Block) = Size;
+        static_cast<FCountingMemory*>(Memory->user)->LiveBytes += Size;
+        return Block + HeaderSize;
+    }
+
+    void CountingFree(FT_Memory Memory, void* Ptr)
+    {
+        if (Ptr == nullptr) { return; }
+        uint8* Block = static_cast<uint8*>(Ptr) - HeaderSize;
+        static_cast<FCountingMemory*>(Memory->user)->LiveBytes -= *reinterpret_cast<long*>(Block);
+        FMemory::Free(Block);
+    }
+
+    void* CountingRealloc(FT_Memory Memory, long CurSize, long NewSize, void* Ptr)
+    {
+        uint8* Block = Ptr ? static_cast<uint8*>(Ptr) - HeaderSize : nullptr;
+        Block = static_cast<uint8*>(FMemory::Realloc(Block, NewSize + HeaderSize));
+        *reinterpret_cast<long*>(Block) = NewSize;
+        static_cast<FCountingMemory*>(Memory->user)->LiveBytes += NewSize - CurSize;
+        return Block + HeaderSize;
+    }
+}
+#endif
+
+FEFFontStats& FEFFontStats::Get()
+{
+    static FEFFontStats Stats;
+    return Stats;
+}
+
+FString FEFFontStats::MakeKey(const FString& Path)
+{
+    FString Key = FPaths::ConvertRelativePathToFull(Path);
+    FPaths::NormalizeFilename(Key);
+    return Key;
+}
+
+FEFFontStatsEntry FEFFontStats::GetStats(const FString& Path)
+{
+    const FString Key = MakeKey(Path);
+    {
+        FScopeLock Lock(&Mutex);
+        if (const FEFFontStatsEntry* Entry = Entries.Find(Key))
+        {
+            return *Entry;
+        }
+    }
+    FEFFontStatsEntry Entry;
+    Measure(Key, Entry);
+    FScopeLock Lock(&Mutex);
+    Entries.Add(Key, Entry);
+    return Entry;
+}
+
+bool FEFFontStats::FindStats(const FString& Path, FEFFontStatsEntry& OutEntry)
+{
+    FScopeLock Lock(&Mutex);
+    const FEFFontStatsEntry* Entry = Entries.Find(MakeKey(Path));
+    if (Entry == nullptr) { return false; }
+    OutEntry = *Entry;
+    return true;
+}
+
+bool FEFFontStats::FindOrRequestStats(const FString& Path, FEFFontStatsEntry& OutEntry)
+{
+    check(IsInGameThread());
+    const FString Key = MakeKey(Path);
+    {
+        FScopeLock Lock(&Mutex);
+        if (const FEFFontStatsEntry* Entry = Entries.Find(Key))
+        {
+            OutEntry = *Entry;
+            return true;
+        }
+        if (Pending.Contains(Key)) { return false; }
+        Pending.Add(Key);
+    }
+    FEFWorkQueue::Get().Enqueue(TEXT("Measuring ") + FPaths::GetCleanFilename(Key),
+        [this, Key](FEFWorkQueue::FProgress& Progress)
+        {
+            FEFFontStatsEntry Entry;
+            const bool bMeasured = Measure(Key, Entry);
+            FScopeLock Lock(&Mutex);
+            Entries.Add(Key, Entry);
+            Pending.Remove(Key);
+            return bMeasured;
+        });
+    // Commandlets measure inline, the entry is already there.
+    return FindStats(Key, OutEntry);
+}
+
+void FEFFontStats::Invalidate(const FString& Path)
+{
+    FScopeLock Lock(&Mutex);
+    Entries.Remove(MakeKey(Path));
+}
+
+bool FEFFontStats::Measure(const FString& Path, FEFFontStatsEntry& OutEntry)
+{
+    EF_TRACE_SCOPE("EditorFont::MeasureFont");
+    OutEntry = FEFFontStatsEntry();
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *Path, FILEREAD_Silent)) { return false; }
+    OutEntry.FileBytes = Data.Num();
+
+    FEFSfntReader Reader;
+    if (!Reader.Open(Data)) { return false; }
+    OutEntry.GlyphCount = Reader.GetGlyphCount();
+
+#if WITH_FREETYPE
+    FCountingMemory Memory;
+    Memory.Rec.user = &Memory;
+    Memory.Rec.alloc = &CountingAlloc;
+    Memory.Rec.free = &CountingFree;
+    Memory.Rec.realloc = &CountingRealloc;
+
+    FT_Library Library = nullptr;
+    if (FT_New_Library(&Memory.Rec, &Library) != 0) { return false; }
+    FT_Add_Default_Modules(Library);
+    const int64 LibraryBytes = Memory.LiveBytes;
+
+    FT_Face Face = nullptr;
+    if (FT_New_Memory_Face(Library, Data.GetData(), Data.Num(), 0, &Face) != 0)
+    {
+        FT_Done_Library(Library);
+        return false;
+    }
+    // Default editor text: 9pt at 96 DPI, the printable ASCII range.
+    FT_Set_Char_Size(Face, 0, 9 * 64, 96, 96);
+    for (FT_ULong CodePoint = 0x20; CodePoint < 0x7F; CodePoint++)
+    {
+        const FT_UInt GlyphIndex = FT_Get_Char_Index(Face, CodePoint);
+        if (GlyphIndex != 0)
+        {
+            FT_Load_Glyph(Face, GlyphIndex, FT_LOAD_DEFAULT);
+        }
+    }
+    OutEntry.LoadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+    OutEntry.FaceBytes = Memory.LiveBytes - LibraryBytes;
+    FT_Done_Face(Face);
+    FT_Done_Library(Library);
+#else
+    OutEntry.LoadMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+#endif
+    OutEntry.bValid = true;
+    return true;
+}
@@ -0,0 +1,332 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFSdfAtlas.h"
+
+#include "EFContentCache.h"
+#include "EFSubset.h"
+#include "EFTrace.h"
+#include "EFWorkQueue.h"
+#include "UDevEditor.h"
+#include "Async/ParallelFor.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+
+#if WITH_FREETYPE
+THIRD_PARTY_INCLUDES_START
+#include "ft2build.h"
+#include FT_FREETYPE_H
+THIRD_PARTY_INCLUDES_END
+#endif
+
+
+namespace
+{
+    constexpr uint32 AtlasMagic = 0x45465344; // "EFSD"
+    constexpr int32 AtlasVersion = 1;
+
+    struct FRenderedGlyph
+    {
+        FEFSdfGlyph Glyph;
+        TArray<uint8> Pixels;
+    };
+
+    /** 8SSEDT: Euclidean distance from every cell to the nearest cell flagged in Target. */
+    void DistanceTransform(const TArray<bool>& Target, int32 Width, int32 Height, TArray<float>& OutDistance)
+    {
+        struct FOffset
+        {
+            int32 X;
+            int32 Y;
+            int32 LengthSquared() const { return X * X + Y * Y; }
+        };
+        constexpr int32 Far = 1 << 14;
+        TArray<FOffset> Grid;
+        Grid.SetNumUninitialized(Width * Height);
+        for (int32 Index = 0; Index < Grid.Num(); Index++)
+        {
+            Grid[Index] = Target[Index] ? FOffset{ 0, 0 } : FOffset{ Far, Far };
+        }
+        auto Compare = [&Grid, Width, Height](int32 X, int32 Y, int32 DX, int32 DY)
+        {
+            if (X + DX < 0 || X + DX >= Width || Y + DY < 0 || Y + DY >= Height) { return; }
+            FOffset Other = Grid[(Y + DY) * Width + X + DX];
+            Other.X += DX;
+            Other.Y += DY;
+            FOffset& Cell = Grid[Y * Width + X];
+            if (Other.LengthSquared() < Cell.LengthSquared()) { Cell = Other; }
+        };
+        for (int32 Y = 0; Y < Height; Y++)
+        {
+            for (int32 X = 0; X < Width; X++)
+            {
+                Compare(X, Y, -1, 0);
+                Compare(X, Y, 0, -1);
+                Compare(X, Y, -1, -1);
+                Compare(X, Y, 1, -1);
+            }
+            for (int32 X = Width - 1; X >= 0; X--)
+            {
+                Compare(X, Y, 1, 0);
+            }
+        }
+        for (int32 Y = Height - 1; Y >= 0; Y--)
+        {
+            for (int32 X = Width - 1; X >= 0; X--)
+            {
+                Compare(X, Y, 1, 0);
+                Compare(X, Y, 0, 1);
+                Compare(X, Y, -1, 1);
+                Compare(X, Y, 1, 1);
+            }
+            for (int32 X = 0; X < Width; X++)
+            {
+                Compare(X, Y, -1, 0);
+            }
+        }
+        OutDistance.SetNumUninitialized(Grid.Num());
+        for (int32 Index = 0; Index < Grid.Num(); Index++)
+        {
+            OutDistance[Index] = FMath::Sqrt(float(Grid[Index].LengthSquared()));
+        }
+    }
+
+#if WITH_FREETYPE
+    bool RenderGlyph(FT_Face Face, uint32 CodePoint, const FEFSdfAtlas::FOptions& Options, FRenderedGlyph& Out)
+    {
+        const FT_UInt GlyphIndex = FT_Get_Char_Index(Face, CodePoint);
+        if (GlyphIndex == 0 || FT_Load_Glyph(Face, GlyphIndex, FT_LOAD_RENDER | FT_LOAD_NO_HINTING) != 0) { return false; }
+        const FT_GlyphSlot Slot = Face->glyph;
+        const FT_Bitmap& Bitmap = Slot->bitmap;
+        const int32 Oversample = Options.Oversample;
+        Out.Glyph.CodePoint = CodePoint;
+        Out.Glyph.Advance = uint16(FMath::RoundToInt(Slot->advance.x / 64.0f / Oversample));
+        if (Bitmap.width == 0 || Bitmap.rows == 0)
+        {
+            return true;
+        }
+
+        // Pad by the spread so the field can fall off outside the outline, and round up to whole atlas pixels.
+        const int32 Pad = Options.Spread * Oversample;
+        const int32 Width = FMath::DivideAndRoundUp(int32(Bitmap.width) + 2 * Pad, Oversample) * Oversample;
+        const int32 Height = FMath::DivideAndRoundUp(int32(Bitmap.rows) + 2 * Pad, Oversample) * Oversample;
+        TArray<bool> Inside;
+        Inside.SetNumZeroed(Width * Height);
+        for (uint32 Row = 0; Row < Bitmap.rows; Row++)
+        {
+            const uint8* Source = Bitmap.buffer + Row * Bitmap.pitch;
+            for (uint32 Column = 0; Column < Bitmap.width; Column++)
+            {
+                Inside[(Row + Pad) * Width + Column + Pad] = Source[Column] >= 128;
+            }
+        }
+        TArray<bool> Outside;
+        Outside.SetNumUninitialized(Inside.Num());
+        for (int32 Index = 0; Index < Inside.Num(); Index++)
+        {
+            Outside[Index] = !Inside[Index];
+        }
+        TArray<float> ToInside;
+        TArray<float> ToOutside;
+        DistanceTransform(Inside, Width, Height, ToInside);
+        DistanceTransform(Outside, Width, Height, ToOutside);
+
+        Out.Glyph.Width = uint16(Width / Oversample);
+        Out.Glyph.Height = uint16(Height / Oversample);
+        Out.Glyph.BearingX = int16(FMath::FloorToInt(float(Slot->bitmap_left - Pad) / Oversample));
+        Out.Glyph.BearingY = int16(FMath::CeilToInt(float(Slot->bitmap_top + Pad) / Oversample));
+        Out.Pixels.SetNumUninitialized(Out.Glyph.Width * Out.Glyph.Height);
+        const float Scale = 127.0f / (Options.Spread * Oversample);
+        for (int32 Y = 0; Y < Out.Glyph.Height; Y++)
+        {
+            for (int32 X = 0; X < Out.Glyph.Width; X++)
+            {
+                const int32 Sample = (Y * Oversample + Oversample / 2) * Width + X * Oversample + Oversample / 2;
+                const float Signed = Inside[Sample] ? ToOutside[Sample] : -ToInside[Sample];
+                Out.Pixels[Y * Out.Glyph.Width + X] = uint8(FMath::Clamp(FMath::RoundToInt(128.0f + Signed * Scale), 0, 255));
+            }
+        }
+        return true;
+    }
+#endif
+}
+
+FArchive& operator<<(FArchive& Ar, FEFSdfGlyph& Glyph)
+{
+    Ar << Glyph.CodePoint << Glyph.X << Glyph.Y << Glyph.Width << Glyph.Height << Glyph.BearingX << Glyph.BearingY << Glyph.Advance;
+    return Ar;
+}
+
+bool FEFSdfAtlas::Build(const FString& FontFile, const TArray<uint32>& CodePoints, const FOptions& Options, const FString& OutputFile)
+{
+#if WITH_FREETYPE
+    EF_TRACE_SCOPE("EditorFont::BuildSdfAtlas");
+    TArray<uint8> Data;
+    if (!FFileHelper::LoadFileToArray(Data, *FontFile, FILEREAD_Silent)) { return false; }
+
+    // FreeType faces are not thread safe, every chunk opens its own over the shared file data.
+    const int32 NumChunks = FMath::Clamp(CodePoints.Num() / 64, 1, FPlatformMisc::NumberOfCoresIncludingHyperthreads());
+    const int32 ChunkSize = FMath::DivideAndRoundUp(CodePoints.Num(), NumChunks);
+    TArray<FRenderedGlyph> Rendered;
+    Rendered.SetNum(CodePoints.Num());
+    TArray<bool> bRendered;
+    bRendered.SetNumZeroed(CodePoints.Num());
+    ParallelFor(NumChunks, [&](int32 Chunk)
+        {
+            FT_Library Library = nullptr;
+            if (FT_Init_FreeType(&Library) != 0) { return; }
+            FT_Face Face = nullptr;
+            if (FT_New_Memory_Face(Library, Data.GetData(), Data.Num(), 0, &Face) == 0)
+            {
+                FT_Set_Pixel_Sizes(Face, 0, Options.EmSize * Options.Oversample);
+                const int32 End = FMath::Min(CodePoints.Num(), (Chunk + 1) * ChunkSize);
+                for (int32 Index = Chunk * ChunkSize; Index < End; Index++)
+                {
+                    bRendered[Index] = RenderGlyph(Face, CodePoints[Index], Options, Rendered[Index]);
+                }
+                FT_Done_Face(Face);
+            }
+            FT_Done_FreeType(Library);
+        });
+
+    TArray<FRenderedGlyph> Glyphs;
+    int64 TotalArea = 0;
+    for (int32 Index = 0; Index < Rendered.Num(); Index++)
+    {
+        if (!bRendered[Index]) { continue; }
+        TotalArea += int64(Rendered[Index].Glyph.Width) * Rendered[Index].Glyph.Height;
+        Glyphs.Add(MoveTemp(Rendered[Index]));
+    }
+    if (Glyphs.Num() == 0) { return false; }
+
+    // Shelf packing, widening the atlas for big CJK sets so it stays roughly square.
+    int32 AtlasWidth = Options.AtlasWidth;
+    while (TotalArea > int64(AtlasWidth) * AtlasWidth && AtlasWidth < 8192)
+    {
+        AtlasWidth *= 2;
+    }
+    int32 CursorX = 0;
+    int32 CursorY = 0;
+    int32 ShelfHeight = 0;
+    for (FRenderedGlyph& Entry : Glyphs)
+    {
+        if (CursorX + Entry.Glyph.Width > AtlasWidth)
+        {
+            CursorX = 0;
+            CursorY += ShelfHeight;
+            ShelfHeight = 0;
+        }
+        Entry.Glyph.X = uint16(CursorX);
+        Entry.Glyph.Y = uint16(CursorY);
+        CursorX += Entry.Glyph.Width;
+        ShelfHeight = FMath::Max<int32>(ShelfHeight, Entry.Glyph.Height);
+    }
+    const int32 AtlasHeight = CursorY + ShelfHeight;
+    if (AtlasHeight > MAX_uint16) { return false; }
+
+    TArray<uint8> Pixels;
+    Pixels.SetNumZeroed(AtlasWidth * AtlasHeight);
+    TArray<FEFSdfGlyph> Table;
+    Table.Reserve(Glyphs.Num());
+    for (const FRenderedGlyph& Entry : Glyphs)
+    {
+        for (int32 Row = 0; Row < Entry.Glyph.Height; Row++)
+        {
+            FMemory::Memcpy(&Pixels[(Entry.Glyph.Y + Row) * AtlasWidth + Entry.Glyph.X], &Entry.Pixels[Row * Entry.Glyph.Width], Entry.Glyph.Width);
+        }
+        Table.Add(Entry.Glyph);
+    }
+
+    TUniquePtr<FArchive> Writer(IFileManager::Get().CreateFileWriter(*OutputFile));
+    if (!Writer) { return false; }
+    uint32 Magic = AtlasMagic;
+    int32 Version = AtlasVersion;
+    int32 EmSize = Options.EmSize;
+    int32 Spread = Options.Spread;
+    int32 Width = AtlasWidth;
+    int32 Height = AtlasHeight;
+    *Writer << Magic << Version << EmSize << Spread << Width << Height;
+    *Writer << Table;
+    Writer->Serialize(Pixels.GetData(), Pixels.Num());
+    return Writer->Close();
+#else
+    UE_LOG(LogTemp, Warning, TEXT("SDF atlases need FreeType, which this build does not have."));
+    return false;
+#endif
+}
+
+TMap<FName, FString> FEFSdfAtlas::BuiltHashes;
+
+FString FEFSdfAtlas::GetOrBuild(const FString& FontFile, const TArray<uint32>& CodePoints, const FOptions& Options)
+{
+    return GetOrBuild(FontFile, FEFContentCache::HashFile(FontFile), CodePoints, Options);
+}
+
+FString FEFSdfAtlas::GetOrBuild(const FString& FontFile, const FString& FontHash, const TArray<uint32>& CodePoints, const FOptions& Options)
+{
+    FString Params = FString::Printf(TEXT("%d,%d,%d,%d:"), Options.EmSize, Options.Spread, Options.Oversample, Options.AtlasWidth);
+    for (uint32 CodePoint : CodePoints)
+    {
+        Params += FString::Printf(TEXT("%X,"), CodePoint);
+    }
+    const FString Key = FontHash + FEFContentCache::HashString(Params);
+    FEFContentCache& Cache = FEFContentCache::Get();
+    const FString Cached = Cache.Find(TEXT("Sdf"), Key, TEXT(".efsdf"));
+    if (!Cached.IsEmpty())
+    {
+        return Cached;
+    }
+    const FString Output = Cache.MakeStagingPath(TEXT(".efsdf"));
+    if (!Build(FontFile, CodePoints, Options, Output) || !Cache.Publish(TEXT("Sdf"), Key, TEXT(".efsdf"), Output))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No SDF atlas for %s"), *FontFile);
+        IFileManager::Get().Delete(*Output);
+        return FString();
+    }
+    UE_LOG(LogTemp, Log, TEXT("SDF atlas for %s: %d code points, %lld bytes"), *FPaths::GetCleanFilename(FontFile), CodePoints.Num(), IFileManager::Get().FileSize(*Cache.GetEntryPath(TEXT("Sdf"), Key, TEXT(".efsdf"))));
+    return Cache.GetEntryPath(TEXT("Sdf"), Key, TEXT(".efsdf"));
+}
+
+void FEFSdfAtlas::QueueForSlots(const UDevEditor* Settings)
+{
+    struct FSlotJob
+    {
+        FName Slot;
+        FString FontFile;
+        FString Culture;
+    };
+    TArray<FSlotJob> Jobs;
+    for (const FNameProperty* Slot : Settings->GetFontSlotProperties())
+    {
+        if (!Settings->IsFontSlotActive(Slot)) { continue; }
+        Jobs.Add({ Slot->GetFName(), Settings->GetInstalledFontPath(Slot), Slot->GetMetaData(TEXT("Culture")) });
+    }
+    FEFWorkQueue::Get().Enqueue(TEXT("Building SDF atlases"), [Jobs = MoveTemp(Jobs)](FEFWorkQueue::FProgress& Progress)
+        {
+            EF_TRACE_SCOPE("EditorFont::BuildSdfAtlases");
+            bool bSucceeded = true;
+            for (const FSlotJob& Job : Jobs)
+            {
+                // Every flush lands here, most of them after a change to one slot or none.
+                const FString FontHash = FEFContentCache::HashFile(Job.FontFile);
+                if (FontHash.IsEmpty() || BuiltHashes.FindRef(Job.Slot) == FontHash) { continue; }
+                // Basic Latin, Latin-1 and Latin Extended-A for every slot, plus the localization text for localized ones.
+                TSet<uint32> CodePointSet;
+                for (uint32 CodePoint = 0x20; CodePoint <= 0x7E; CodePoint++) { CodePointSet.Add(CodePoint); }
+                for (uint32 CodePoint = 0xA0; CodePoint <= 0x17F; CodePoint++) { CodePointSet.Add(CodePoint); }
+                if (!Job.Culture.IsEmpty())
+                {
+                    FEFSubsetter::CollectCultureCodePoints(Job.Culture, CodePointSet);
+                }
+                TArray<uint32> CodePoints = CodePointSet.Array();
+                CodePoints.Sort();
+                if (GetOrBuild(Job.FontFile, FontHash, CodePoints, FOptions()).IsEmpty())
+                {
+                    bSucceeded = false;
+                    continue;
+                }
+                BuiltHashes.Add(Job.Slot, FontHash);
+            }
+            return bSucceeded;
+        });
+}
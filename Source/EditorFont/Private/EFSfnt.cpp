@@ -0,0 +1,350 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFSfnt.h"
+
+
+namespace
+{
+    constexpr uint32 TagTtcf = FEFSfntReader::MakeTag('t', 't', 'c', 'f');
+    constexpr uint32 TagTrue = FEFSfntReader::MakeTag('t', 'r', 'u', 'e');
+    constexpr uint32 TagOtto = FEFSfntReader::MakeTag('O', 'T', 'T', 'O');
+    constexpr uint32 TagCmap = FEFSfntReader::MakeTag('c', 'm', 'a', 'p');
+    constexpr uint32 TagMaxp = FEFSfntReader::MakeTag('m', 'a', 'x', 'p');
+    constexpr uint32 TagOS2 = FEFSfntReader::MakeTag('O', 'S', '/', '2');
+    constexpr uint32 TagPost = FEFSfntReader::MakeTag('p', 'o', 's', 't');
+    constexpr uint32 TagName = FEFSfntReader::MakeTag('n', 'a', 'm', 'e');
+    constexpr uint32 TagHead = FEFSfntReader::MakeTag('h', 'e', 'a', 'd');
+    constexpr uint32 ChecksumMagic = 0xB1B0AFBA;
+
+    bool IsSfntVersion(uint32 Version)
+    {
+        return Version == 0x00010000 || Version == TagTrue || Version == TagOtto;
+    }
+}
+
+int32 FEFSfntReader::GetFaceCount(TConstArrayView<uint8> Data)
+{
+    if (Data.Num() < 12) { return 0; }
+    const uint32 Version = ReadU32(Data.GetData());
+    if (Version == TagTtcf)
+    {
+        const uint32 NumFonts = ReadU32(Data.GetData() + 8);
+        return (12 + uint64(NumFonts) * 4 <= uint64(Data.Num())) ? int32(NumFonts) : 0;
+    }
+    return IsSfntVersion(Version) ? 1 : 0;
+}
+
+bool FEFSfntReader::Open(TConstArrayView<uint8> Data, int32 FaceIndex)
+{
+    FileData = Data;
+    SfntVersion = 0;
+    Tables.Reset();
+
+    const int32 FaceCount = GetFaceCount(Data);
+    if (FaceIndex < 0 || FaceIndex >= FaceCount) { return false; }
+
+    uint64 DirectoryOffset = 0;
+    if (ReadU32(Data.GetData()) == TagTtcf)
+    {
+        DirectoryOffset = ReadU32(Data.GetData() + 12 + FaceIndex * 4);
+    }
+    if (DirectoryOffset + 12 > uint64(Data.Num())) { return false; }
+
+    const uint8* Directory = Data.GetData() + DirectoryOffset;
+    const uint32 Version = ReadU32(Directory);
+    const uint16 NumTables = ReadU16(Directory + 4);
+    if (!IsSfntVersion(Version) || DirectoryOffset + 12 + uint64(NumTables) * 16 > uint64(Data.Num())) { return false; }
+
+    Tables.Reserve(NumTables);
+    for (uint16 Index = 0; Index < NumTables; Index++)
+    {
+        const uint8* Record = Directory + 12 + Index * 16;
+        FTable Table;
+        Table.Tag = ReadU32(Record);
+        Table.Checksum = ReadU32(Record + 4);
+        Table.Offset = ReadU32(Record + 8);
+        Table.Length = ReadU32(Record + 12);
+        if (uint64(Table.Offset) + Table.Length > uint64(Data.Num()))
+        {
+            Tables.Reset();
+            return false;
+        }
+        Tables.Add(Table);
+    }
+    SfntVersion = Version;
+    return true;
+}
+
+const FEFSfntReader::FTable* FEFSfntReader::FindTable(uint32 Tag) const
+{
+    return Tables.FindByPredicate([Tag](const FTable& Table) { return Table.Tag == Tag; });
+}
+
+TConstArrayView<uint8> FEFSfntReader::GetTableData(uint32 Tag) const
+{
+    const FTable* Table = FindTable(Tag);
+    return Table ? FileData.Slice(Table->Offset, Table->Length) : TConstArrayView<uint8>();
+}
+
+int32 FEFSfntReader::GetGlyphCount() const
+{
+    TConstArrayView<uint8> Maxp = GetTableData(TagMaxp);
+    return Maxp.Num() >= 6 ? ReadU16(Maxp.GetData() + 4) : 0;
+}
+
+FEFSfntReader::FStyle FEFSfntReader::GetStyle() const
+{
+    FStyle Style;
+    TConstArrayView<uint8> OS2 = GetTableData(TagOS2);
+    if (OS2.Num() >= 64)
+    {
+        Style.WeightClass = ReadU16(OS2.GetData() + 4);
+        Style.WidthClass = FMath::Clamp<uint16>(ReadU16(OS2.GetData() + 6), 1, 9);
+        // fsSelection ITALIC or OBLIQUE.
+        const uint16 Selection = ReadU16(OS2.GetData() + 62);
+        Style.bItalic = (Selection & ((1 << 0) | (1 << 9))) != 0;
+    }
+    TConstArrayView<uint8> Post = GetTableData(TagPost);
+    if (Post.Num() >= 16)
+    {
+        Style.bFixedPitch = ReadU32(Post.GetData() + 12) != 0;
+        // Fonts without fsSelection bits still carry a slant angle.
+        Style.bItalic |= ReadU32(Post.GetData() + 4) != 0;
+    }
+    return Style;
+}
+
+FString FEFSfntReader::GetName(uint16 NameID) const
+{
+    TConstArrayView<uint8> Name = GetTableData(TagName);
+    if (Name.Num() < 6) { return FString(); }
+    const uint8* Base = Name.GetData();
+    const uint32 NameLength = Name.Num();
+    const uint16 Count = ReadU16(Base + 2);
+    const uint32 StringOffset = ReadU16(Base + 4);
+    if (6 + uint32(Count) * 12 > NameLength) { return FString(); }
+
+    FString MacName;
+    for (uint16 Index = 0; Index < Count; Index++)
+    {
+        const uint8* Record = Base + 6 + Index * 12;
+        const uint16 Platform = ReadU16(Record);
+        const uint16 Encoding = ReadU16(Record + 2);
+        if (ReadU16(Record + 6) != NameID) { continue; }
+        const uint32 Length = ReadU16(Record + 8);
+        const uint32 Offset = StringOffset + ReadU16(Record + 10);
+        if (Offset + Length > NameLength) { continue; }
+        const uint8* Text = Base + Offset;
+
+        if (Platform == 0 || (Platform == 3 && (Encoding == 1 || Encoding == 10)))
+        {
+            // UTF-16BE.
+            FString Result;
+            Result.Reserve(Length / 2);
+            for (uint32 Char = 0; Char + 1 < Length; Char += 2)
+            {
+                Result.AppendChar(TCHAR(ReadU16(Text + Char)));
+            }
+            return Result;
+        }
+        if (Platform == 1 && Encoding == 0 && MacName.IsEmpty())
+        {
+            for (uint32 Char = 0; Char < Length; Char++)
+            {
+                MacName.AppendChar(TCHAR(Text[Char]));
+            }
+        }
+    }
+    return MacName;
+}
+
+FString FEFSfntReader::GetFamilyName() const
+{
+    FString Family = GetName(16);
+    return Family.IsEmpty() ? GetName(1) : Family;
+}
+
+bool FEFSfntReader::ForEachMappedRange(TFunctionRef<void(uint32 First, uint32 Last)> Visitor) const
+{
+    TConstArrayView<uint8> Cmap = GetTableData(TagCmap);
+    if (Cmap.Num() < 4) { return false; }
+    const uint8* Base = Cmap.GetData();
+    const uint32 CmapLength = Cmap.Num();
+    const uint16 NumSubtables = ReadU16(Base + 2);
+    if (4 + uint32(NumSubtables) * 8 > CmapLength) { return false; }
+
+    // Prefer a full-repertoire format 12 table, fall back to the BMP format 4 one.
+    uint32 Format12 = 0;
+    uint32 Format4 = 0;
+    for (uint16 Index = 0; Index < NumSubtables; Index++)
+    {
+        const uint8* Record = Base + 4 + Index * 8;
+        const uint16 Platform = ReadU16(Record);
+        const uint16 Encoding = ReadU16(Record + 2);
+        const uint32 Offset = ReadU32(Record + 4);
+        if (Offset + 2 > CmapLength) { continue; }
+        const bool bUnicode = Platform == 0 || (Platform == 3 && (Encoding == 1 || Encoding == 10 || Encoding == 0));
+        if (!bUnicode) { continue; }
+        const uint16 Format = ReadU16(Base + Offset);
+        if (Format == 12 && Format12 == 0) { Format12 = Offset; }
+        if (Format == 4 && Format4 == 0) { Format4 = Offset; }
+    }
+
+    if (Format12 != 0 && Format12 + 16 <= CmapLength)
+    {
+        const uint8* Sub = Base + Format12;
+        const uint32 NumGroups = ReadU32(Sub + 12);
+        if (Format12 + 16 + uint64(NumGroups) * 12 > CmapLength) { return false; }
+        for (uint32 Group = 0; Group < NumGroups; Group++)
+        {
+            const uint8* Record = Sub + 16 + Group * 12;
+            uint32 First = ReadU32(Record);
+            const uint32 Last = FMath::Min<uint32>(ReadU32(Record + 4), 0x10FFFF);
+            // A group starting at glyph 0 maps its first code point to .notdef.
+            if (ReadU32(Record + 8) == 0) { First++; }
+            if (First <= Last) { Visitor(First, Last); }
+        }
+        return true;
+    }
+
+    if (Format4 != 0 && Format4 + 14 <= CmapLength)
+    {
+        const uint8* Sub = Base + Format4;
+        const uint32 SegCountX2 = ReadU16(Sub + 6);
+        const uint32 SegCount = SegCountX2 / 2;
+        const uint32 EndCodes = 14;
+        const uint32 StartCodes = EndCodes + SegCountX2 + 2;
+        const uint32 Deltas = StartCodes + SegCountX2;
+        const uint32 RangeOffsets = Deltas + SegCountX2;
+        const uint32 SubLength = CmapLength - Format4;
+        if (RangeOffsets + SegCountX2 > SubLength) { return false; }
+
+        for (uint32 Segment = 0; Segment < SegCount; Segment++)
+        {
+            const uint32 End = ReadU16(Sub + EndCodes + Segment * 2);
+            const uint32 Start = ReadU16(Sub + StartCodes + Segment * 2);
+            const uint16 Delta = ReadU16(Sub + Deltas + Segment * 2);
+            const uint32 RangeOffsetPos = RangeOffsets + Segment * 2;
+            const uint16 RangeOffset = ReadU16(Sub + RangeOffsetPos);
+
+            uint32 RunStart = 0;
+            bool bInRun = false;
+            for (uint32 CodePoint = Start; CodePoint <= End && CodePoint != 0xFFFF; CodePoint++)
+            {
+                uint16 Glyph = 0;
+                if (RangeOffset == 0)
+                {
+                    Glyph = uint16(CodePoint + Delta);
+                }
+                else
+                {
+                    const uint32 GlyphPos = RangeOffsetPos + RangeOffset + (CodePoint - Start) * 2;
+                    if (GlyphPos + 2 <= SubLength)
+                    {
+                        Glyph = ReadU16(Sub + GlyphPos);
+                        if (Glyph != 0) { Glyph = uint16(Glyph + Delta); }
+                    }
+                }
+                if (Glyph != 0 && !bInRun) { RunStart = CodePoint; bInRun = true; }
+                if (Glyph == 0 && bInRun) { Visitor(RunStart, CodePoint - 1); bInRun = false; }
+            }
+            if (bInRun) { Visitor(RunStart, FMath::Min<uint32>(End, 0xFFFE)); }
+        }
+        return true;
+    }
+    return false;
+}
+
+void FEFSfntWriter::WriteU16(uint8* Ptr, uint16 Value)
+{
+    Ptr[0] = uint8(Value >> 8);
+    Ptr[1] = uint8(Value);
+}
+
+void FEFSfntWriter::WriteU32(uint8* Ptr, uint32 Value)
+{
+    Ptr[0] = uint8(Value >> 24);
+    Ptr[1] = uint8(Value >> 16);
+    Ptr[2] = uint8(Value >> 8);
+    Ptr[3] = uint8(Value);
+}
+
+uint32 FEFSfntWriter::CalcChecksum(TConstArrayView<uint8> Data)
+{
+    uint32 Sum = 0;
+    for (int32 Offset = 0; Offset < Data.Num(); Offset += 4)
+    {
+        uint8 Word[4] = { 0, 0, 0, 0 };
+        FMemory::Memcpy(Word, Data.GetData() + Offset, FMath::Min(4, Data.Num() - Offset));
+        Sum += FEFSfntReader::ReadU32(Word);
+    }
+    return Sum;
+}
+
+void FEFSfntWriter::AddTable(uint32 Tag, TArray<uint8> Data)
+{
+    Tables.Emplace(Tag, MoveTemp(Data));
+}
+
+bool FEFSfntWriter::Write(FArchive& Out) const
+{
+    TArray<const TPair<uint32, TArray<uint8>>*> Sorted;
+    for (const TPair<uint32, TArray<uint8>>& Table : Tables)
+    {
+        Sorted.Add(&Table);
+    }
+    Sorted.Sort([](const TPair<uint32, TArray<uint8>>& A, const TPair<uint32, TArray<uint8>>& B) { return A.Key < B.Key; });
+    const int32 NumTables = Sorted.Num();
+
+    TArray<uint8> Directory;
+    Directory.SetNumZeroed(12 + NumTables * 16);
+    const uint16 EntrySelector = uint16(FMath::FloorLog2(uint32(FMath::Max(NumTables, 1))));
+    const uint16 SearchRange = uint16(16 << EntrySelector);
+    WriteU32(Directory.GetData(), SfntVersion);
+    WriteU16(Directory.GetData() + 4, uint16(NumTables));
+    WriteU16(Directory.GetData() + 6, SearchRange);
+    WriteU16(Directory.GetData() + 8, EntrySelector);
+    WriteU16(Directory.GetData() + 10, uint16(NumTables * 16 - SearchRange));
+
+    // head is summed with its checkSumAdjustment zeroed, then patched once the whole file is summed.
+    TArray<uint8> Head;
+    uint32 Offset = Directory.Num();
+    uint32 FileChecksum = 0;
+    for (int32 Index = 0; Index < NumTables; Index++)
+    {
+        const TPair<uint32, TArray<uint8>>& Table = *Sorted[Index];
+        uint32 Checksum = 0;
+        if (Table.Key == TagHead && Table.Value.Num() >= 12)
+        {
+            Head = Table.Value;
+            WriteU32(Head.GetData() + 8, 0);
+            Checksum = CalcChecksum(Head);
+        }
+        else
+        {
+            Checksum = CalcChecksum(Table.Value);
+        }
+        uint8* Record = Directory.GetData() + 12 + Index * 16;
+        WriteU32(Record, Table.Key);
+        WriteU32(Record + 4, Checksum);
+        WriteU32(Record + 8, Offset);
+        WriteU32(Record + 12, uint32(Table.Value.Num()));
+        Offset += Align(uint32(Table.Value.Num()), 4);
+        FileChecksum += Checksum;
+    }
+    FileChecksum += CalcChecksum(Directory);
+    if (Head.Num() >= 12)
+    {
+        WriteU32(Head.GetData() + 8, ChecksumMagic - FileChecksum);
+    }
+
+    Out.Serialize(Directory.GetData(), Directory.Num());
+    static const uint8 Padding[4] = { 0, 0, 0, 0 };
+    for (const TPair<uint32, TArray<uint8>>* Table : Sorted)
+    {
+        const TArray<uint8>& Data = (Table->Key == TagHead && Head.Num() > 0) ? Head : Table->Value;
+        Out.Serialize(const_cast<uint8*>(Data.GetData()), Data.Num());
+        Out.Serialize(const_cast<uint8*>(Padding), Align(Data.Num(), 4) - Data.Num());
+    }
+    return !Out.IsError();
+}
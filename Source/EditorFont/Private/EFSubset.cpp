@@ -0,0 +1,213 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFSubset.h"
+
+#include "EFContentCache.h"
+#include "EFTrace.h"
+#include "UDevEditor.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+
+
+void FEFSubsetter::AddString(const FString& Text, TSet<uint32>& OutCodePoints)
+{
+    for (int32 Index = 0; Index < Text.Len(); Index++)
+    {
+        uint32 CodePoint = Text[Index];
+        // TCHAR is UTF-16 on Windows, pair up surrogates.
+        if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF && Index + 1 < Text.Len())
+        {
+            const uint32 Low = Text[Index + 1];
+            if (Low >= 0xDC00 && Low <= 0xDFFF)
+            {
+                CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+                Index++;
+            }
+        }
+        OutCodePoints.Add(CodePoint);
+    }
+}
+
+void FEFSubsetter::CollectArchiveText(const TSharedPtr<FJsonObject>& Node, TSet<uint32>& OutCodePoints)
+{
+    if (!Node.IsValid()) { return; }
+    const TArray<TSharedPtr<FJsonValue>>* Children = nullptr;
+    if (Node->TryGetArrayField(TEXT("Children"), Children))
+    {
+        for (const TSharedPtr<FJsonValue>& Child : *Children)
+        {
+            const TSharedPtr<FJsonObject>* Translation = nullptr;
+            if (Child->AsObject()->TryGetObjectField(TEXT("Translation"), Translation))
+            {
+                AddString((*Translation)->GetStringField(TEXT("Text")), OutCodePoints);
+            }
+        }
+    }
+    const TArray<TSharedPtr<FJsonValue>>* Subnamespaces = nullptr;
+    if (Node->TryGetArrayField(TEXT("Subnamespaces"), Subnamespaces))
+    {
+        for (const TSharedPtr<FJsonValue>& Subnamespace : *Subnamespaces)
+        {
+            CollectArchiveText(Subnamespace->AsObject(), OutCodePoints);
+        }
+    }
+}
+
+void FEFSubsetter::CollectCultureCodePoints(const FString& Culture, TSet<uint32>& OutCodePoints)
+{
+    // Reading every archive takes a while, the result only changes with the engine install.
+    static FCriticalSection CacheMutex;
+    static TMap<FString, TSet<uint32>> CultureCache;
+    {
+        FScopeLock Lock(&CacheMutex);
+        if (const TSet<uint32>* Cached = CultureCache.Find(Culture))
+        {
+            OutCodePoints.Append(*Cached);
+            return;
+        }
+    }
+
+    EF_TRACE_SCOPE("EditorFont::CollectCultureCodePoints");
+    TSet<uint32> CodePoints;
+    TArray<FString> Archives;
+    IFileManager::Get().FindFilesRecursive(Archives, *(FPaths::EngineContentDir() / TEXT("Localization")), TEXT("*.archive"), true, false);
+    for (const FString& Archive : Archives)
+    {
+        const FString Folder = FPaths::GetCleanFilename(FPaths::GetPath(Archive));
+        if (Culture != TEXT("*") && !Folder.Equals(Culture, ESearchCase::IgnoreCase) && !Folder.StartsWith(Culture + TEXT("-"), ESearchCase::IgnoreCase))
+        {
+            continue;
+        }
+        FString Json;
+        TSharedPtr<FJsonObject> Root;
+        if (FFileHelper::LoadFileToString(Json, *Archive) && FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Json), Root))
+        {
+            CollectArchiveText(Root, CodePoints);
+        }
+    }
+    UE_LOG(LogTemp, Log, TEXT("Collected %d code points for culture %s"), CodePoints.Num(), *Culture);
+
+    FScopeLock Lock(&CacheMutex);
+    OutCodePoints.Append(CodePoints);
+    CultureCache.Add(Culture, MoveTemp(CodePoints));
+}
+
+bool FEFSubsetter::ParseRanges(const FString& Ranges, TSet<uint32>& OutCodePoints)
+{
+    auto ParseCodePoint = [](FString Token, uint32& OutValue) -> bool
+    {
+        Token.TrimStartAndEndInline();
+        if (Token.StartsWith(TEXT("U+"), ESearchCase::IgnoreCase) || Token.StartsWith(TEXT("0x"), ESearchCase::IgnoreCase))
+        {
+            Token.RightChopInline(2);
+        }
+        if (Token.IsEmpty()) { return false; }
+        for (TCHAR Char : Token)
+        {
+            if (!FChar::IsHexDigit(Char)) { return false; }
+        }
+        OutValue = FCString::Strtoui64(*Token, nullptr, 16);
+        return OutValue <= 0x10FFFF;
+    };
+
+    TArray<FString> Entries;
+    Ranges.ParseIntoArray(Entries, TEXT(","));
+    for (const FString& Entry : Entries)
+    {
+        FString Low = Entry;
+        FString High;
+        Entry.Split(TEXT("-"), &Low, &High);
+        uint32 First = 0;
+        uint32 Last = 0;
+        if (!ParseCodePoint(Low, First)) { return false; }
+        if (High.IsEmpty()) { Last = First; }
+        else if (!ParseCodePoint(High, Last) || Last < First) { return false; }
+        for (uint32 CodePoint = First; CodePoint <= Last; CodePoint++)
+        {
+            OutCodePoints.Add(CodePoint);
+        }
+    }
+    return true;
+}
+
+FEFSubsetter::FOptions FEFSubsetter::MakeOptions(const UDevEditor* Settings)
+{
+    FOptions Options;
+    Options.ExtraRanges = Settings->ExtraSubsetRanges;
+    Options.FontForgeExecutable = Settings->GetFontForgeExecutable();
+    Options.Script = Settings->GetFontForgeScript(TEXT("subset_font.py"));
+    return Options;
+}
+
+FString FEFSubsetter::SubsetFont(const FOptions& Options, const FString& SourceFont, const FString& Culture)
+{
+    EF_TRACE_SCOPE("EditorFont::SubsetFont");
+    TSet<uint32> CodePointSet;
+    CollectCultureCodePoints(Culture, CodePointSet);
+    // The engine ships no archive for some slot cultures (ar, th). Trimming to Basic Latin would strip the whole script.
+    bool bHasScript = false;
+    for (uint32 CodePoint : CodePointSet)
+    {
+        if (CodePoint > 0x7E) { bHasScript = true; break; }
+    }
+    if (!bHasScript)
+    {
+        UE_LOG(LogTemp, Log, TEXT("No localization text for culture %s, installing %s without subsetting"), *Culture, *FPaths::GetCleanFilename(SourceFont));
+        return SourceFont;
+    }
+    for (uint32 CodePoint = 0x20; CodePoint <= 0x7E; CodePoint++)
+    {
+        CodePointSet.Add(CodePoint);
+    }
+    if (!ParseRanges(Options.ExtraRanges, CodePointSet))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("ExtraSubsetRanges has a malformed entry and was partly ignored: %s"), *Options.ExtraRanges);
+    }
+
+    TArray<uint32> CodePoints = CodePointSet.Array();
+    CodePoints.Sort();
+    TArray<FString> Lines;
+    Lines.Reserve(CodePoints.Num());
+    for (uint32 CodePoint : CodePoints)
+    {
+        Lines.Add(FString::Printf(TEXT("%X"), CodePoint));
+    }
+    const FString Joined = FString::Join(Lines, TEXT("\n"));
+
+    const FString Extension = FPaths::GetExtension(SourceFont, true);
+    const FString Key = FEFContentCache::HashFile(SourceFont) + FEFContentCache::HashString(Joined);
+    FEFContentCache& Cache = FEFContentCache::Get();
+    const FString Cached = Cache.Find(TEXT("Subsets"), Key, Extension);
+    if (!Cached.IsEmpty())
+    {
+        return Cached;
+    }
+
+    const FString CodePointFile = Cache.MakeStagingPath(TEXT(".txt"));
+    const FString Output = Cache.MakeStagingPath(Extension);
+    if (!FFileHelper::SaveStringToFile(Joined, *CodePointFile))
+    {
+        return FString();
+    }
+    const FString Args = FString::Printf(TEXT("-lang=py -script \"%s\" \"%s\" \"%s\" \"%s\""), *Options.Script, *SourceFont, *Output, *CodePointFile);
+    const int32 ReturnCode = UDevEditor::LaunchAndCaptureProcessOutput(Options.FontForgeExecutable, Args, true);
+    IFileManager::Get().Delete(*CodePointFile);
+    if (ReturnCode != 0 || !FPaths::FileExists(Output))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FontForge failed to subset %s (exit code %d)"), *SourceFont, ReturnCode);
+        IFileManager::Get().Delete(*Output);
+        return FString();
+    }
+    UE_LOG(LogTemp, Warning, TEXT("Subset %s to %d code points: %lld -> %lld bytes"), *FPaths::GetCleanFilename(SourceFont), CodePoints.Num(),
+        IFileManager::Get().FileSize(*SourceFont), IFileManager::Get().FileSize(*Output));
+    if (!Cache.Publish(TEXT("Subsets"), Key, Extension, Output))
+    {
+        return FString();
+    }
+    return Cache.GetEntryPath(TEXT("Subsets"), Key, Extension);
+}
@@ -0,0 +1,274 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFTextBenchmark.h"
+
+#include "EFSfnt.h"
+#include "EFTrace.h"
+#include "UDevEditor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+#if WITH_FREETYPE
+THIRD_PARTY_INCLUDES_START
+#include "ft2build.h"
+#include FT_FREETYPE_H
+THIRD_PARTY_INCLUDES_END
+#endif
+
+#if WITH_HARFBUZZ
+THIRD_PARTY_INCLUDES_START
+#include "hb.h"
+#include "hb-ot.h"
+THIRD_PARTY_INCLUDES_END
+#endif
+
+
+namespace
+{
+    struct FCorpusLine
+    {
+        const TCHAR* Text;
+        /** Point size at 96 DPI, as the editor draws it. */
+        int32 Points;
+    };
+
+    // Output Log lines, Blueprint node titles, then the preview samples FEFDetails shows for the localized slots.
+    const FCorpusLine Corpus[] = {
+        { TEXT("LogTemp: Warning: Converting font to /Game/Fonts/Roboto-Regular.otf"), 9 },
+        { TEXT("LogBlueprintUserMessages: [BP_PlayerCharacter_C_0] Health: 87.500000 Ammo: 24/120"), 9 },
+        { TEXT("LogStreaming: Display: FlushAsyncLoading(412): 1 QueuedPackages, 0 AsyncPackages"), 9 },
+        { TEXT("[2024.06.14-09.41.27:318][  0]LogShaderCompilers: Display: Compiling shader autogen file: 0x7FFC1E2A"), 9 },
+        { TEXT("Event BeginPlay"), 10 },
+        { TEXT("Get Player Controller"), 10 },
+        { TEXT("Set Actor Location And Rotation"), 10 },
+        { TEXT("Cast To BP_ThirdPersonCharacter"), 10 },
+        { TEXT("Everyone has the right to freedom of font."), 9 },
+        { TEXT("لكل فرد الحق في حرية الخط."), 9 },
+        { TEXT("ทุกคนมีสิทธิในเสรีภาพในการใช้แบบอักษร"), 9 },
+    };
+
+    int32 PointsToPixels(int32 Points)
+    {
+        return FMath::RoundToInt(Points * 96.0f / 72.0f);
+    }
+
+    int64 SumTableBytes(const FEFSfntReader& Reader, std::initializer_list<uint32> Tags)
+    {
+        int64 Bytes = 0;
+        for (uint32 Tag : Tags)
+        {
+            Bytes += Reader.GetTableData(Tag).Num();
+        }
+        return Bytes;
+    }
+}
+
+FEFTextBenchmark::FEFTextBenchmark(UDevEditor* InSettings, const FOptions& InOptions)
+    : Settings(InSettings)
+    , Options(InOptions)
+{
+    if (Options.OutputDir.IsEmpty())
+    {
+        Options.OutputDir = FPaths::ProjectSavedDir() / TEXT("EditorFont/Benchmark");
+    }
+}
+
+TArray<FString> FEFTextBenchmark::GetCandidateFonts() const
+{
+    if (Options.Fonts.Num() == 0)
+    {
+        TArray<FString> Fonts = Settings->GetSlotFontPaths().Array();
+        Fonts.Sort();
+        return Fonts;
+    }
+    TArray<FString> Fonts;
+    for (const FString& Font : Options.Fonts)
+    {
+        if (Font.Equals(TEXT("Library"), ESearchCase::IgnoreCase))
+        {
+            Fonts.Append(Settings->GetFontLibrary());
+        }
+        else
+        {
+            Fonts.AddUnique(Settings->ResolveFontValue(FName(Font)));
+        }
+    }
+    return Fonts;
+}
+
+bool FEFTextBenchmark::Run(TSharedRef<FJsonObject> Report)
+{
+    TArray<TSharedPtr<FJsonValue>> Entries;
+    for (const FString& Font : GetCandidateFonts())
+    {
+        FFontResult Result;
+        if (!MeasureFont(Font, Result))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Could not shape with %s"), *Font);
+            continue;
+        }
+        UE_LOG(LogTemp, Display, TEXT("%s: %.0f glyphs/s shaped, %.0f glyphs/s rasterized, %lld atlas bytes"),
+            *FPaths::GetCleanFilename(Font), Result.Shape.Throughput(), Result.Raster.Throughput(), Result.AtlasBytes);
+        Entries.Add(MakeShared<FJsonValueObject>(ToJson(Result)));
+        Results.Add(MoveTemp(Result));
+    }
+    Report->SetArrayField(TEXT("results"), Entries);
+    WriteOutputs(Report);
+    return Results.Num() > 0;
+}
+
+bool FEFTextBenchmark::MeasureFont(const FString& Font, FFontResult& OutResult) const
+{
+    EF_TRACE_SCOPE("EditorFont::TextBenchmarkFont");
+    OutResult.Font = Font;
+    // Faces and pack members are measured as the standalone file a slot would install.
+    const FString Source = UDevEditor::ResolveFontSource(Font);
+    TArray<uint8> Data;
+    if (Source.IsEmpty() || !FFileHelper::LoadFileToArray(Data, *Source, FILEREAD_Silent)) { return false; }
+    FEFSfntReader Reader;
+    if (!Reader.Open(Data)) { return false; }
+    OutResult.FileBytes = Data.Num();
+    OutResult.GlyphCount = Reader.GetGlyphCount();
+    OutResult.LayoutBytes = SumTableBytes(Reader, { FEFSfntReader::MakeTag('G', 'D', 'E', 'F'), FEFSfntReader::MakeTag('G', 'S', 'U', 'B'), FEFSfntReader::MakeTag('G', 'P', 'O', 'S') });
+    OutResult.HintingBytes = SumTableBytes(Reader, { FEFSfntReader::MakeTag('f', 'p', 'g', 'm'), FEFSfntReader::MakeTag('p', 'r', 'e', 'p'), FEFSfntReader::MakeTag('c', 'v', 't', ' ') });
+
+#if WITH_HARFBUZZ && WITH_FREETYPE
+    hb_blob_t* Blob = hb_blob_create(reinterpret_cast<const char*>(Data.GetData()), Data.Num(), HB_MEMORY_MODE_READONLY, nullptr, nullptr);
+    hb_face_t* HbFace = hb_face_create(Blob, 0);
+    hb_font_t* HbFont = hb_font_create(HbFace);
+    hb_ot_font_set_funcs(HbFont);
+    hb_buffer_t* Buffer = hb_buffer_create();
+
+    // Converted once, the timed loop only shapes.
+    TArray<TArray<char>> Utf8Lines;
+    for (const FCorpusLine& Line : Corpus)
+    {
+        const FTCHARToUTF8 Converted(Line.Text);
+        Utf8Lines.Emplace(reinterpret_cast<const char*>(Converted.Get()), Converted.Length());
+    }
+
+    // Glyph id in the low bits, pixel size above: one atlas entry each.
+    TSet<uint64> UniqueGlyphs;
+    for (int32 Iteration = 0; Iteration < Options.Iterations; Iteration++)
+    {
+        int32 ShapedGlyphs = 0;
+        const double Start = FPlatformTime::Seconds();
+        for (int32 Index = 0; Index < UE_ARRAY_COUNT(Corpus); Index++)
+        {
+            const int32 Pixels = PointsToPixels(Corpus[Index].Points);
+            hb_font_set_scale(HbFont, Pixels * 64, Pixels * 64);
+            hb_font_set_ppem(HbFont, Pixels, Pixels);
+            hb_buffer_clear_contents(Buffer);
+            hb_buffer_add_utf8(Buffer, Utf8Lines[Index].GetData(), Utf8Lines[Index].Num(), 0, Utf8Lines[Index].Num());
+            hb_buffer_guess_segment_properties(Buffer);
+            hb_shape(HbFont, Buffer, nullptr, 0);
+            unsigned int NumGlyphs = 0;
+            const hb_glyph_info_t* Infos = hb_buffer_get_glyph_infos(Buffer, &NumGlyphs);
+            ShapedGlyphs += int32(NumGlyphs);
+            if (Iteration == 0)
+            {
+                for (unsigned int Glyph = 0; Glyph < NumGlyphs; Glyph++)
+                {
+                    UniqueGlyphs.Add((uint64(Pixels) << 32) | Infos[Glyph].codepoint);
+                }
+            }
+        }
+        OutResult.Shape.SamplesMs.Add((FPlatformTime::Seconds() - Start) * 1000.0);
+        OutResult.ShapedGlyphs = ShapedGlyphs;
+    }
+    hb_buffer_destroy(Buffer);
+    hb_font_destroy(HbFont);
+    hb_face_destroy(HbFace);
+    hb_blob_destroy(Blob);
+
+    FT_Library Library = nullptr;
+    FT_Face Face = nullptr;
+    if (FT_Init_FreeType(&Library) != 0) { return false; }
+    if (FT_New_Memory_Face(Library, Data.GetData(), Data.Num(), 0, &Face) != 0)
+    {
+        FT_Done_FreeType(Library);
+        return false;
+    }
+    TArray<uint64> Glyphs = UniqueGlyphs.Array();
+    // Sorted by size, so the face is resized once per size, as Slate's per-size caches do.
+    Glyphs.Sort();
+    OutResult.UniqueGlyphs = Glyphs.Num();
+    for (int32 Iteration = 0; Iteration < Options.Iterations; Iteration++)
+    {
+        int64 AtlasBytes = 0;
+        uint32 CurrentPixels = 0;
+        const double Start = FPlatformTime::Seconds();
+        for (uint64 Glyph : Glyphs)
+        {
+            const uint32 Pixels = uint32(Glyph >> 32);
+            if (Pixels != CurrentPixels)
+            {
+                FT_Set_Pixel_Sizes(Face, 0, Pixels);
+                CurrentPixels = Pixels;
+            }
+            if (FT_Load_Glyph(Face, FT_UInt(Glyph & 0xFFFFFFFF), FT_LOAD_DEFAULT | FT_LOAD_NO_BITMAP) != 0) { continue; }
+            if (FT_Render_Glyph(Face->glyph, FT_RENDER_MODE_NORMAL) != 0) { continue; }
+            const FT_Bitmap& Bitmap = Face->glyph->bitmap;
+            if (Bitmap.width > 0 && Bitmap.rows > 0)
+            {
+                AtlasBytes += int64(Bitmap.width + 2) * int64(Bitmap.rows + 2);
+            }
+        }
+        OutResult.Raster.SamplesMs.Add((FPlatformTime::Seconds() - Start) * 1000.0);
+        OutResult.AtlasBytes = AtlasBytes;
+    }
+    FT_Done_Face(Face);
+    FT_Done_FreeType(Library);
+
+    OutResult.Shape.Path = TEXT("Shape");
+    OutResult.Shape.ItemsPerSample = OutResult.ShapedGlyphs;
+    OutResult.Raster.Path = TEXT("Raster");
+    OutResult.Raster.ItemsPerSample = OutResult.UniqueGlyphs;
+    return true;
+#else
+    UE_LOG(LogTemp, Error, TEXT("The text benchmark needs HarfBuzz and FreeType."));
+    return false;
+#endif
+}
+
+TSharedRef<FJsonObject> FEFTextBenchmark::ToJson(const FFontResult& Result) const
+{
+    TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+    Entry->SetStringField(TEXT("font"), Result.Font);
+    Entry->SetNumberField(TEXT("fileBytes"), Result.FileBytes);
+    Entry->SetNumberField(TEXT("glyphCount"), Result.GlyphCount);
+    Entry->SetNumberField(TEXT("layoutBytes"), Result.LayoutBytes);
+    Entry->SetNumberField(TEXT("hintingBytes"), Result.HintingBytes);
+    Entry->SetNumberField(TEXT("shapedGlyphs"), Result.ShapedGlyphs);
+    Entry->SetNumberField(TEXT("uniqueGlyphs"), Result.UniqueGlyphs);
+    Entry->SetNumberField(TEXT("atlasBytes"), Result.AtlasBytes);
+    Entry->SetNumberField(TEXT("shapeP50Ms"), Result.Shape.Percentile(0.50));
+    Entry->SetNumberField(TEXT("shapeP95Ms"), Result.Shape.Percentile(0.95));
+    Entry->SetNumberField(TEXT("shapeGlyphsPerSec"), Result.Shape.Throughput());
+    Entry->SetNumberField(TEXT("rasterP50Ms"), Result.Raster.Percentile(0.50));
+    Entry->SetNumberField(TEXT("rasterP95Ms"), Result.Raster.Percentile(0.95));
+    Entry->SetNumberField(TEXT("rasterGlyphsPerSec"), Result.Raster.Throughput());
+    return Entry;
+}
+
+void FEFTextBenchmark::WriteOutputs(TSharedRef<FJsonObject> Report) const
+{
+    TArray<FString> Csv;
+    Csv.Add(TEXT("font,fileBytes,glyphCount,layoutBytes,hintingBytes,shapedGlyphs,uniqueGlyphs,atlasBytes,shapeP50Ms,shapeP95Ms,shapeGlyphsPerSec,rasterP50Ms,rasterP95Ms,rasterGlyphsPerSec"));
+    for (const FFontResult& Result : Results)
+    {
+        Csv.Add(FString::Printf(TEXT("\"%s\",%lld,%d,%lld,%lld,%d,%d,%lld,%.4f,%.4f,%.0f,%.4f,%.4f,%.0f"), *Result.Font, Result.FileBytes, Result.GlyphCount,
+            Result.LayoutBytes, Result.HintingBytes, Result.ShapedGlyphs, Result.UniqueGlyphs, Result.AtlasBytes,
+            Result.Shape.Percentile(0.50), Result.Shape.Percentile(0.95), Result.Shape.Throughput(),
+            Result.Raster.Percentile(0.50), Result.Raster.Percentile(0.95), Result.Raster.Throughput()));
+    }
+    FFileHelper::SaveStringArrayToFile(Csv, *(Options.OutputDir / TEXT("text.csv")));
+
+    FString Json;
+    FJsonSerializer::Serialize(Report, TJsonWriterFactory<>::Create(&Json));
+    FFileHelper::SaveStringToFile(Json, *(Options.OutputDir / TEXT("text.json")));
+    UE_LOG(LogTemp, Display, TEXT("Text benchmark results written to %s"), *Options.OutputDir);
+}
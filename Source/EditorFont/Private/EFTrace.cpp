@@ -0,0 +1,10 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFTrace.h"
+
+UE_TRACE_CHANNEL_DEFINE(EditorFontChannel);
+
+TRACE_DECLARE_INT_COUNTER(EditorFont_BytesCopied, TEXT("EditorFont/BytesCopied"));
+TRACE_DECLARE_INT_COUNTER(EditorFont_FilesTouched, TEXT("EditorFont/FilesTouched"));
+TRACE_DECLARE_INT_COUNTER(EditorFont_ConversionsInFlight, TEXT("EditorFont/ConversionsInFlight"));
+TRACE_DECLARE_INT_COUNTER(EditorFont_FlushCount, TEXT("EditorFont/FlushCount"));
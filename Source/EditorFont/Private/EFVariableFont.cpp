@@ -0,0 +1,97 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFVariableFont.h"
+
+#include "EFContentCache.h"
+#include "EFTrace.h"
+#include "UDevEditor.h"
+#include "Dom/JsonObject.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+
+FEFVariableFont::FOptions FEFVariableFont::MakeOptions(const UDevEditor* Settings)
+{
+    FOptions Options;
+    Options.Python = Settings->GetFontForgePython();
+    Options.Script = Settings->GetFontForgeScript(TEXT("instance_variable_font.py"));
+    return Options;
+}
+
+bool FEFVariableFont::GenerateInstances(const FOptions& Options, const FString& SourceFont, const TArray<FString>& Specs, TArray<FString>& OutPaths)
+{
+    EF_TRACE_SCOPE("EditorFont::GenerateInstances");
+    // One entry per spec on every return, callers index it by slot.
+    OutPaths.Init(FString(), Specs.Num());
+    FEFContentCache& Cache = FEFContentCache::Get();
+    const FString Extension = FPaths::GetExtension(SourceFont, true);
+    const FString SourceHash = FEFContentCache::HashFile(SourceFont);
+
+    // Several slots may ask for the same spec, each one is built once.
+    TMap<FString, FString> Built;
+    TMap<FString, TPair<FString, FString>> Pending;
+    TArray<TSharedPtr<FJsonValue>> Jobs;
+    for (const FString& Spec : TSet<FString>(Specs))
+    {
+        const FString Key = SourceHash + FEFContentCache::HashString(Spec);
+        const FString Cached = Cache.Find(TEXT("Instances"), Key, Extension);
+        if (!Cached.IsEmpty())
+        {
+            Built.Add(Spec, Cached);
+            continue;
+        }
+        const FString Output = Cache.MakeStagingPath(Extension);
+        Pending.Add(Spec, TPair<FString, FString>(Key, Output));
+
+        TSharedRef<FJsonObject> Job = MakeShared<FJsonObject>();
+        Job->SetStringField(TEXT("output"), Output);
+        Job->SetStringField(TEXT("spec"), Spec);
+        Jobs.Add(MakeShared<FJsonValueObject>(Job));
+    }
+
+    if (Jobs.Num() > 0)
+    {
+        FString JobsJson;
+        TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&JobsJson);
+        FJsonSerializer::Serialize(Jobs, Writer);
+        const FString JobsFile = Cache.MakeStagingPath(TEXT(".json"));
+        if (!FFileHelper::SaveStringToFile(JobsJson, *JobsFile))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Could not write the instance jobs. %s"), *JobsFile);
+            return false;
+        }
+
+        // One run parses the outlines once and writes every missing instance.
+        const FString Args = FString::Printf(TEXT("\"%s\" \"%s\" \"%s\""), *Options.Script, *SourceFont, *JobsFile);
+        const int32 ReturnCode = UDevEditor::LaunchAndCaptureProcessOutput(Options.Python, Args, true);
+        IFileManager::Get().Delete(*JobsFile);
+        if (ReturnCode == 2)
+        {
+            UE_LOG(LogTemp, Error, TEXT("Variable fonts need fontTools in the FontForge Python: ffpython -m pip install fonttools"));
+        }
+
+        for (const TPair<FString, TPair<FString, FString>>& Job : Pending)
+        {
+            const FString& Key = Job.Value.Key;
+            const FString& Output = Job.Value.Value;
+            if (!FPaths::FileExists(Output) || !Cache.Publish(TEXT("Instances"), Key, Extension, Output))
+            {
+                UE_LOG(LogTemp, Error, TEXT("No instance %s of %s (exit code %d)"), *Job.Key, *SourceFont, ReturnCode);
+                IFileManager::Get().Delete(*Output);
+                continue;
+            }
+            Built.Add(Job.Key, Cache.GetEntryPath(TEXT("Instances"), Key, Extension));
+        }
+    }
+
+    bool bAllBuilt = true;
+    for (int32 Index = 0; Index < Specs.Num(); Index++)
+    {
+        OutPaths[Index] = Built.FindRef(Specs[Index]);
+        bAllBuilt &= !OutPaths[Index].IsEmpty();
+    }
+    return bAllBuilt;
+}
@@ -0,0 +1,251 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFWorkQueue.h"
+
+#include "DebugHeader.h"
+#include "EFTrace.h"
+#include "Async/Async.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Framework/Notifications/NotificationManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/App.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/Timespan.h"
+
+
+namespace
+{
+    // Quick jobs finish without a notification popping up and going away again.
+    constexpr double NotifyAfterSeconds = 0.3;
+    // Text updates re-layout the notification, a few per second reads as live.
+    constexpr double NotifyIntervalSeconds = 0.25;
+    constexpr int32 MaxListedFailures = 5;
+}
+
+void FEFWorkQueue::FProgress::CompleteItem(bool bSucceeded, const FString& Name)
+{
+    if (!bSucceeded)
+    {
+        FScopeLock Lock(&FailureMutex);
+        Failures.Add(Name);
+        ItemsFailed++;
+    }
+    ItemsDone++;
+}
+
+TArray<FString> FEFWorkQueue::FProgress::GetFailures() const
+{
+    FScopeLock Lock(&FailureMutex);
+    return Failures;
+}
+
+FEFWorkQueue& FEFWorkQueue::Get()
+{
+    static FEFWorkQueue Queue;
+    return Queue;
+}
+
+bool FEFWorkQueue::RunsInBackground()
+{
+    return !IsRunningCommandlet() && !FApp::IsUnattended();
+}
+
+void FEFWorkQueue::Enqueue(const FString& Label, TUniqueFunction<bool(FProgress&)> Work, TUniqueFunction<void(bool)> OnComplete)
+{
+    check(IsInGameThread());
+    if (!RunsInBackground())
+    {
+        FProgress Progress;
+        const double Start = FPlatformTime::Seconds();
+        const bool bSucceeded = Work(Progress);
+        if (Progress.ItemsTotal > 0)
+        {
+            UE_LOG(LogTemp, Log, TEXT("%s"), *FormatProgress(Label, Progress, FPlatformTime::Seconds() - Start, true).ToString());
+        }
+        if (OnComplete) { OnComplete(bSucceeded); }
+        return;
+    }
+    TUniquePtr<FJob> Job = MakeUnique<FJob>();
+    Job->Label = Label;
+    Job->Work = MoveTemp(Work);
+    Job->OnComplete = MoveTemp(OnComplete);
+    Pending.Add(MoveTemp(Job));
+    EnsureTicker();
+    StartNext();
+}
+
+void FEFWorkQueue::PostToGameThread(TUniqueFunction<void()> Callback)
+{
+    if (IsInGameThread())
+    {
+        Callback();
+        return;
+    }
+    Completions.Enqueue(MoveTemp(Callback));
+}
+
+void FEFWorkQueue::Notify(const FString& Message, bool bSuccess)
+{
+    PostToGameThread([Message, bSuccess]()
+        {
+            DebugHeader::ShowNotifyInfo(Message, bSuccess ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+        });
+}
+
+bool FEFWorkQueue::IsBusy() const
+{
+    return Running.IsValid() || Pending.Num() > 0;
+}
+
+void FEFWorkQueue::EnsureTicker()
+{
+    if (!TickerHandle.IsValid())
+    {
+        TickerHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateRaw(this, &FEFWorkQueue::Tick));
+    }
+}
+
+void FEFWorkQueue::StartNext()
+{
+    if (Running.IsValid() || bCompleting || Pending.Num() == 0) { return; }
+    Running = MoveTemp(Pending[0]);
+    Pending.RemoveAt(0);
+    RunningProgress = MakeShared<FProgress>();
+    RunningSince = FPlatformTime::Seconds();
+    Async(EAsyncExecution::ThreadPool, [this, Work = MoveTemp(Running->Work), Progress = RunningProgress.ToSharedRef(), Label = Running->Label]() mutable
+        {
+            EF_TRACE_SCOPE("EditorFont::WorkQueueJob");
+            const bool bSucceeded = Work(*Progress);
+            UE_LOG(LogTemp, Log, TEXT("%s finished on a worker (%s)"), *Label, bSucceeded ? TEXT("ok") : TEXT("failed"));
+            Completions.Enqueue([this, bSucceeded]() { FinishRunning(bSucceeded); });
+        });
+}
+
+void FEFWorkQueue::FinishRunning(bool bSucceeded)
+{
+    TUniquePtr<FJob> Job = MoveTemp(Running);
+    const TSharedPtr<FProgress> Progress = MoveTemp(RunningProgress);
+    const FText Summary = FormatProgress(Job->Label, *Progress, FPlatformTime::Seconds() - RunningSince, true);
+    if (Progress->ItemsTotal > 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("%s"), *Summary.ToString());
+    }
+    if (Notification.IsValid())
+    {
+        Notification->SetText(Summary);
+        Notification->SetCompletionState(bSucceeded ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+        Notification->ExpireAndFadeout();
+        Notification.Reset();
+    }
+    else if (Progress->ItemsTotal > 1)
+    {
+        // A batch always ends with its one summary, even when it was too quick for a progress notification.
+        DebugHeader::ShowNotifyInfo(Summary.ToString(), bSucceeded ? SNotificationItem::CS_Success : SNotificationItem::CS_Fail);
+    }
+    // The completion runs before the next job starts, so its flush and snapshot never race a job writing the same files.
+    // Work it queues lands behind whatever was already pending.
+    if (Job->OnComplete)
+    {
+        TGuardValue<bool> Completing(bCompleting, true);
+        Job->OnComplete(bSucceeded);
+    }
+    StartNext();
+}
+
+void FEFWorkQueue::DrainCompletions()
+{
+    TUniqueFunction<void()> Callback;
+    while (Completions.Dequeue(Callback))
+    {
+        Callback();
+    }
+}
+
+void FEFWorkQueue::UpdateNotification()
+{
+    if (!Running.IsValid() || !FSlateApplication::IsInitialized()) { return; }
+    if (!Notification.IsValid())
+    {
+        if (FPlatformTime::Seconds() - RunningSince < NotifyAfterSeconds) { return; }
+        FNotificationInfo Info(FText::FromString(Running->Label));
+        Info.bFireAndForget = false;
+        Info.bUseLargeFont = true;
+        Info.FadeOutDuration = 1.0f;
+        Notification = FSlateNotificationManager::Get().AddNotification(Info);
+        if (!Notification.IsValid()) { return; }
+        Notification->SetCompletionState(SNotificationItem::CS_Pending);
+        LastNotifyUpdate = 0.0;
+    }
+    const double Now = FPlatformTime::Seconds();
+    if (Now - LastNotifyUpdate < NotifyIntervalSeconds) { return; }
+    LastNotifyUpdate = Now;
+    Notification->SetText(FormatProgress(Running->Label, *RunningProgress, Now - RunningSince, false));
+}
+
+FText FEFWorkQueue::FormatProgress(const FString& Label, const FProgress& Progress, double Elapsed, bool bFinished)
+{
+    const int32 ItemsTotal = Progress.ItemsTotal;
+    if (ItemsTotal > 0)
+    {
+        const int32 Done = FMath::Min<int32>(Progress.ItemsDone, ItemsTotal);
+        const int32 Failed = Progress.ItemsFailed;
+        if (bFinished)
+        {
+            FString Summary = FString::Printf(TEXT("%s: %d of %d done in %.1f s"), *Label, Done - Failed, ItemsTotal, Elapsed);
+            if (Failed > 0)
+            {
+                const TArray<FString> Failures = Progress.GetFailures();
+                Summary += FString::Printf(TEXT(", %d failed: %s"), Failed, *FString::Join(TArrayView<const FString>(Failures).Left(MaxListedFailures), TEXT(", ")));
+                if (Failures.Num() > MaxListedFailures) { Summary += FString::Printf(TEXT(" and %d more"), Failures.Num() - MaxListedFailures); }
+            }
+            return FText::FromString(Summary);
+        }
+        const double Rate = Elapsed > 0.0 ? Done / Elapsed : 0.0;
+        FString Line = FString::Printf(TEXT("%s: %d of %d"), *Label, Done, ItemsTotal);
+        if (Failed > 0) { Line += FString::Printf(TEXT(", %d failed"), Failed); }
+        if (Rate > 0.0)
+        {
+            Line += FString::Printf(TEXT(" (%.1f/s, %s left)"), Rate, *FTimespan::FromSeconds((ItemsTotal - Done) / Rate).ToString(TEXT("%m:%s")));
+        }
+        return FText::FromString(Line);
+    }
+    const int64 BytesTotal = Progress.BytesTotal;
+    if (BytesTotal > 0 && !bFinished)
+    {
+        const int64 Done = FMath::Min<int64>(Progress.BytesDone, BytesTotal);
+        return FText::Format(INVTEXT("{0}: {1} of {2}"), FText::FromString(Label), FText::AsMemory(Done), FText::AsMemory(BytesTotal));
+    }
+    return FText::FromString(Label);
+}
+
+bool FEFWorkQueue::Tick(float DeltaTime)
+{
+    DrainCompletions();
+    UpdateNotification();
+    if (!IsBusy() && Completions.IsEmpty())
+    {
+        TickerHandle.Reset();
+        return false;
+    }
+    return true;
+}
+
+void FEFWorkQueue::Flush()
+{
+    check(IsInGameThread());
+    while (IsBusy() || !Completions.IsEmpty())
+    {
+        DrainCompletions();
+        if (!Running.IsValid() && Pending.Num() > 0)
+        {
+            // Flushing from a completion, the next job has not been started yet and nothing else will start it.
+            TGuardValue<bool> Flushing(bCompleting, false);
+            StartNext();
+        }
+        if (Running.IsValid())
+        {
+            FPlatformProcess::Sleep(0.001f);
+        }
+    }
+}
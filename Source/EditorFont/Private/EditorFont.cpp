@@ -1,11 +1,17 @@
 // Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
 
 #include "EditorFont.h"
+#include "EFConfigWriter.h"
+#include "EFFontStats.h"
+#include "EFTrace.h"
+#include "EFWorkQueue.h"
 #include "Widgets/Layout/SWidgetSwitcher.h"
 #include <Widgets/Layout/SBox.h>
+#include "Widgets/Layout/SExpandableArea.h"
 
 #include "ISettingsModule.h"
 #include "LevelEditor.h"
+#include "Misc/MessageDialog.h"
 #include "Misc/OutputDeviceNull.h"
 
 
@@ -37,6 +43,10 @@ void FEditorFontModule::StartupModule()
 	EditMenuExtender = MakeShareable(new FExtender());
 	EditMenuExtender->AddMenuExtension(	"EditMain",EExtensionHook::After, nullptr, FMenuExtensionDelegate::CreateRaw(this, &FEditorFontModule::AddEditMenuExtension));
 	LevelEditorModule.GetMenuExtensibilityManager()->AddExtender(EditMenuExtender);
+	// The composite backend only changes memory, rebind before the editor's fonts are first loaded.
+	GetMutableDefault<UDevEditor>()->ApplyCompositeFontBindings();
+	// Baseline for the first undo. Skipped when the slots still match the last snapshot.
+	GetMutableDefault<UDevEditor>()->RecordFontSnapshot(TEXT("Startup"));
 }
 
 
@@ -65,6 +75,9 @@ void FEditorFontModule::ShutdownModule()
 	//{
 	//	SettingsModule->UnregisterSettings("Editor", "Plugins", "Setting");
 	//}
+	// Font copies still queued must land before the config that names them.
+	FEFWorkQueue::Get().Flush();
+	FEFConfigWriter::Get().Flush();
 	MyUnregisterSettings();
 }
 
@@ -94,6 +107,7 @@ FReply FEditorFontModule::OnNewButtonClicked() const
 	GConfig->Flush(bRead, GEditorLayoutIni);
 
 	//Request the editor to rebuild Slate
+	EF_TRACE_SCOPE("EditorFont::RecreateMainFrame");
 	IMainFrameModule& MainFrameModule = FModuleManager::LoadModuleChecked<IMainFrameModule>(TEXT("MainFrame"));
 	MainFrameModule.RecreateDefaultMainFrame(false, false);
 	return FReply::Handled();
@@ -348,6 +362,69 @@ void FEFDetails::CustomizeDetails(IDetailLayoutBuilder& DetailBuilder)
 		if (bIsJapaneseFont){SampleText=LOCTEXT("EditorFontText_JP", "誰もがフォントの自由に対する権利を有します。");}
 		if (bIsKorean){SampleText=LOCTEXT("EditorFontText_KO", "모든 사람은 글꼴의 자유를 누릴 권리가 있습니다.");}
 		FString DestFontPath = propHandle->GetBoolMetaData("AlternateFont") ? FPaths::EngineContentDir() / TEXT("Editor/Slate/Fonts/") : FPaths::EngineContentDir() / TEXT("Slate/Fonts/");
+		// Localized faces are large. Their previews are only built once the row is expanded, or up front when the editor runs in that language.
+		auto MakePreview = [MyDevSettings, propHandle, SampleText, bIsArabicFont, DestFontPath, PropFileName]() -> TSharedRef<SWidget>
+			{
+				return SNew(SHorizontalBox)
+					+ SHorizontalBox::Slot()
+					[
+						SNew(STextBlock)
+							.Text(SampleText)
+							.Justification(ETextJustify::InvariantLeft)
+							.TextFlowDirection(bIsArabicFont ? ETextFlowDirection::RightToLeft : ETextFlowDirection::LeftToRight)
+							.Margin(FMargin(20.0f, 0.0f, 0.0f, 0.0f))
+							.Font(FSlateFontInfo(DestFontPath / PropFileName, 8))
+					]
+					+ SHorizontalBox::Slot()
+					.AutoWidth()
+					.Padding(FMargin(10.0f, 0.0f, 0.0f, 0.0f))
+					[
+						SNew(STextBlock)
+							.ToolTipText(INVTEXT("File size, glyph count, memory the face holds once Slate loads it, and the time to read and open it."))
+							.ColorAndOpacity(FSlateColor::UseSubduedForeground())
+							.Text_Lambda([MyDevSettings, propHandle]()
+								{
+									// Runs on every paint, so the measurement is queued and the row picks it up once it lands.
+									FEFFontStatsEntry Stats;
+									if (!FEFFontStats::Get().FindOrRequestStats(MyDevSettings->GetInstalledFontPath(propHandle->GetProperty()), Stats))
+									{
+										return INVTEXT("Measuring...");
+									}
+									if (!Stats.bValid)
+									{
+										return INVTEXT("Not installed");
+									}
+									FNumberFormattingOptions Ms;
+									Ms.SetMaximumFractionalDigits(1);
+									return FText::Format(INVTEXT("{0}  |  {1} glyphs  |  {2} resident  |  {3} ms"),
+										FText::AsMemory(Stats.FileBytes), FText::AsNumber(Stats.GlyphCount), FText::AsMemory(Stats.GetResidentBytes()), FText::AsNumber(Stats.LoadMs, &Ms));
+								})
+					];
+			};
+		TSharedRef<SWidget> Preview = SNullWidget::NullWidget;
+		if (MyDevSettings->IsFontSlotActive(propHandle->GetProperty()))
+		{
+			Preview = MakePreview();
+		}
+		else
+		{
+			TSharedRef<SBox> PreviewBox = SNew(SBox);
+			Preview = SNew(SExpandableArea)
+				.InitiallyCollapsed(true)
+				.AreaTitle(INVTEXT("Preview"))
+				.OnAreaExpansionChanged_Lambda([PreviewBox, MakePreview, bBuilt = MakeShared<bool>(false)](bool bExpanded)
+					{
+						if (bExpanded && !*bBuilt)
+						{
+							*bBuilt = true;
+							PreviewBox->SetContent(MakePreview());
+						}
+					})
+				.BodyContent()
+				[
+					PreviewBox
+				];
+		}
 		DetailBuilder.EditCategory("Fonts").AddProperty(propHandle)
 			.CustomWidget()
 			.NameContent()
@@ -425,20 +502,288 @@ void FEFDetails::CustomizeDetails(IDetailLayoutBuilder& DetailBuilder)
 			]
 			.ExtensionContent()
 			[
-				SNew(SHorizontalBox)
-					+ SHorizontalBox::Slot()
-					[
-						SNew(STextBlock)
-							.Text(SampleText)
-							.Justification(ETextJustify::InvariantLeft)
-							.TextFlowDirection(bIsArabicFont ? ETextFlowDirection::RightToLeft : ETextFlowDirection::LeftToRight)
-							.Margin(FMargin(20.0f, 0.0f, 0.0f, 0.0f))
-							.Font(FSlateFontInfo(DestFontPath / PropFileName, 8))
-					]
+				Preview
 			];
 	}
 
 
+	/// Font memory total against the budget
+	DetailBuilder.EditCategory("Fonts")
+		.AddCustomRow(FText::FromString("Font memory"))
+		.NameContent()
+		[
+			SNew(STextBlock)
+				.Text(FText::FromString("Font memory"))
+				.ToolTipText(INVTEXT("Resident memory of the slot fonts once loaded. Fonts that are still being measured count with their file size. The budget is set under Settings."))
+				.Justification(ETextJustify::Left)
+		]
+		.ValueContent()
+		[
+			SNew(STextBlock)
+				.Text_Lambda([MyDevSettings]()
+					{
+						const int64 Budget = int64(MyDevSettings->FontMemoryBudgetMB) * 1024 * 1024;
+						const int64 Total = MyDevSettings->GetTotalFontResidentBytes();
+						return FText::Format(Total > Budget ? INVTEXT("{0} of {1} budget, over by {2}") : INVTEXT("{0} of {1} budget"),
+							FText::AsMemory(Total), FText::AsMemory(Budget), FText::AsMemory(Total - Budget));
+					})
+				.ColorAndOpacity_Lambda([MyDevSettings]()
+					{
+						const int64 Budget = int64(MyDevSettings->FontMemoryBudgetMB) * 1024 * 1024;
+						return MyDevSettings->GetTotalFontResidentBytes() > Budget ? FSlateColor(FLinearColor(0.92f, 0.3f, 0.34f, 1.0)) : FSlateColor::UseForeground();
+					})
+		];
+
+
+	/// Profile buttons
+	DetailBuilder.EditCategory("Profiles")
+		.AddCustomRow(FText::FromString("Profiles"))
+		.NameContent()
+		[
+			SNew(STextBlock)
+				.Text(FText::FromString("Active profile"))
+				.Justification(ETextJustify::Left)
+		]
+		.ValueContent()
+		[
+			SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SNew(SButton)
+						.Text(FText::FromString("Apply"))
+						.ToolTipText(INVTEXT("Install the active profile. Only slots that differ are touched."))
+						.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable && !MyDevSettings->ActiveProfile.IsNone(); })
+						.OnClicked_Lambda([MyDevSettings]()
+							{
+								MyDevSettings->ApplyFontProfile(MyDevSettings->ActiveProfile);
+								return FReply::Handled();
+							})
+				]
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(FMargin(10.0f, 0.0f, 10.0f, 0.0f))
+				[
+					SNew(SButton)
+						.Text(FText::FromString("Capture Current"))
+						.ToolTipText(INVTEXT("Store the current fonts in the active profile, or in a new profile if none is selected."))
+						.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable; })
+						.OnClicked_Lambda([MyDevSettings, &DetailBuilder]()
+							{
+								FName ProfileName = MyDevSettings->ActiveProfile;
+								if (ProfileName.IsNone())
+								{
+									ProfileName = FName(FString::Printf(TEXT("Profile %d"), MyDevSettings->FontProfiles.Num() + 1));
+									MyDevSettings->ActiveProfile = ProfileName;
+								}
+								MyDevSettings->CaptureFontProfile(ProfileName);
+								DetailBuilder.ForceRefreshDetails();
+								return FReply::Handled();
+							})
+				]
+		];
+	DetailBuilder.EditCategory("Profiles")
+		.AddCustomRow(FText::FromString("Font pack"))
+		.NameContent()
+		[
+			SNew(STextBlock)
+				.Text(FText::FromString("Font pack"))
+				.Justification(ETextJustify::Left)
+		]
+		.ValueContent()
+		[
+			SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SNew(SButton)
+						.Text(FText::FromString("Apply Pack..."))
+						.ToolTipText(INVTEXT("Point the unlocked slots at the fonts of a .efpack file and install them straight from it."))
+						.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable; })
+						.OnClicked_Lambda([MyDevSettings, &DetailBuilder]()
+							{
+								const FString PackFile = MyDevSettings->PackFilePicker(TEXT("Apply Font Pack"), false);
+								if (!PackFile.IsEmpty() && MyDevSettings->ApplyFontPack(PackFile))
+								{
+									DetailBuilder.ForceRefreshDetails();
+								}
+								return FReply::Handled();
+							})
+				]
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(FMargin(10.0f, 0.0f, 10.0f, 0.0f))
+				[
+					SNew(SButton)
+						.Text(FText::FromString("Export Active Profile..."))
+						.ToolTipText(INVTEXT("Write the active profile's fonts and slot mapping into a single .efpack file to share."))
+						.IsEnabled_Lambda([MyDevSettings]() { return !MyDevSettings->ActiveProfile.IsNone(); })
+						.OnClicked_Lambda([MyDevSettings]()
+							{
+								const FString PackFile = MyDevSettings->PackFilePicker(TEXT("Export Font Pack"), true);
+								if (!PackFile.IsEmpty())
+								{
+									MyDevSettings->ExportFontPack(MyDevSettings->ActiveProfile, PackFile);
+								}
+								return FReply::Handled();
+							})
+				]
+		];
+
+
+	/// Variable font button
+	DetailBuilder.EditCategory("VariableFont")
+		.AddCustomRow(FText::FromString("Variable Font"))
+		.NameContent()
+		[
+			SNew(STextBlock)
+				.Text(FText::FromString("Fill the Latin slots"))
+				.Justification(ETextJustify::Left)
+		]
+		.ValueContent()
+		[
+			SNew(SButton)
+				.Text(FText::FromString("Apply Variable Font"))
+				.ToolTipText(INVTEXT("Generate an instance of the variable font for every unlocked Latin slot and install them. Instances are cached by axis values."))
+				.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable && !MyDevSettings->VariableFont.IsNone(); })
+				.OnClicked_Lambda([MyDevSettings]()
+					{
+						MyDevSettings->ApplyVariableFont();
+						return FReply::Handled();
+					})
+		];
+
+
+	/// Latin + CJK merge buttons
+	DetailBuilder.EditCategory("Merging")
+		.AddCustomRow(FText::FromString("Merge fonts"))
+		.NameContent()
+		[
+			SNew(STextBlock)
+				.Text(FText::FromString("One face for mixed text"))
+				.Justification(ETextJustify::Left)
+		]
+		.ValueContent()
+		[
+			SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SNew(SButton)
+						.Text(FText::FromString("Merge"))
+						.ToolTipText(INVTEXT("Merge the two slots' fonts into FontPath/Merged, where every slot can pick it. Merged faces are cached by both fonts."))
+						.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable && !MyDevSettings->MergeLatinSlot.IsNone() && !MyDevSettings->MergeCjkSlot.IsNone(); })
+						.OnClicked_Lambda([MyDevSettings]()
+							{
+								MyDevSettings->MergeSlotFonts(false);
+								return FReply::Handled();
+							})
+				]
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(FMargin(10.0f, 0.0f, 10.0f, 0.0f))
+				[
+					SNew(SButton)
+						.Text(FText::FromString("Merge and Install"))
+						.ToolTipText(INVTEXT("Merge, then switch the Latin slot to the merged face so mixed Latin and CJK text needs no fallback font."))
+						.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable && !MyDevSettings->MergeLatinSlot.IsNone() && !MyDevSettings->MergeCjkSlot.IsNone(); })
+						.OnClicked_Lambda([MyDevSettings]()
+							{
+								MyDevSettings->MergeSlotFonts(true);
+								return FReply::Handled();
+							})
+				]
+		];
+
+
+	/// Duplicate cleanup button
+	DetailBuilder.EditCategory("Settings")
+		.AddCustomRow(FText::FromString("Duplicate fonts"))
+		.NameContent()
+		[
+			SNew(STextBlock)
+				.Text(FText::FromString("Duplicate fonts"))
+				.Justification(ETextJustify::Left)
+		]
+		.ValueContent()
+		[
+			SNew(SButton)
+				.Text(FText::FromString("Remove Duplicates"))
+				.ToolTipText(INVTEXT("Delete copies of the same font from the font folders: identical files and files with the same outlines, within one format. The copy a slot uses is kept. System fonts are never touched."))
+				.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable; })
+				.OnClicked_Lambda([MyDevSettings, &DetailBuilder]()
+					{
+						int32 Count = 0;
+						int64 Bytes = 0;
+						for (const FEFDuplicateGroup& Group : MyDevSettings->FindDuplicateFonts())
+						{
+							Count += Group.Duplicates.Num();
+							Bytes += Group.DuplicateBytes;
+						}
+						if (Count == 0)
+						{
+							FMessageDialog::Open(EAppMsgType::Ok, INVTEXT("No duplicate fonts found."));
+							return FReply::Handled();
+						}
+						if (FMessageDialog::Open(EAppMsgType::YesNo, FText::Format(INVTEXT("Delete {0} duplicate fonts ({1}) from the font folders? Each removed file is listed in the output log."), Count, FText::AsMemory(Bytes))) == EAppReturnType::Yes)
+						{
+							int64 Reclaimed = 0;
+							MyDevSettings->RemoveDuplicateFonts(Reclaimed);
+							DetailBuilder.ForceRefreshDetails();
+						}
+						return FReply::Handled();
+					})
+		];
+
+
+	/// Font history buttons
+	DetailBuilder.EditCategory("Settings")
+		.AddCustomRow(FText::FromString("Font history"))
+		.NameContent()
+		[
+			SNew(STextBlock)
+				.Text_Lambda([MyDevSettings]()
+					{
+						if (!MyDevSettings->FontSnapshots.IsValidIndex(MyDevSettings->SnapshotCursor)) { return FText::FromString("Font history"); }
+						return FText::Format(INVTEXT("Font history {0}/{1}: {2}"), MyDevSettings->SnapshotCursor + 1, MyDevSettings->FontSnapshots.Num(), FText::FromString(MyDevSettings->FontSnapshots[MyDevSettings->SnapshotCursor].Label));
+					})
+				.Justification(ETextJustify::Left)
+		]
+		.ValueContent()
+		[
+			SNew(SHorizontalBox)
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				[
+					SNew(SButton)
+						.Text(FText::FromString("Undo"))
+						.ToolTipText(INVTEXT("Step back to the fonts before the last change. Only the slots that differ are re-linked, from copies kept in the cache."))
+						.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable && MyDevSettings->SnapshotCursor > 0; })
+						.OnClicked_Lambda([MyDevSettings, &DetailBuilder]()
+							{
+								MyDevSettings->UndoFontChange();
+								DetailBuilder.ForceRefreshDetails();
+								return FReply::Handled();
+							})
+				]
+				+ SHorizontalBox::Slot()
+				.AutoWidth()
+				.Padding(FMargin(10.0f, 0.0f, 10.0f, 0.0f))
+				[
+					SNew(SButton)
+						.Text(FText::FromString("Redo"))
+						.ToolTipText(INVTEXT("Step forward again after an undo."))
+						.IsEnabled_Lambda([MyDevSettings]() { return MyDevSettings->ToggleSettingsEditable && MyDevSettings->SnapshotCursor + 1 < MyDevSettings->FontSnapshots.Num(); })
+						.OnClicked_Lambda([MyDevSettings, &DetailBuilder]()
+							{
+								MyDevSettings->RedoFontChange();
+								DetailBuilder.ForceRefreshDetails();
+								return FReply::Handled();
+							})
+				]
+		];
+
+
 	/// Update fonts button
 	DetailBuilder.EditCategory("Fonts")
 		.AddCustomRow(FText::FromString("Fonts"))
@@ -466,7 +811,7 @@ void FEFDetails::CustomizeDetails(IDetailLayoutBuilder& DetailBuilder)
 						.ButtonColorAndOpacity((FLinearColor(0.5f, 0.939f, 0.524f, 1.0)))
 						.OnClicked_Lambda([]()
 								{
-								FSlateApplication::Get().GetRenderer()->FlushFontCache(TEXT("Fonts have been updated."));
+								GetMutableDefault<UDevEditor>()->FlushFontCache();
 
 								return FReply::Handled();
 								})
@@ -490,6 +835,7 @@ void FEFDetails::CustomizeDetails(IDetailLayoutBuilder& DetailBuilder)
 											  //FSlateStyleRegistry::RegisterSlateStyle(Style.Get());
 
 											  ///*Refresh windows*/
+											  EF_TRACE_SCOPE("EditorFont::RecreateMainFrame");
 											  DetailBuilder.EditCategory("Fonts").GetParentLayout().ForceRefreshDetails();
 											  FGlobalTabmanager::Get()->SaveAllVisualState();
 											  GConfig->Flush(true, GEditorLayoutIni);
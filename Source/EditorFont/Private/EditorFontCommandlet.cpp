@@ -0,0 +1,358 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EditorFontCommandlet.h"
+
+#include "EFBenchmark.h"
+#include "EFConfigWriter.h"
+#include "EFContentCache.h"
+#include "EFTextBenchmark.h"
+#include "UDevEditor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Policies/CondensedJsonPrintPolicy.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+
+namespace
+{
+    /** Same size and content hash. */
+    bool FilesMatch(const FString& A, const FString& B)
+    {
+        return FPaths::FileExists(A) && FPaths::FileExists(B)
+            && IFileManager::Get().FileSize(*A) == IFileManager::Get().FileSize(*B)
+            && FEFContentCache::HashFile(A) == FEFContentCache::HashFile(B);
+    }
+}
+
+UEditorFontCommandlet::UEditorFontCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+}
+
+int32 UEditorFontCommandlet::Main(const FString& Params)
+{
+    TArray<FString> Tokens;
+    TArray<FString> Switches;
+    TMap<FString, FString> ParamsMap;
+    ParseCommandLine(*Params, Tokens, Switches, ParamsMap);
+
+    UDevEditor* Settings = GetMutableDefault<UDevEditor>();
+    check(Settings);
+
+    const FString Op = ParamsMap.FindRef(TEXT("Op"));
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField(TEXT("op"), Op);
+
+    const double StartTime = FPlatformTime::Seconds();
+    bool bSuccess = false;
+    if (Op.Equals(TEXT("ApplyProfile"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunApplyProfile(Settings, ParamsMap, Report);
+    }
+    else if (Op.Equals(TEXT("ExportPack"), ESearchCase::IgnoreCase) || Op.Equals(TEXT("ApplyPack"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunFontPack(Settings, Op, ParamsMap, Report);
+    }
+    else if (Op.Equals(TEXT("Rollback"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunRollback(Settings, ParamsMap, Report);
+    }
+    else if (Op.Equals(TEXT("ApplyFamily"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunApplyFamily(Settings, ParamsMap, Report);
+    }
+    else if (Op.Equals(TEXT("Reset"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunReset(Settings, Report);
+    }
+    else if (Op.Equals(TEXT("ConvertFolder"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunConvertFolder(Settings, ParamsMap, Report);
+    }
+    else if (Op.Equals(TEXT("MergeFonts"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunMergeFonts(Settings, ParamsMap, Switches, Report);
+    }
+    else if (Op.Equals(TEXT("Verify"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunVerify(Settings, Report);
+    }
+    else if (Op.Equals(TEXT("Dedupe"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunDedupe(Settings, Switches, Report);
+    }
+    else if (Op.Equals(TEXT("Benchmark"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunBenchmark(Settings, ParamsMap, Report);
+    }
+    else if (Op.Equals(TEXT("TextBenchmark"), ESearchCase::IgnoreCase))
+    {
+        bSuccess = RunTextBenchmark(Settings, ParamsMap, Report);
+    }
+    else
+    {
+        Report->SetStringField(TEXT("error"), TEXT("Unknown -Op. Expected ApplyProfile, ExportPack, ApplyPack, Rollback, ApplyFamily, Reset, ConvertFolder, MergeFonts, Verify, Dedupe, Benchmark or TextBenchmark."));
+    }
+    Report->SetNumberField(TEXT("durationMs"), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    Report->SetBoolField(TEXT("success"), bSuccess);
+
+    // Settings changed by the operation must be on disk before the process exits.
+    FEFConfigWriter::Get().Flush();
+
+    FString Json;
+    TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer = TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Json);
+    FJsonSerializer::Serialize(Report, Writer);
+    UE_LOG(LogTemp, Display, TEXT("EditorFontResult: %s"), *Json);
+
+    const FString ReportFile = ParamsMap.FindRef(TEXT("Report"));
+    if (!ReportFile.IsEmpty() && !FFileHelper::SaveStringToFile(Json, *ReportFile))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to write report. %s"), *ReportFile);
+    }
+    return bSuccess ? 0 : 1;
+}
+
+bool UEditorFontCommandlet::RunApplyProfile(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report)
+{
+    const FString Profile = ParamsMap.FindRef(TEXT("Profile"));
+    Report->SetStringField(TEXT("profile"), Profile);
+    if (Profile.IsEmpty())
+    {
+        Report->SetStringField(TEXT("error"), TEXT("Missing -Profile."));
+        return false;
+    }
+    return Settings->ApplyFontProfile(FName(Profile));
+}
+
+bool UEditorFontCommandlet::RunFontPack(UDevEditor* Settings, const FString& Op, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report)
+{
+    const FString Pack = ParamsMap.FindRef(TEXT("Pack"));
+    Report->SetStringField(TEXT("pack"), Pack);
+    if (Pack.IsEmpty())
+    {
+        Report->SetStringField(TEXT("error"), TEXT("Missing -Pack."));
+        return false;
+    }
+    if (Op.Equals(TEXT("ApplyPack"), ESearchCase::IgnoreCase))
+    {
+        return Settings->ApplyFontPack(Pack);
+    }
+    const FString Profile = ParamsMap.FindRef(TEXT("Profile"));
+    Report->SetStringField(TEXT("profile"), Profile);
+    if (Profile.IsEmpty())
+    {
+        Report->SetStringField(TEXT("error"), TEXT("Missing -Profile."));
+        return false;
+    }
+    return Settings->ExportFontPack(FName(Profile), Pack);
+}
+
+bool UEditorFontCommandlet::RunRollback(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report)
+{
+    // Without -Snapshot this is one undo.
+    const FString* SnapshotParam = ParamsMap.Find(TEXT("Snapshot"));
+    const int32 Index = SnapshotParam ? FCString::Atoi(**SnapshotParam) : Settings->SnapshotCursor - 1;
+    Report->SetNumberField(TEXT("snapshot"), Index);
+    Report->SetNumberField(TEXT("snapshots"), Settings->FontSnapshots.Num());
+    if (!Settings->FontSnapshots.IsValidIndex(Index))
+    {
+        Report->SetStringField(TEXT("error"), TEXT("No such snapshot."));
+        return false;
+    }
+    Report->SetStringField(TEXT("label"), Settings->FontSnapshots[Index].Label);
+    return Settings->RollbackToSnapshot(Index);
+}
+
+bool UEditorFontCommandlet::RunApplyFamily(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report)
+{
+    const FString Family = ParamsMap.FindRef(TEXT("Family"));
+    Report->SetStringField(TEXT("family"), Family);
+    if (Family.IsEmpty())
+    {
+        Report->SetStringField(TEXT("error"), TEXT("Missing -Family."));
+        return false;
+    }
+    return Settings->ApplyFontFamily(FName(Family));
+}
+
+bool UEditorFontCommandlet::RunReset(UDevEditor* Settings, TSharedRef<FJsonObject> Report)
+{
+    const TArray<FNameProperty*> SlotProperties = Settings->GetFontSlotProperties();
+    TArray<FName> Previous;
+    for (const FNameProperty* Slot : SlotProperties)
+    {
+        Previous.Add(Slot->GetPropertyValue_InContainer(Settings));
+    }
+    // Commandlet jobs run inline, the files are restored when this returns.
+    const bool bReset = Settings->ResetToDefaults();
+    Settings->SaveSettingToConfig();
+
+    TArray<TSharedPtr<FJsonValue>> Slots;
+    for (int32 Index = 0; Index < SlotProperties.Num(); Index++)
+    {
+        const FNameProperty* Slot = SlotProperties[Index];
+        const FString FileName = Slot->GetMetaData(TEXT("FileName"));
+        const FName Value = Slot->GetPropertyValue_InContainer(Settings);
+
+        TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetStringField(TEXT("slot"), Slot->GetName());
+        Entry->SetStringField(TEXT("fileName"), FileName);
+        Entry->SetStringField(TEXT("previous"), Previous[Index].IsNone() ? TEXT("default") : Previous[Index].ToString());
+        Entry->SetBoolField(TEXT("reset"), !Previous[Index].IsNone() && Value.IsNone());
+        // The composite backend restores bindings in memory, only the file backend leaves a file to compare.
+        if (Settings->FontBackend == EEFFontBackend::ReplaceFiles)
+        {
+            Entry->SetBoolField(TEXT("matchesDefault"), FilesMatch(Settings->GetFontDestinationDir(Slot) / FileName, Settings->Defaults / FileName));
+        }
+        Slots.Add(MakeShared<FJsonValueObject>(Entry));
+    }
+    Report->SetArrayField(TEXT("slots"), Slots);
+    return bReset;
+}
+
+bool UEditorFontCommandlet::RunConvertFolder(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report)
+{
+    const FString Path = ParamsMap.FindRef(TEXT("Path"));
+    Report->SetStringField(TEXT("path"), Path);
+    TArray<FString> Files;
+    if (Settings->GetFontsFromFolder(Files, Path))
+    {
+        Report->SetNumberField(TEXT("files"), Files.Num());
+    }
+    const int32 ErrorCount = Settings->ConvertFontFolder(nullptr, Path);
+    if (ErrorCount < 0)
+    {
+        Report->SetStringField(TEXT("error"), TEXT("Path is not a directory."));
+        return false;
+    }
+    Report->SetNumberField(TEXT("errors"), ErrorCount);
+    return ErrorCount == 0;
+}
+
+bool UEditorFontCommandlet::RunMergeFonts(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, const TArray<FString>& Switches, TSharedRef<FJsonObject> Report)
+{
+    if (const FString* Latin = ParamsMap.Find(TEXT("Latin"))) { Settings->MergeLatinSlot = FName(*Latin); }
+    if (const FString* Cjk = ParamsMap.Find(TEXT("Cjk"))) { Settings->MergeCjkSlot = FName(*Cjk); }
+    Report->SetStringField(TEXT("latin"), Settings->MergeLatinSlot.ToString());
+    Report->SetStringField(TEXT("cjk"), Settings->MergeCjkSlot.ToString());
+    const bool bInstall = Switches.Contains(TEXT("Install"));
+    // Commandlet jobs run inline, the merge and the install are done when this returns.
+    if (!Settings->MergeSlotFonts(bInstall))
+    {
+        Report->SetStringField(TEXT("error"), TEXT("Merge failed, see the log."));
+        return false;
+    }
+    FNameProperty* LatinSlot = FindFProperty<FNameProperty>(UDevEditor::StaticClass(), Settings->MergeLatinSlot);
+    if (bInstall && LatinSlot)
+    {
+        Report->SetStringField(TEXT("installed"), LatinSlot->GetPropertyValue_InContainer(Settings).ToString());
+    }
+    return true;
+}
+
+bool UEditorFontCommandlet::RunVerify(UDevEditor* Settings, TSharedRef<FJsonObject> Report)
+{
+    TArray<TSharedPtr<FJsonValue>> Slots;
+    bool bAllMatch = true;
+    const FEFInstallOptions Options = Settings->GetInstallOptions();
+    for (FNameProperty* Slot : Settings->GetFontSlotProperties())
+    {
+        const FString FileName = Slot->GetMetaData(TEXT("FileName"));
+        const FName Value = Slot->GetPropertyValue_InContainer(Settings);
+        // Compared against what an install actually writes, after subsetting and optimization.
+        // The composite backend restores a slot by unbinding it, the engine file is then the shipped one.
+        FString Expected = Settings->Defaults / FileName;
+        if (!Value.IsNone() || Settings->FontBackend == EEFFontBackend::ReplaceFiles)
+        {
+            const FEFSlotInstall Install = Settings->MakeSlotInstall(Slot, Value.IsNone() ? Expected : Settings->ResolveFontValue(Value));
+            Expected = UDevEditor::ResolveFontSource(UDevEditor::ResolveInstallSource(Options, Install.Culture, Install.Source));
+        }
+        const FString Installed = Settings->GetInstalledFontPath(Slot);
+
+        TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetStringField(TEXT("slot"), Slot->GetName());
+        Entry->SetStringField(TEXT("fileName"), FileName);
+        Entry->SetStringField(TEXT("expected"), Value.IsNone() ? TEXT("default") : Value.ToString());
+        const bool bInstalled = FPaths::FileExists(Installed);
+        Entry->SetBoolField(TEXT("installed"), bInstalled);
+        const bool bMatches = bInstalled && FilesMatch(Installed, Expected);
+        Entry->SetBoolField(TEXT("matches"), bMatches);
+        bAllMatch &= bMatches;
+        Slots.Add(MakeShared<FJsonValueObject>(Entry));
+    }
+    Report->SetArrayField(TEXT("slots"), Slots);
+    return bAllMatch;
+}
+
+bool UEditorFontCommandlet::RunDedupe(UDevEditor* Settings, const TArray<FString>& Switches, TSharedRef<FJsonObject> Report)
+{
+    const bool bDryRun = Switches.ContainsByPredicate([](const FString& Switch) { return Switch.Equals(TEXT("DryRun"), ESearchCase::IgnoreCase); });
+    Report->SetBoolField(TEXT("dryRun"), bDryRun);
+    TArray<TSharedPtr<FJsonValue>> Groups;
+    int64 DuplicateBytes = 0;
+    for (const FEFDuplicateGroup& Group : Settings->FindDuplicateFonts())
+    {
+        TSharedRef<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetStringField(TEXT("kind"), FEFDuplicateGroup::LexKind(Group.Kind));
+        Entry->SetStringField(TEXT("keep"), Group.Keep);
+        TArray<TSharedPtr<FJsonValue>> Duplicates;
+        for (const FString& Duplicate : Group.Duplicates)
+        {
+            Duplicates.Add(MakeShared<FJsonValueString>(Duplicate));
+        }
+        Entry->SetArrayField(TEXT("duplicates"), Duplicates);
+        Entry->SetNumberField(TEXT("bytes"), Group.DuplicateBytes);
+        Groups.Add(MakeShared<FJsonValueObject>(Entry));
+        DuplicateBytes += Group.DuplicateBytes;
+    }
+    Report->SetArrayField(TEXT("groups"), Groups);
+    Report->SetNumberField(TEXT("duplicateBytes"), DuplicateBytes);
+    if (!bDryRun)
+    {
+        int64 Reclaimed = 0;
+        Report->SetNumberField(TEXT("removed"), Settings->RemoveDuplicateFonts(Reclaimed));
+        Report->SetNumberField(TEXT("reclaimedBytes"), Reclaimed);
+    }
+    return true;
+}
+
+bool UEditorFontCommandlet::RunBenchmark(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report)
+{
+    FEFBenchmark::FOptions Options;
+    if (const FString* Sizes = ParamsMap.Find(TEXT("Sizes")))
+    {
+        TArray<FString> Parts;
+        Sizes->ParseIntoArray(Parts, TEXT(","));
+        Options.LibrarySizes.Reset();
+        for (const FString& Part : Parts)
+        {
+            Options.LibrarySizes.Add(FCString::Atoi(*Part));
+        }
+    }
+    if (const FString* Iterations = ParamsMap.Find(TEXT("Iterations"))) { Options.Iterations = FMath::Max(1, FCString::Atoi(**Iterations)); }
+    if (const FString* Samples = ParamsMap.Find(TEXT("ConvertSamples"))) { Options.ConversionSamples = FCString::Atoi(**Samples); }
+    if (const FString* Tolerance = ParamsMap.Find(TEXT("Tolerance"))) { Options.Tolerance = FCString::Atod(**Tolerance); }
+    Options.OutputDir = ParamsMap.FindRef(TEXT("Output"));
+    Options.BaselineFile = ParamsMap.FindRef(TEXT("Baseline"));
+
+    FEFBenchmark Benchmark(Settings, Options);
+    return Benchmark.Run(Report);
+}
+
+bool UEditorFontCommandlet::RunTextBenchmark(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report)
+{
+    FEFTextBenchmark::FOptions Options;
+    if (const FString* Fonts = ParamsMap.Find(TEXT("Fonts")))
+    {
+        Fonts->ParseIntoArray(Options.Fonts, TEXT(","));
+    }
+    if (const FString* Iterations = ParamsMap.Find(TEXT("Iterations"))) { Options.Iterations = FMath::Max(1, FCString::Atoi(**Iterations)); }
+    Options.OutputDir = ParamsMap.FindRef(TEXT("Output"));
+
+    FEFTextBenchmark Benchmark(Settings, Options);
+    return Benchmark.Run(Report);
+}
@@ -3,13 +3,64 @@
 #include "UDevEditor.h"
 
 #include "DebugHeader.h"
+#include "EFCompositeFont.h"
+#include "EFConfigWriter.h"
+#include "EFContentCache.h"
+#include "EFCoreBridge.h"
+#include "EFCoreFontFile.h"
+#include "EFCoreInstall.h"
+#include "EFCorePlan.h"
+#include "EFFamilyMapper.h"
+#include "EFFontCollection.h"
+#include "EFFontIndex.h"
+#include "EFFontMerger.h"
+#include "EFFontOptimizer.h"
+#include "EFFontPack.h"
+#include "EFFontScanner.h"
+#include "EFFontStats.h"
+#include "EFSdfAtlas.h"
+#include "EFSubset.h"
+#include "EFVariableFont.h"
+#include "EFTrace.h"
 #include "Interfaces/IPluginManager.h"
+#include "Internationalization/Culture.h"
 #include "Logging/StructuredLog.h"
 #include "HAL/PlatformTime.h"
 #include "Misc/DateTime.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/Guid.h"
 #include "Containers/Ticker.h"
 
 
+namespace
+{
+    // Each snapshot is a few lines of config, the font copies are shared through the content cache.
+    constexpr int32 MaxFontSnapshots = 50;
+
+    // The core planner works on names and strings, an empty value is the shipped default like NAME_None.
+    std::vector<EFCore::FSlotState> MakeSlotStates(const UDevEditor* Settings, const TArray<FNameProperty*>& Slots)
+    {
+        std::vector<EFCore::FSlotState> States;
+        for (const FNameProperty* Slot : Slots)
+        {
+            const FName Value = Slot->GetPropertyValue_InContainer(Settings);
+            const FString* Toggle = Settings->ToggleStates.Find(Slot->GetFName());
+            States.push_back({ FEFCoreBridge::ToUtf8(Slot->GetName()),
+                Value.IsNone() ? std::string() : FEFCoreBridge::ToUtf8(Value.ToString()),
+                !(Toggle && *Toggle == "False") });
+        }
+        return States;
+    }
+
+    TPair<FNameProperty*, FName> ToSlotChange(const TArray<FNameProperty*>& Slots, const EFCore::FSlotChange& Change)
+    {
+        const FString Name = FEFCoreBridge::FromUtf8(Change.Name);
+        FNameProperty* const* Slot = Slots.FindByPredicate([&Name](const FNameProperty* Property) { return Property->GetName() == Name; });
+        check(Slot);
+        return TPair<FNameProperty*, FName>(*Slot, Change.Value.empty() ? NAME_None : FName(*FEFCoreBridge::FromUtf8(Change.Value)));
+    }
+}
+
 UDevEditor::UDevEditor(const FObjectInitializer& ObjectInitializer)
     : PluginContentPath(*IPluginManager::Get().FindPlugin(TEXT("EditorFont"))->GetContentDir())
     , FontPath(*IPluginManager::Get().FindPlugin(TEXT("EditorFont"))->GetContentDir())
@@ -18,7 +69,6 @@ UDevEditor::UDevEditor(const FObjectInitializer& ObjectInitializer)
 {
     FontPath = PluginContentPath + "/TempFonts";
     Defaults = PluginContentPath + "/Defaults";
-    this->CreateDefaultFolder();
     this->CreateTempFontsFolder();
     CategoryName = "EditorFont";
     TSharedPtr<SWidget>UDevEditorWidget = this->GetCustomSettingsWidget();
@@ -41,134 +91,304 @@ FString UDevEditor::FilePicker(const FString& DialogueTitle)
     return OutName;
 }
 
+FString UDevEditor::PackFilePicker(const FString& DialogueTitle, bool bSave)
+{
+    const void* NativeWinHandle = FSlateApplication::Get().FindBestParentWindowHandleForDialogs(nullptr);
+    IDesktopPlatform* DesktopPlatform = FDesktopPlatformModule::Get();
+    if (!NativeWinHandle || !DesktopPlatform) { return FString(); }
+    const FString FileTypes = TEXT("Font pack (*.efpack)|*.efpack");
+    TArray<FString> OutNames;
+    const bool bPicked = bSave
+        ? DesktopPlatform->SaveFileDialog(NativeWinHandle, DialogueTitle, FontPath, TEXT("Fonts.efpack"), FileTypes, EFileDialogFlags::None, OutNames)
+        : DesktopPlatform->OpenFileDialog(NativeWinHandle, DialogueTitle, FontPath, FString(), FileTypes, EFileDialogFlags::None, OutNames);
+    return bPicked && OutNames.Num() > 0 ? FPaths::ConvertRelativePathToFull(OutNames[0]) : FString();
+}
+
 bool UDevEditor::GetFontsFromFolder(TArray<FString>& string_array, const FString& path)
 {
+    EF_TRACE_SCOPE("EditorFont::GetFontsFromFolder");
     // this->LoadConfigFile();
     auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    FJsonSerializableArray file_array;
+    TArray<FString> file_array;
     if (PlatformFile.DirectoryExists(*path)) {
-        TArray<FString> Extensions = { TEXT(".otf"), TEXT(".ttf") };
-        for (const FString& Extension : Extensions)
-        {
-            TArray<FString> TempFiles;
-            PlatformFile.FindFiles(TempFiles, *path, *Extension);
-            file_array.Append(TempFiles);
-        }
+        file_array = FEFFontScanner::Get().Scan({ path });
     }
     else { string_array.Add("Path is invalid. Please double check."); return false; }
     if(file_array.Num() < 1){ string_array.Add("No valid fonts for this property in folder."); return false;}
 
-    for (auto file : file_array) {
-        FString PathPart = FString("");
-        FString FileNamePart = FString("");
-        FString ExtensionPart = FString("");
-
-        FPaths::Split(*file, PathPart, FileNamePart, ExtensionPart);
-        FName real_file = FName(FileNamePart + "." + ExtensionPart);
-        string_array.Add(real_file.ToString());
+    FString Root = FPaths::ConvertRelativePathToFull(path);
+    FPaths::NormalizeDirectoryName(Root);
+    for (FString file : file_array) {
+        FPaths::MakePathRelativeTo(file, *(Root + "/"));
+        string_array.Add(file);
     }
     return true;
 }
 
-TArray<FString> UDevEditor::GetOtfFonts()
+TArray<FString> UDevEditor::GetFontRoots(bool bWritableOnly) const
 {
-    TArray<FString> string_array = TArray<FString>();
-    TArray<FString> NewArray = TArray<FString>();
-    if (!GetFontsFromFolder(string_array, FontPath)){
-        return string_array;
+    TArray<FString> Roots = { FPaths::ConvertRelativePathToFull(FontPath) };
+    for (const FDirectoryPath& Directory : AdditionalFontDirectories)
+    {
+        if (!Directory.Path.IsEmpty()) { Roots.Add(FPaths::ConvertRelativePathToFull(Directory.Path)); }
     }
-    for (auto font:string_array){
-       if ( FPaths::GetExtension(*font, true) == TEXT(".otf")){
-           NewArray.Add(font);
-       }
+    // The shared folder belongs to every project using the cache, nothing here may delete from it.
+    const FString SharedRoot = FEFContentCache::Get().GetSharedRoot();
+    if (!SharedRoot.IsEmpty() && !bWritableOnly)
+    {
+        Roots.Add(SharedRoot / TEXT("Fonts"));
     }
-    return NewArray;
+    if (bScanSystemFontDirectories && !bWritableOnly)
+    {
+        Roots.Append(FEFFontScanner::GetSystemFontDirectories());
+    }
+    return Roots;
 }
 
-TArray<FString> UDevEditor::GetTtfFonts()
+TArray<FString> UDevEditor::GetFontLibrary(bool bIncludeDuplicates)
+{
+    bool bRescanned = false;
+    TArray<FString> Library = FEFFontScanner::Get().Scan(GetFontRoots(), &bRescanned);
+    if (bRescanned)
+    {
+        FEFFontIndex::Get().Refresh(Library);
+        HiddenDuplicateFonts.Reset();
+        if (bCollapseDuplicateFonts)
+        {
+            for (const FEFDuplicateGroup& Group : FEFDuplicateFinder::FindGroups(FEFFontIndex::Get().GetEntries(Library), GetSlotFontPaths()))
+            {
+                HiddenDuplicateFonts.Append(Group.Duplicates);
+            }
+        }
+    }
+    if (!bIncludeDuplicates && HiddenDuplicateFonts.Num() > 0)
+    {
+        Library.RemoveAll([this](const FString& Path) { return HiddenDuplicateFonts.Contains(Path); });
+    }
+    return Library;
+}
+
+TSet<FString> UDevEditor::GetSlotFontPaths() const
+{
+    TSet<FString> Paths;
+    for (const FNameProperty* Property : GetFontSlotProperties())
+    {
+        const FName Value = Property->GetPropertyValue_InContainer(this);
+        if (!Value.IsNone()) { Paths.Add(FPaths::ConvertRelativePathToFull(ResolveFontValue(Value))); }
+    }
+    if (!VariableFont.IsNone()) { Paths.Add(FPaths::ConvertRelativePathToFull(ResolveFontValue(VariableFont))); }
+    return Paths;
+}
+
+TArray<FEFDuplicateGroup> UDevEditor::FindDuplicateFonts()
+{
+    const TArray<FString> Library = GetFontLibrary(true);
+    return FEFDuplicateFinder::FindGroups(FEFFontIndex::Get().GetEntries(Library), GetSlotFontPaths());
+}
+
+int32 UDevEditor::RemoveDuplicateFonts(int64& OutBytes)
+{
+    EF_TRACE_SCOPE("EditorFont::RemoveDuplicateFonts");
+    const int32 Removed = FEFDuplicateFinder::RemoveDuplicates(FindDuplicateFonts(), GetFontRoots(true), OutBytes);
+    FEFFontScanner::Get().Invalidate();
+    UE_LOG(LogTemp, Warning, TEXT("Removed %d duplicate fonts, %s reclaimed"), Removed, *FText::AsMemory(OutBytes).ToString());
+    return Removed;
+}
+
+FString UDevEditor::MakeFontValue(const FString& FontFile) const
+{
+    FString Root = FPaths::ConvertRelativePathToFull(FontPath);
+    FPaths::NormalizeDirectoryName(Root);
+    FString Value = FontFile;
+    if (FPaths::IsUnderDirectory(Value, Root))
+    {
+        FPaths::MakePathRelativeTo(Value, *(Root + "/"));
+    }
+    return Value;
+}
+
+FString UDevEditor::ResolveFontValue(FName Value) const
+{
+    const FString ValueString = Value.ToString();
+    return FPaths::IsRelative(ValueString) ? FontPath / ValueString : ValueString;
+}
+
+FString UDevEditor::ResolveFontSource(const FString& Path)
+{
+    // Packs only hold standalone fonts, faces are extracted when the pack is written.
+    return FEFFontPack::IsPackMember(Path) ? FEFFontPack::ResolveMember(Path) : FEFFontCollection::ResolveFace(Path);
+}
+
+bool UDevEditor::FontSourceExists(const FString& Path)
 {
-    TArray<FString> string_array = TArray<FString>();
-    TArray<FString> NewArray = TArray<FString>();
-    if (!GetFontsFromFolder(string_array, FontPath)){
-        return string_array;
+    FString PackFile, Member;
+    if (FEFFontPack::SplitMemberPath(Path, PackFile, Member))
+    {
+        const TSharedPtr<FEFFontPack> Pack = FEFFontPack::Open(PackFile);
+        return Pack && Pack->FindMember(Member);
     }
-    for (auto font:string_array){
-        if ( FPaths::GetExtension(*font, true) == TEXT(".ttf")) {
-            NewArray.Add(font);
+    return FPaths::FileExists(FEFFontCollection::GetFilePart(Path));
+}
+
+TArray<FString> UDevEditor::GetFontsWithExtension(const FString& Extension)
+{
+    TArray<FString> NewArray;
+    for (const FString& Font : GetFontLibrary())
+    {
+        // An extracted face loads like any other font, whatever the slot's file is called.
+        if (Extension.IsEmpty() || FPaths::GetExtension(Font, true) == Extension || FEFFontCollection::IsCollectionFile(FEFFontCollection::GetFilePart(Font)))
+        {
+            NewArray.Add(MakeFontValue(Font));
         }
     }
+    if (NewArray.Num() < 1){ NewArray.Add("No valid fonts for this property in folder."); }
     return NewArray;
 }
 
+TArray<FString> UDevEditor::GetOtfFonts()
+{
+    return GetFontsWithExtension(TEXT(".otf"));
+}
+
+TArray<FString> UDevEditor::GetTtfFonts()
+{
+    return GetFontsWithExtension(TEXT(".ttf"));
+}
+
+void UDevEditor::PostInitProperties()
+{
+    Super::PostInitProperties();
+    // Config is loaded by now, and it decides where Defaults lives.
+    if (HasAnyFlags(RF_ClassDefaultObject))
+    {
+        ApplySharedCacheSettings();
+    }
+}
+
+void UDevEditor::ApplySharedCacheSettings()
+{
+    FString SharedRoot;
+    if (bUseSharedCache)
+    {
+        SharedRoot = SharedCacheDirectory.Path.IsEmpty() ? FEFContentCache::GetDefaultSharedRoot() : FPaths::ConvertRelativePathToFull(SharedCacheDirectory.Path);
+    }
+    FEFContentCache::Get().SetSharedRoot(SharedRoot);
+    // Engine builds do not all ship the same fonts, so the shared backup is kept per build.
+    Defaults = SharedRoot.IsEmpty() ? PluginContentPath + "/Defaults" : SharedRoot / TEXT("Defaults") / FPaths::MakeValidFileName(FEngineVersion::Current().ToString(), TEXT('_'));
+    CreateDefaultFolder();
+    if (!SharedRoot.IsEmpty())
+    {
+        IFileManager::Get().MakeDirectory(*(SharedRoot / TEXT("Fonts")), true);
+    }
+    FEFFontIndex::Get().Unload();
+    FEFFontScanner::Get().Invalidate();
+}
+
 void UDevEditor::CreateDefaultFolder()
 {
+    // Queued ahead of any reset, which is what reads the copy.
+    FEFWorkQueue::Get().Enqueue(TEXT("Backing up the engine fonts"), [this, Target = Defaults](FEFWorkQueue::FProgress& Progress)
+        {
+            return BuildDefaultFolder(Target);
+        });
+}
+
+bool UDevEditor::BuildDefaultFolder(const FString& Target) const
+{
+    EF_TRACE_SCOPE("EditorFont::CreateDefaultFolder");
     auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    if (!PlatformFile.DirectoryExists(*Defaults)) {
-        PlatformFile.CreateDirectory(*Defaults);
-        PlatformFile.CopyDirectoryTree(*Defaults, *SlateFontPath, false);
-        // Specify the path to the additional directory to copy files from.
-        if (PlatformFile.DirectoryExists(*Defaults))
-        {
-             /*Create a custom directory visitor to copy files.*/
-            class FFileCopyVisitor : public IPlatformFile::FDirectoryVisitor
+    if (!PlatformFile.DirectoryExists(*Target)) {
+        // Built beside the target and renamed into place, so an editor starting at the same time never sees half a copy.
+        const FString Staging = Target + TEXT(".") + FGuid::NewGuid().ToString();
+        const FString LocalDefaults = PluginContentPath + "/Defaults";
+        PlatformFile.CreateDirectoryTree(*Staging);
+        if (Target != LocalDefaults && PlatformFile.DirectoryExists(*LocalDefaults))
+        {
+            // The engine fonts may already be replaced, the plugin's own backup is the pristine copy.
+            PlatformFile.CopyDirectoryTree(*Staging, *LocalDefaults, false);
+        }
+        else
+        {
+            PlatformFile.CopyDirectoryTree(*Staging, *SlateFontPath, false);
+            // Specify the path to the additional directory to copy files from.
+            if (PlatformFile.DirectoryExists(*Staging))
             {
-            public:
-                FFileCopyVisitor(const FString& InDestinationFolder, IPlatformFile& InPlatform)
-                    : DestinationFolder(InDestinationFolder)
-                    , Platform(InPlatform)
+                 /*Create a custom directory visitor to copy files.*/
+                class FFileCopyVisitor : public IPlatformFile::FDirectoryVisitor
                 {
-                }
-                virtual bool Visit(const TCHAR* Filename, bool bIsDirectory) override
-                {
-                    // We want to copy only files (not subdirectories).
-                    if (!bIsDirectory)
+                public:
+                    FFileCopyVisitor(const FString& InDestinationFolder, IPlatformFile& InPlatform)
+                        : DestinationFolder(InDestinationFolder)
+                        , Platform(InPlatform)
                     {
-                        FString SourceFile(Filename);
-                        FString FileName = FPaths::GetCleanFilename(SourceFile);
-                        FString DestinationFile = FPaths::Combine(DestinationFolder, FileName);
-                        // Copy the file from the source to destination.
-                        if (!Platform.CopyFile(*DestinationFile, *SourceFile))
-                        {
-                            UE_LOG(LogTemp, Error, TEXT("Failed to copy file: %s"), *SourceFile);
-                        }
-                        else
+                    }
+                    virtual bool Visit(const TCHAR* Filename, bool bIsDirectory) override
+                    {
+                        // We want to copy only files (not subdirectories).
+                        if (!bIsDirectory)
                         {
-                            UE_LOG(LogTemp, Log, TEXT("Copied file: %s"), *SourceFile);
+                            FString SourceFile(Filename);
+                            FString FileName = FPaths::GetCleanFilename(SourceFile);
+                            FString DestinationFile = FPaths::Combine(DestinationFolder, FileName);
+                            // Copy the file from the source to destination.
+                            TRACE_COUNTER_INCREMENT(EditorFont_FilesTouched);
+                            if (!Platform.CopyFile(*DestinationFile, *SourceFile))
+                            {
+                                UE_LOG(LogTemp, Error, TEXT("Failed to copy file: %s"), *SourceFile);
+                            }
+                            else
+                            {
+                                UE_LOG(LogTemp, Log, TEXT("Copied file: %s"), *SourceFile);
+                            }
                         }
+                        return true; // continue iteration
                     }
-                    return true; // continue iteration
-                }
-            private:
-                FString DestinationFolder;
-                IPlatformFile& Platform;
-            };
-            /*End of class definition scope*/
-            FFileCopyVisitor Visitor(Defaults, PlatformFile);
-            PlatformFile.IterateDirectory(*AltSlateFontPath, Visitor);
+                private:
+                    FString DestinationFolder;
+                    IPlatformFile& Platform;
+                };
+                /*End of class definition scope*/
+                FFileCopyVisitor Visitor(Staging, PlatformFile);
+                PlatformFile.IterateDirectory(*AltSlateFontPath, Visitor);
+            }
+        }
+        if (!PlatformFile.MoveFile(*Target, *Staging))
+        {
+            // Another editor finished first, its copy is as good as ours.
+            PlatformFile.DeleteDirectoryRecursively(*Staging);
         }
     }
+    return PlatformFile.DirectoryExists(*Target);
 }
 
 void UDevEditor::CreateTempFontsFolder()
 {
     FPaths::NormalizeDirectoryName(FontPath);
     //NewFontFolderPath = FontPath + "/TempFonts";
-    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
     FText OutReason = FText::GetEmpty();
     if (!ToggleSettingsEditable || FontPath == FString("")) { return; }
-    if (!PlatformFile.DirectoryExists(*FontPath))
-    {
-        if (!FPaths::ValidatePath(FontPath, &OutReason)) { UE_LOG(LogTemp, Error, TEXT("Critical failure! Reason: %s"), *OutReason.ToString()); return; }
-        if (PlatformFile.CreateDirectory(*FontPath))
+    if (!FPaths::ValidatePath(FontPath, &OutReason)) { UE_LOG(LogTemp, Error, TEXT("Critical failure! Reason: %s"), *OutReason.ToString()); return; }
+    // FontPath may be on a network share, where even the existence check can stall.
+    FEFWorkQueue::Get().Enqueue(TEXT("Preparing the font folder"), [Folder = FontPath](FEFWorkQueue::FProgress& Progress)
         {
-            UE_LOG(LogTemp, Warning, TEXT("Folder created at %s"), *FontPath);
-        }
-        else
+            auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+            if (PlatformFile.DirectoryExists(*Folder))
+            {
+                UE_LOG(LogTemp, Warning, TEXT("Folder found at %s"), *Folder);
+                return true;
+            }
+            if (!PlatformFile.CreateDirectory(*Folder))
+            {
+                UE_LOG(LogTemp, Error, TEXT("Folder failed to be created at %s"), *Folder);
+                return false;
+            }
+            UE_LOG(LogTemp, Warning, TEXT("Folder created at %s"), *Folder);
+            return true;
+        },
+        [](bool bCreated)
         {
-            UE_LOG(LogTemp, Error, TEXT("Folder failed to be created at %s"), *FontPath);
-        }
-    }
-    else{UE_LOG(LogTemp, Warning, TEXT("Folder found at %s"), *FontPath)}
+            FEFFontScanner::Get().Invalidate();
+        });
 }
 
 
@@ -189,6 +409,50 @@ void UDevEditor::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyCh
         HandleConverterProp(PropertyChangedEvent);
         return;
     }
+    auto memberName = PropertyChangedEvent.GetMemberPropertyName();
+    if (memberName == GET_MEMBER_NAME_CHECKED(UDevEditor, FontProfiles) || memberName == GET_MEMBER_NAME_CHECKED(UDevEditor, VariableInstanceOverrides))
+    {
+        Super::PostEditChangeProperty(PropertyChangedEvent);
+        SaveSettingToConfig();
+        return;
+    }
+    if (propertyName == GET_MEMBER_NAME_CHECKED(UDevEditor, bUseSharedCache) || memberName == GET_MEMBER_NAME_CHECKED(UDevEditor, SharedCacheDirectory))
+    {
+        ApplySharedCacheSettings();
+        Super::PostEditChangeProperty(PropertyChangedEvent);
+        SaveSettingToConfig();
+        return;
+    }
+    if (memberName == GET_MEMBER_NAME_CHECKED(UDevEditor, AdditionalFontDirectories) || propertyName == GET_MEMBER_NAME_CHECKED(UDevEditor, bScanSystemFontDirectories)
+        || propertyName == GET_MEMBER_NAME_CHECKED(UDevEditor, bCollapseDuplicateFonts))
+    {
+        FEFFontScanner::Get().Invalidate();
+        Super::PostEditChangeProperty(PropertyChangedEvent);
+        SaveSettingToConfig();
+        return;
+    }
+    if (propertyName == GET_MEMBER_NAME_CHECKED(UDevEditor, ActiveProfile))
+    {
+        ApplyFontProfile(ActiveProfile);
+        Super::PostEditChangeProperty(PropertyChangedEvent);
+        return;
+    }
+    if (propertyName == GET_MEMBER_NAME_CHECKED(UDevEditor, FontFamily))
+    {
+        ApplyFontFamily(FontFamily);
+        Super::PostEditChangeProperty(PropertyChangedEvent);
+        return;
+    }
+    if (propertyName == GET_MEMBER_NAME_CHECKED(UDevEditor, FontBackend))
+    {
+        // There are only two backends, so the one being left is the other one.
+        const EEFFontBackend NewBackend = FontBackend;
+        FontBackend = NewBackend == EEFFontBackend::CompositeFont ? EEFFontBackend::ReplaceFiles : EEFFontBackend::CompositeFont;
+        SwitchFontBackend(NewBackend);
+        Super::PostEditChangeProperty(PropertyChangedEvent);
+        SaveSettingToConfig();
+        return;
+    }
     auto propertyNameString = propertyName.ToString();
     auto ptr = this->GetClass()->FindPropertyByName(propertyName)->ContainerPtrToValuePtr<FIntProperty>(this);
     if (propertyNameString == "ToggleSettingsEditable") { SaveSettingToConfig(); return; }
@@ -210,6 +474,7 @@ void UDevEditor::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyCh
     {
         UE_LOG(LogTemp, Warning, TEXT("Font Path modified!"));
         this->CreateTempFontsFolder();
+        FEFFontScanner::Get().Invalidate();
         FFilePath NewPath;
         
     }
@@ -221,25 +486,31 @@ void UDevEditor::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyCh
 
 FString UDevEditor::GetConfigFilename()
 {
-    //return FPaths::Combine(*FPaths::EnginePluginsDir(), TEXT("Marketplace"), TEXT("Config"), TEXT("EditorFontConfig.ini"));
-    
-    return FConfigCacheIni::NormalizeConfigIniPath(FPaths::Combine(FPaths::GetProjectFilePath(), TEXT("Intermediate"), TEXT("Config"), TEXT("CoalescedSourceConfigs"), TEXT("Setting.ini")));
+    // The file SaveSettingToConfig writes, so the load cache sees its own writes.
+    return GetDefaultConfigFilename();
 }
 
 void UDevEditor::LoadConfigFile()
 {
+    EF_TRACE_SCOPE("EditorFont::LoadConfigFile");
     UDevEditor* Setting = GetMutableDefault<UDevEditor>();
     check(Setting);
-    Setting->LoadConfig(Setting->GetClass(), *GetConfigFilename());
-
+    const FString ConfigFilename = GetConfigFilename();
+    // Panel rebuilds call this every time, skip the re-read when the file has not changed.
+    if (!FEFConfigWriter::Get().ShouldReload(ConfigFilename)) { return; }
+    Setting->LoadConfig(Setting->GetClass(), *ConfigFilename);
+    FEFConfigWriter::Get().NotifyLoaded(ConfigFilename);
 }
 
 
 void UDevEditor::SaveSettingToConfig()
 {
+    EF_TRACE_SCOPE("EditorFont::SaveSettingToConfig");
     UDevEditor* Setting = GetMutableDefault<UDevEditor>();
     check(Setting);
-    Setting->SaveConfig(CPF_Config, *Setting->GetDefaultConfigFilename());
+    if (Setting->bSuppressConfigSave) { return; }
+    // Coalesced, SaveConfig runs once after the changes settle.
+    FEFConfigWriter::Get().MarkDirty(Setting, Setting->GetDefaultConfigFilename());
 }
 
 void UDevEditor::MyOnResetDefaults()
@@ -261,133 +532,89 @@ void UDevEditor::MyOnResetDefaults()
 
 bool UDevEditor::ResetToDefaults(FProperty* InProperty)
 {
-    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-
-    FString Font = "";
-    int counter = 0;
-    // Get the UClass of the object
-    UClass* Class = this->GetClass();
-
-    if (!Class)
-    {
-        UE_LOG(LogTemp, Warning, TEXT("Class is null"));
-        return false;
-    }
+    EF_TRACE_SCOPE("EditorFont::ResetToDefaults");
+    TArray<const FProperty*> Slots;
 
     /******************************************Singleton reset************************************/
     if (InProperty != nullptr)
     {
-        
-        FName filename = FName("FileName");
-        // test this
-        if (InProperty->HasMetaData(filename))
-        {
-            Font = InProperty->GetMetaDataText(filename).ToString(); // Access the FileName metadata
-        }
-
         FName PropertyFName = InProperty->GetFName();
         auto ptr = this->GetClass()->FindPropertyByName(PropertyFName)->ContainerPtrToValuePtr<FNameProperty>(this);
         InProperty->ClearValue(ptr); 
-        FString DestFontPath = InProperty->GetBoolMetaData("AlternateFont") ? FPaths::EngineContentDir() / TEXT("Editor/Slate/Fonts/") : FPaths::EngineContentDir() / TEXT("Slate/Fonts/");
-        FString defaultFont = PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*(Defaults + "/" + Font));
-        FString FontToChange = PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*(DestFontPath + "/" + Font));
-
-        if (PlatformFile.DeleteFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange)))
-        {
-            if (!PlatformFile.CopyFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange), *defaultFont))
-            {
-                UE_LOG(LogTemp, Warning, TEXT("Property failed to reset. %s"), *PropertyFName.ToString());
-                return false;
-            }
-        }
-        else if (!PlatformFile.FileExists(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange)))
-        {
-            if (!PlatformFile.CopyFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange), *defaultFont))
-            {
-                UE_LOG(LogTemp, Warning, TEXT("Property failed to reset. %s"), *PropertyFName.ToString());
-                return false;
-            }
-        }
-        else
-        {
-            UE_LOG(LogTemp, Warning, TEXT("File failed to be deleted. %s"), *PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange));
-            return false;
-        }
         UE_LOG(LogTemp, Warning, TEXT("%s property reset"), *InProperty->GetName());
-        FSlateApplication::Get().GetRenderer()->FlushFontCache(TEXT("Fonts have been updated."));
-        return true;
+        return RestoreDefaultFonts({ InProperty }, TEXT("Reset ") + InProperty->GetName());
     }
     //========================================================================================
     
-    for (TFieldIterator<FProperty> PropertyIt(Class); PropertyIt; ++PropertyIt)
+    const FString* FontPathToggle = ToggleStates.Find(GET_MEMBER_NAME_CHECKED(UDevEditor, FontPath));
+    if (FontPathToggle == nullptr || *FontPathToggle != "False")
+    {
+        FontPath = *IPluginManager::Get().FindPlugin(TEXT("EditorFont"))->GetContentDir().Append("/TempFonts");
+        CreateTempFontsFolder();
+    }
+    const TArray<FNameProperty*> SlotProperties = GetFontSlotProperties();
+    for (const EFCore::FSlotChange& Change : EFCore::PlanReset(MakeSlotStates(this, SlotProperties)))
+    {
+        FNameProperty* Slot = ToSlotChange(SlotProperties, Change).Key;
+        Slot->SetPropertyValue_InContainer(this, NAME_None);
+        Slots.Add(Slot);
+    }
+    return RestoreDefaultFonts(Slots, TEXT("Reset"));
+}
+
+bool UDevEditor::RestoreDefaultFonts(const TArray<const FProperty*>& Slots, const FString& Label)
+{
+    if (FontBackend == EEFFontBackend::CompositeFont)
     {
-        if (PropertyIt)
+        // Restoring a binding is in memory, there is no file work to move off the game thread.
+        int32 ErrorCount = 0;
+        for (const FProperty* Slot : Slots)
         {
-            if (PropertyIt->GetFullName().Equals("ToggleStates"))
+            if (!RestoreDefaultFont(Slot)) { ErrorCount++; }
+        }
+        UE_LOG(LogTemp, Warning, TEXT("Encountered %d errors."), ErrorCount);
+        FlushFontCache();
+        RecordFontSnapshot(Label);
+        return ErrorCount == 0;
+    }
+    for (const FProperty* Slot : Slots)
+    {
+        SlotsChangedSinceSnapshot.Add(Slot->GetFName());
+    }
+    // Everything the job reads is resolved here, the worker never touches the settings object.
+    TArray<FEFSlotInstall> Installs;
+    for (const FProperty* Slot : Slots)
+    {
+        Installs.Add(MakeSlotInstall(Slot, Defaults / Slot->GetMetaData(TEXT("FileName"))));
+    }
+    // Queued jobs report success, only inline runs know the result by the time this returns.
+    TSharedRef<bool> bResult = MakeShared<bool>(true);
+    FEFWorkQueue::Get().Enqueue(TEXT("Restoring default fonts"),
+        [Options = GetInstallOptions(), Installs](FEFWorkQueue::FProgress& Progress)
+        {
+            for (const FEFSlotInstall& Install : Installs)
             {
-                continue;
+                Progress.AddTotal(FMath::Max<int64>(IFileManager::Get().FileSize(*Install.Source), 0));
             }
-            if (ToggleStates.Contains(PropertyIt->GetFName()))
+            int32 ErrorCount = 0;
+            for (const FEFSlotInstall& Install : Installs)
             {
-                if (ToggleStates[PropertyIt->GetFName()] == "False")
+                if (!CopyFontToSlot(Options, Install, &Progress))
                 {
-                    continue;
-                }
-            }
-            
-            FName PropertyFName = PropertyIt->GetFName();
-            FString PropertyName = PropertyFName.ToString();
-            FString PropertyType = PropertyIt->GetClass()->GetName();
-            if (PropertyFName == GET_MEMBER_NAME_CHECKED(UDevEditor, FontChanger) || PropertyFName == TEXT("FilePath"))
-            {
-                continue;
-            }
-            auto ptr = this->GetClass()->FindPropertyByName(PropertyFName)->ContainerPtrToValuePtr<FNameProperty>(this);
-            
-            FName filename = FName("FileName");
-            if (PropertyIt->HasMetaData(filename))
-            {
-                Font = PropertyIt->GetMetaDataText(filename).ToString(); // Access the FileName metadata
-            }
-            else if (PropertyName.Equals("FontPath"))
-            {
-                FontPath = *IPluginManager::Get().FindPlugin(TEXT("EditorFont"))->GetContentDir().Append("/TempFonts");
-                CreateTempFontsFolder();
-                continue;
-            }
-            else if (PropertyName.Equals("FontChanger"))
-            {
-                continue;
-            }
-            else { continue; }
-            
-            FString DestFontPath = PropertyIt->GetBoolMetaData("AlternateFont") ? FPaths::EngineContentDir() / TEXT("Editor/Slate/Fonts/") : FPaths::EngineContentDir() / TEXT("Slate/Fonts/");
-            PropertyIt->ClearValue(ptr);
-            FString defaultFont = PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*(Defaults + "/" + Font));
-            FString FontToChange = PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*(DestFontPath + "/" + Font));
-
-            if (PlatformFile.DeleteFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange)))            {
-                if (!PlatformFile.CopyFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange), *defaultFont))                {
-                    UE_LOG(LogTemp, Warning, TEXT("Property failed to reset. %s"), *PropertyFName.ToString());
-                    counter++;
-                }
-            }
-            else if (!PlatformFile.FileExists(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange)))            {
-                if (!PlatformFile.CopyFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange), *defaultFont))                {
-                    UE_LOG(LogTemp, Warning, TEXT("Property failed to reset. %s"), *PropertyFName.ToString());
-                    counter++;
+                    UE_LOG(LogTemp, Warning, TEXT("Property failed to reset. %s"), *FPaths::GetCleanFilename(Install.Target));
+                    ErrorCount++;
                 }
             }
-            else            {
-                UE_LOG(LogTemp, Warning, TEXT("File failed to be deleted. %s"), *PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange));
-                counter++;
-            }
-        }
-    }
-    
-    UE_LOG(LogTemp, Warning, TEXT("Encountered %d errors."), counter) // why do i not need a ; here
-    FSlateApplication::Get().GetRenderer()->FlushFontCache(TEXT("Fonts have been updated."));
-    return true;
+            UE_LOG(LogTemp, Warning, TEXT("Encountered %d errors."), ErrorCount);
+            return ErrorCount == 0;
+        },
+        [this, Label, bResult](bool bRestored)
+        {
+            *bResult = bRestored;
+            FlushFontCache();
+            RecordFontSnapshot(Label);
+        });
+    return *bResult;
 }
 
 // void UDevEditor::Reset()
@@ -395,169 +622,1152 @@ bool UDevEditor::ResetToDefaults(FProperty* InProperty)
 //     UE_LOG(LogTemp, Warning, TEXT("Reset Test"))
 // }
 
-bool UDevEditor::AlterFont(FNameProperty* Property, FName Value, FString Font)
+FString UDevEditor::GetFontDestinationDir(const FProperty* Property) const
 {
-    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
-    FString DestFontPath = Property->GetBoolMetaData("AlternateFont") ? FPaths::EngineContentDir() / TEXT("Editor/Slate/Fonts/") : FPaths::EngineContentDir() / TEXT("Slate/Fonts/");
-    FString TempFont = PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*(FontPath + "/" + Value.ToString()));
-    FString FontToChange = PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*(DestFontPath + "/" + Font));
+    const FString ContentDir = FontDestinationOverride.IsEmpty() ? FPaths::EngineContentDir() : FontDestinationOverride;
+    return Property->GetBoolMetaData("AlternateFont") ? ContentDir / TEXT("Editor/Slate/Fonts/") : ContentDir / TEXT("Slate/Fonts/");
+}
+
+FString UDevEditor::GetInstalledFontPath(const FProperty* Property) const
+{
+    if (FontBackend == EEFFontBackend::CompositeFont)
+    {
+        const FString Bound = FEFCompositeFontBackend::Get().GetBoundFile(Property);
+        if (!Bound.IsEmpty()) { return Bound; }
+    }
+    return GetFontDestinationDir(Property) / Property->GetMetaData(TEXT("FileName"));
+}
+
+bool UDevEditor::IsFontSlotActive(const FProperty* Property) const
+{
+    if (!Property->HasMetaData(TEXT("Culture"))) { return true; }
+    const FString Culture = Property->GetMetaData(TEXT("Culture"));
+    // "*" marks the fallback font, Slate reaches for it in every language.
+    return Culture == TEXT("*") || Culture == FInternationalization::Get().GetCurrentLanguage()->GetTwoLetterISOLanguageName();
+}
+
+int64 UDevEditor::GetTotalFontResidentBytes() const
+{
+    int64 Total = 0;
+    for (const FNameProperty* Property : GetFontSlotProperties())
+    {
+        const FString Installed = GetInstalledFontPath(Property);
+        FEFFontStatsEntry Stats;
+        // Until the queued measurement lands the file size stands in, the face's own allocations come on top of it later.
+        Total += FEFFontStats::Get().FindOrRequestStats(Installed, Stats)
+            ? Stats.GetResidentBytes()
+            : FMath::Max<int64>(IFileManager::Get().FileSize(*Installed), 0);
+    }
+    return Total;
+}
 
-    if (PlatformFile.DeleteFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange)))
+TArray<FNameProperty*> UDevEditor::GetFontSlotProperties() const
+{
+    TArray<FNameProperty*> Slots;
+    FName filename = FName("FileName");
+    for (TFieldIterator<FNameProperty> PropertyIt(GetClass()); PropertyIt; ++PropertyIt)
     {
-        if (!PlatformFile.CopyFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange), *TempFont))
+        if (PropertyIt->HasMetaData(filename))
         {
-            UE_LOG(LogTemp, Warning, TEXT("File failed to copy. %s"), *TempFont);
-            this->ResetToDefaults(Property);
-            return false;
+            Slots.Add(*PropertyIt);
         }
-        FSlateApplication::Get().GetRenderer()->FlushFontCache(TEXT("Fonts have been updated."));
-        UE_LOG(LogTemp, Warning, TEXT("Font changed successfully!"));
-        return true;
     }
-    else if (!PlatformFile.FileExists(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange)))
+    return Slots;
+}
+
+bool UDevEditor::ReplaceFontFile(const FString& FontToChange, const FString& SourceFont, FEFWorkQueue::FProgress* Progress)
+{
+    auto& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    const FString Target = PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange);
+    FEFFontStats::Get().Invalidate(Target);
+    EF_TRACE_SCOPE("EditorFont::CopyFile");
+    TRACE_COUNTER_INCREMENT(EditorFont_FilesTouched);
+    if (FEFFontPack::IsPackMember(SourceFont))
     {
-        if (!PlatformFile.CopyFile(*PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange), *TempFont))
+        // Extracted to a temp file first, then swapped in like any other copy, so a failed extract keeps the old engine font.
+        const FString Extracted = FPaths::CreateTempFilename(*FPaths::ProjectIntermediateDir(), TEXT("EFPackMember"), *FPaths::GetExtension(Target, true));
+        std::string Error;
+        const bool bReplaced = FEFFontPack::ExtractMember(SourceFont, Extracted)
+            && EFCore::ReplaceFile(FEFCoreBridge::ToPath(Target), FEFCoreBridge::ToPath(Extracted),
+                [Progress](uint64_t Bytes) { if (Progress) { Progress->AddDone(int64(Bytes)); } }, &Error);
+        PlatformFile.DeleteFile(*Extracted);
+        if (!bReplaced)
         {
-            UE_LOG(LogTemp, Warning, TEXT("File failed to copy. %s"), *TempFont);
-            this->ResetToDefaults(Property);
+            UE_LOG(LogTemp, Warning, TEXT("File failed to copy. %s (%s)"), *SourceFont, *FEFCoreBridge::FromUtf8(Error));
             return false;
         }
-        FSlateApplication::Get().GetRenderer()->FlushFontCache(TEXT("Fonts have been updated."));
-        UE_LOG(LogTemp, Warning, TEXT("Font changed successfully!"));
+        TRACE_COUNTER_ADD(EditorFont_BytesCopied, PlatformFile.FileSize(*Target));
         return true;
     }
-    else
+    // Written next to the target and renamed over it, a failed copy keeps the old engine font.
+    // Chunked, so a multi-megabyte font on a slow disk still moves the progress notification.
+    std::string Error;
+    const bool bCopied = EFCore::ReplaceFile(FEFCoreBridge::ToPath(Target), FEFCoreBridge::ToPath(SourceFont),
+        [Progress](uint64_t Bytes) { if (Progress) { Progress->AddDone(int64(Bytes)); } }, &Error);
+    if (!bCopied)
     {
-        UE_LOG(LogTemp, Warning, TEXT("File failed to be deleted. %s"), *PlatformFile.ConvertToAbsolutePathForExternalAppForWrite(*FontToChange));
-        this->ResetToDefaults(Property);
+        UE_LOG(LogTemp, Warning, TEXT("File failed to copy. %s (%s)"), *SourceFont, *FEFCoreBridge::FromUtf8(Error));
         return false;
     }
+    TRACE_COUNTER_ADD(EditorFont_BytesCopied, PlatformFile.FileSize(*Target));
+    return true;
+}
+
+bool UDevEditor::InstallFontFile(const FProperty* Property, const FString& SourceFont)
+{
+    FEFWorkQueue::Get().Flush();
+    SlotsChangedSinceSnapshot.Add(Property->GetFName());
+    const FEFSlotInstall Install = MakeSlotInstall(Property, SourceFont);
+    if (FontBackend == EEFFontBackend::CompositeFont)
+    {
+        return FEFCompositeFontBackend::Get().Bind(Property, ResolveInstallSource(GetInstallOptions(), Install.Culture, Install.Source));
+    }
+    return CopyFontToSlot(GetInstallOptions(), Install);
 }
 
+FEFInstallOptions UDevEditor::GetInstallOptions() const
+{
+    check(IsInGameThread());
+    FEFInstallOptions Options;
+    Options.Backend = FontBackend;
+    Options.bSubsetLocalizedFonts = bSubsetLocalizedFonts;
+    Options.bOptimizeInstalledFonts = bOptimizeInstalledFonts;
+    Options.Subset = FEFSubsetter::MakeOptions(this);
+    Options.Optimize.bStripHinting = bStripFontHinting;
+    return Options;
+}
 
-UDevEditor::~UDevEditor()
+FEFSlotInstall UDevEditor::MakeSlotInstall(const FProperty* Property, const FString& SourceFont) const
 {
+    FEFSlotInstall Install;
+    Install.Culture = Property->GetMetaData(TEXT("Culture"));
+    Install.Target = GetFontDestinationDir(Property) + "/" + Property->GetMetaData(TEXT("FileName"));
+    Install.Source = FPlatformFileManager::Get().GetPlatformFile().ConvertToAbsolutePathForExternalAppForWrite(*SourceFont);
+    return Install;
 }
 
-TSharedPtr<SWidget> UDevEditor::GetCustomSettingsWidget() const
+bool UDevEditor::CopyFontToSlot(const FEFInstallOptions& Options, const FEFSlotInstall& Install, FEFWorkQueue::FProgress* Progress)
 {
-    return TSharedPtr<SWidget>();
+    return ReplaceFontFile(Install.Target, ResolveInstallSource(Options, Install.Culture, Install.Source), Progress);
 }
 
-void UDevEditor::ConvertFont(FString InFontPath, FString OutputPath)
+FString UDevEditor::ResolveInstallSource(const FEFInstallOptions& Options, const FString& Culture, const FString& SourceFont)
 {
-    if (!FPaths::FileExists(*InFontPath))
+    const bool bSubset = Options.bSubsetLocalizedFonts && !Culture.IsEmpty();
+    // The file backend copies pack members straight from the mapping, every other stage needs a real file.
+    if (Options.Backend == EEFFontBackend::ReplaceFiles && !bSubset && !Options.bOptimizeInstalledFonts && FEFFontPack::IsPackMember(SourceFont))
     {
-        InFontPath = FPaths::Combine(FPaths::ProjectDir(), InFontPath);
+        return SourceFont;
     }
-     auto TempP = InFontPath;
-    FString Directory, Filename, Extension;
-    FPaths::Split(OutputPath, Directory, Filename, Extension);
-    OutputPath = FPaths::ChangeExtension(TempP, Extension);
-    
-    UE_LOG(LogTemp, Warning, TEXT("Converting font to %s"), *OutputPath);
-    // Get the absolute PluginContentPath.
-    FString AbsolutePluginContentPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*PluginContentPath);
-    // Build the Python directory from PluginContentPath.
-    FString PythonDir = FPaths::Combine(AbsolutePluginContentPath, TEXT("Python"));
-
-    // Determine the FontForge executable name in a cross-platform way.
-    FString ExecutableName = TEXT("fontforge");
-#if PLATFORM_WINDOWS
-    ExecutableName += TEXT(".exe");
-#endif
-
-    FString FontForgePath = FPaths::Combine(PythonDir, TEXT("FontForge"), TEXT("bin"), ExecutableName);
-    FString ScriptFile = FPaths::Combine(PythonDir, TEXT("FontForge"), TEXT("bin"), TEXT("convert_otf_ttf.py"));
-    
-    // auto ScriptFileExists = FPaths::FileExists(*ScriptFile);
-    // auto FontForgePathExists = FPaths::FileExists(*FontForgePath);
-    // auto InPathExists = FPaths::FileExists(*InFontPath);
-    // auto OutputPathExists = FPaths::FileExists(*OutputPath);
-    // UE_LOGFMT(LogTemp, Warning, "In: {0} Out: {1} FFPath: {2} Script: {3}", InPathExists, OutputPathExists, FontForgePathExists, ScriptFileExists);
-    if (FPaths::FileExists(*OutputPath))
+    FString Source = ResolveFontSource(SourceFont);
+    if (Source.IsEmpty())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Could not extract %s"), *SourceFont);
+        return Source;
+    }
+    if (bSubset)
+    {
+        FString Subset = FEFSubsetter::SubsetFont(Options.Subset, Source, Culture);
+        if (Subset.IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Subsetting failed, installing the whole font. %s"), *Source);
+        }
+        else
+        {
+            Source = Subset;
+        }
+    }
+    if (Options.bOptimizeInstalledFonts)
     {
-        DebugHeader::ShowNotifyInfo(FString("File already exists in directory"), SNotificationItem::CS_Fail);
+        FString Optimized = FEFFontOptimizer::OptimizeFont(Source, Options.Optimize);
+        if (Optimized.IsEmpty())
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Optimization failed, installing the font as it is. %s"), *Source);
+        }
+        else
+        {
+            Source = Optimized;
+        }
+    }
+    return Source;
+}
 
-        UE_LOGFMT(LogTemp, Warning, "File already exists in directory.");
-        return;
+bool UDevEditor::RestoreDefaultFont(const FProperty* Property)
+{
+    SlotsChangedSinceSnapshot.Add(Property->GetFName());
+    if (FontBackend == EEFFontBackend::CompositeFont)
+    {
+        return FEFCompositeFontBackend::Get().Restore(Property);
     }
-    
-    FString Args = FString::Printf(TEXT("-lang=py -script \"%s\" \"%s\" \"%s\""), *ScriptFile, *InFontPath, *OutputPath);
-    UE_LOG(LogTemp, Warning, TEXT("FontForge args: %s %s"), *FontForgePath, *Args);
-    LaunchAndCaptureProcessOutput(FontForgePath, Args);
+    if (!InstallFontFile(Property, Defaults + "/" + Property->GetMetaData(TEXT("FileName"))))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Property failed to reset. %s"), *Property->GetName());
+        return false;
+    }
+    return true;
+}
 
-    FString Message = "Successfully converted font: ";
-    Message.Append(Filename);
-    
+void UDevEditor::FlushFontCache()
+{
+    if (!FSlateApplication::IsInitialized()) { return; } // commandlets have no renderer
+    EF_TRACE_SCOPE("EditorFont::FlushFontCache");
+    if (FontBackend == EEFFontBackend::CompositeFont)
+    {
+        FEFCompositeFontBackend::Get().Flush();
+    }
+    else
+    {
+        TRACE_COUNTER_INCREMENT(EditorFont_FlushCount);
+        FSlateApplication::Get().GetRenderer()->FlushFontCache(TEXT("Fonts have been updated."));
+    }
+    if (bGenerateSdfAtlases)
+    {
+        FEFSdfAtlas::QueueForSlots(this);
+    }
+}
 
-    DebugHeader::ShowNotifyInfo(FString(Message), SNotificationItem::CS_Success);
+void UDevEditor::SwitchFontBackend(EEFFontBackend NewBackend)
+{
+    if (NewBackend == FontBackend) { return; }
+    EF_TRACE_SCOPE("EditorFont::SwitchFontBackend");
+    FEFWorkQueue::Get().Flush();
+    const TArray<FNameProperty*> Slots = GetFontSlotProperties();
+    for (const FNameProperty* Property : Slots)
+    {
+        RestoreDefaultFont(Property);
+    }
+    // Flush under each backend, each one only knows how to flush its own changes.
+    FlushFontCache();
+    FontBackend = NewBackend;
+    for (const FNameProperty* Property : Slots)
+    {
+        const FName Value = Property->GetPropertyValue_InContainer(this);
+        if (Value.IsNone()) { continue; }
+        if (!InstallFontFile(Property, ResolveFontValue(Value)))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%s could not be applied with the new backend"), *Property->GetName());
+        }
+    }
+    FlushFontCache();
 }
 
-void UDevEditor::ConvertFontFolder(FProperty* InProperty, FString Path)
+void UDevEditor::ApplyCompositeFontBindings()
 {
-    bool bConverted;
-    int ErrorCount = 0;
-    if (FPaths::DirectoryExists(Path))
+    if (FontBackend != EEFFontBackend::CompositeFont) { return; }
+    EF_TRACE_SCOPE("EditorFont::ApplyCompositeFontBindings");
+    FEFWorkQueue::Get().Flush();
+    for (const FNameProperty* Property : GetFontSlotProperties())
     {
-        TArray<FString> Files; 
-        GetFontsFromFolder(Files, Path);
-        for (auto File : Files)
+        const FName Value = Property->GetPropertyValue_InContainer(this);
+        if (Value.IsNone()) { continue; }
+        InstallFontFile(Property, ResolveFontValue(Value));
+    }
+    FlushFontCache();
+}
+
+bool UDevEditor::AlterFont(FNameProperty* Property, FName Value, FString Font)
+{
+    EF_TRACE_SCOPE("EditorFont::AlterFont");
+    auto OnInstalled = [this, Property](bool bInstalled)
         {
-            File = FPaths::Combine(Path, File);
-            if (FPaths::FileExists(File))
+            if (!bInstalled)
             {
-                FFilePath NewPath;
-                NewPath.FilePath = File;
-                bConverted = HandleConversion(NewPath);
-                if (!bConverted)
+                this->ResetToDefaults(Property);
+                return;
+            }
+            FlushFontCache();
+            RecordFontSnapshot(Property->GetName());
+            UE_LOG(LogTemp, Warning, TEXT("Font changed successfully!"));
+        };
+    if (FontBackend == EEFFontBackend::CompositeFont)
+    {
+        // Nothing is copied, the rebinding is in memory.
+        const bool bInstalled = InstallFontFile(Property, ResolveFontValue(Value));
+        OnInstalled(bInstalled);
+        return bInstalled;
+    }
+    SlotsChangedSinceSnapshot.Add(Property->GetFName());
+    TSharedRef<bool> bResult = MakeShared<bool>(true);
+    FEFWorkQueue::Get().Enqueue(FString::Printf(TEXT("Installing %s"), *Value.ToString()),
+        [Options = GetInstallOptions(), Install = MakeSlotInstall(Property, ResolveFontValue(Value))](FEFWorkQueue::FProgress& Progress)
+        {
+            // Pack members and collection faces have no size of their own.
+            Progress.AddTotal(FMath::Max<int64>(IFileManager::Get().FileSize(*Install.Source), 0));
+            return CopyFontToSlot(Options, Install, &Progress);
+        },
+        [OnInstalled, bResult](bool bInstalled)
+        {
+            *bResult = bInstalled;
+            OnInstalled(bInstalled);
+        });
+    return *bResult;
+}
+
+TArray<FString> UDevEditor::GetAllFonts()
+{
+    return GetFontsWithExtension(FString());
+}
+
+TArray<FString> UDevEditor::GetFontsCoveringScript(FEFCoverage::EScript Script, const FString& Extension)
+{
+    TArray<FString> Paths = GetFontLibrary();
+    Paths.RemoveAll([&Extension](const FString& Path)
+        {
+            return !Extension.IsEmpty() && FPaths::GetExtension(Path, true) != Extension && !FEFFontCollection::IsCollectionFile(FEFFontCollection::GetFilePart(Path));
+        });
+    TArray<FString> NewArray;
+    for (const FString& Path : FEFFontIndex::Get().FilterByCoverage(Paths, FEFCoverage::GetScriptRequirement(Script)))
+    {
+        NewArray.Add(MakeFontValue(Path));
+    }
+    if (NewArray.Num() < 1){ NewArray.Add("No font in the folder covers this script."); }
+    return NewArray;
+}
+
+TArray<FString> UDevEditor::GetArabicFonts()
+{
+    return GetFontsCoveringScript(FEFCoverage::EScript::Arabic, TEXT(".ttf"));
+}
+
+TArray<FString> UDevEditor::GetThaiFonts()
+{
+    return GetFontsCoveringScript(FEFCoverage::EScript::Thai, TEXT(".ttf"));
+}
+
+TArray<FString> UDevEditor::GetJapaneseFonts()
+{
+    return GetFontsCoveringScript(FEFCoverage::EScript::Japanese, TEXT(".otf"));
+}
+
+TArray<FString> UDevEditor::GetKoreanFonts()
+{
+    return GetFontsCoveringScript(FEFCoverage::EScript::Korean, TEXT(".ttf"));
+}
+
+TArray<FString> UDevEditor::GetVariableFonts()
+{
+    TArray<FString> NewArray;
+    FEFFontIndexEntry Entry;
+    for (const FString& Path : GetFontLibrary())
+    {
+        if (FEFFontIndex::Get().GetEntry(Path, Entry) && Entry.bVariable)
+        {
+            NewArray.Add(MakeFontValue(Path));
+        }
+    }
+    if (NewArray.Num() < 1){ NewArray.Add("No variable font in the folder."); }
+    return NewArray;
+}
+
+TArray<FString> UDevEditor::GetFontSlotNames()
+{
+    TArray<FString> Names;
+    for (FNameProperty* Slot : GetFontSlotProperties())
+    {
+        Names.Add(Slot->GetName());
+    }
+    return Names;
+}
+
+TArray<FString> UDevEditor::GetLatinSlotNames()
+{
+    TArray<FString> Names;
+    for (FNameProperty* Slot : GetFontSlotProperties())
+    {
+        if (!Slot->HasMetaData(TEXT("Culture"))) { Names.Add(Slot->GetName()); }
+    }
+    return Names;
+}
+
+TArray<FString> UDevEditor::GetCjkSlotNames()
+{
+    TArray<FString> Names;
+    for (FNameProperty* Slot : GetFontSlotProperties())
+    {
+        const FString Culture = Slot->GetMetaData(TEXT("Culture"));
+        if (Culture == TEXT("ja") || Culture == TEXT("ko") || Culture.StartsWith(TEXT("zh")) || Culture == TEXT("*"))
+        {
+            Names.Add(Slot->GetName());
+        }
+    }
+    return Names;
+}
+
+TArray<FString> UDevEditor::GetProfileNames()
+{
+    TArray<FString> Names;
+    for (const FEFFontProfile& Profile : FontProfiles)
+    {
+        Names.Add(Profile.Name.ToString());
+    }
+    return Names;
+}
+
+void UDevEditor::CaptureFontProfile(FName ProfileName)
+{
+    if (ProfileName.IsNone()) { return; }
+    FEFFontProfile* Profile = FontProfiles.FindByPredicate([ProfileName](const FEFFontProfile& P) { return P.Name == ProfileName; });
+    if (Profile == nullptr)
+    {
+        Profile = &FontProfiles.AddDefaulted_GetRef();
+        Profile->Name = ProfileName;
+    }
+    Profile->Slots.Reset();
+    for (FNameProperty* Slot : GetFontSlotProperties())
+    {
+        Profile->Slots.Add(Slot->GetFName(), Slot->GetPropertyValue_InContainer(this));
+    }
+    SaveSettingToConfig();
+    UE_LOG(LogTemp, Warning, TEXT("Captured current fonts into profile %s"), *ProfileName.ToString());
+}
+
+bool UDevEditor::ApplyFontProfile(FName ProfileName)
+{
+    EF_TRACE_SCOPE("EditorFont::ApplyFontProfile");
+    const FEFFontProfile* Profile = FontProfiles.FindByPredicate([ProfileName](const FEFFontProfile& P) { return P.Name == ProfileName; });
+    if (Profile == nullptr)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No font profile named %s"), *ProfileName.ToString());
+        return false;
+    }
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Stage 1: diff. A slot missing from the profile means the shipped default.
+    const TArray<FNameProperty*> SlotProperties = GetFontSlotProperties();
+    std::map<std::string, std::string> Targets;
+    for (const TPair<FName, FName>& Slot : Profile->Slots)
+    {
+        Targets[FEFCoreBridge::ToUtf8(Slot.Key.ToString())] = Slot.Value.IsNone() ? std::string() : FEFCoreBridge::ToUtf8(Slot.Value.ToString());
+    }
+    TArray<TPair<FNameProperty*, FName>> Changes;
+    for (const EFCore::FSlotChange& Change : EFCore::PlanInstall(MakeSlotStates(this, SlotProperties), Targets))
+    {
+        Changes.Add(ToSlotChange(SlotProperties, Change));
+    }
+    if (Changes.Num() == 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Profile %s is already applied."), *ProfileName.ToString());
+        return true;
+    }
+
+    TSharedRef<bool> bResult = MakeShared<bool>(true);
+    InstallSlotChanges(Changes, TEXT("Applying profile ") + ProfileName.ToString(),
+        [this, ProfileName, NumChanges = Changes.Num(), StartTime, bResult](int32 ErrorCount)
+        {
+            *bResult = ErrorCount == 0;
+            if (ErrorCount < 0) { return; }
+            ActiveProfile = ProfileName;
+            FlushFontCache();
+            RecordFontSnapshot(TEXT("Profile ") + ProfileName.ToString());
+            SaveSettingToConfig();
+            UE_LOG(LogTemp, Warning, TEXT("Applied profile %s: %d slots changed, %d errors, %.1f ms"), *ProfileName.ToString(), NumChanges, ErrorCount, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        });
+    return *bResult;
+}
+
+bool UDevEditor::ExportFontPack(FName ProfileName, const FString& PackFile)
+{
+    EF_TRACE_SCOPE("EditorFont::ExportFontPack");
+    const FEFFontProfile* Profile = FontProfiles.FindByPredicate([ProfileName](const FEFFontProfile& P) { return P.Name == ProfileName; });
+    if (Profile == nullptr)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No font profile named %s"), *ProfileName.ToString());
+        return false;
+    }
+
+    // Members follow slot order, so applying the pack reads it front to back. A font used by several slots is stored once.
+    TArray<TPair<FString, FString>> Fonts;
+    TMap<FString, FString> Slots;
+    TMap<FString, FString> MemberBySource;
+    for (FNameProperty* Slot : GetFontSlotProperties())
+    {
+        const FName* Value = Profile->Slots.Find(Slot->GetFName());
+        if (Value == nullptr || Value->IsNone()) { continue; }
+        const FString Resolved = ResolveFontValue(*Value);
+        if (const FString* Existing = MemberBySource.Find(Resolved))
+        {
+            Slots.Add(Slot->GetName(), *Existing);
+            continue;
+        }
+        const FString Source = ResolveFontSource(Resolved);
+        if (Source.IsEmpty() || !FPaths::FileExists(Source))
+        {
+            UE_LOG(LogTemp, Error, TEXT("Missing font %s for %s"), *Value->ToString(), *Slot->GetName());
+            return false;
+        }
+        FString File;
+        int32 FaceIndex = 0;
+        const bool bFace = FEFFontCollection::SplitFacePath(Resolved, File, FaceIndex);
+        const FString BaseName = bFace ? FString::Printf(TEXT("%s-%d"), *FPaths::GetBaseFilename(File), FaceIndex) : FPaths::GetBaseFilename(Resolved);
+        const FString Extension = FPaths::GetExtension(Source, true);
+        FString Name = BaseName + Extension;
+        for (int32 Suffix = 2; Fonts.ContainsByPredicate([&Name](const TPair<FString, FString>& Font) { return Font.Key == Name; }); Suffix++)
+        {
+            Name = FString::Printf(TEXT("%s-%d%s"), *BaseName, Suffix, *Extension);
+        }
+        Fonts.Emplace(Name, Source);
+        MemberBySource.Add(Resolved, Name);
+        Slots.Add(Slot->GetName(), Name);
+    }
+    if (!FEFFontPack::Write(PackFile, Fonts, Slots))
+    {
+        UE_LOG(LogTemp, Error, TEXT("Failed to write font pack %s"), *PackFile);
+        return false;
+    }
+    FEFFontScanner::Get().Invalidate();
+    UE_LOG(LogTemp, Warning, TEXT("Packed profile %s into %s: %d fonts, %s"), *ProfileName.ToString(), *PackFile, Fonts.Num(), *FText::AsMemory(IFileManager::Get().FileSize(*PackFile)).ToString());
+    return true;
+}
+
+bool UDevEditor::ApplyFontPack(const FString& PackFile)
+{
+    EF_TRACE_SCOPE("EditorFont::ApplyFontPack");
+    const TSharedPtr<FEFFontPack> Pack = FEFFontPack::Open(PackFile);
+    if (!Pack)
+    {
+        return false;
+    }
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Slots point into the pack, a slot the pack does not map goes back to the shipped default.
+    const FString AbsolutePack = FPaths::ConvertRelativePathToFull(PackFile);
+    TArray<TPair<FNameProperty*, FName>> Changes;
+    for (FNameProperty* Slot : GetFontSlotProperties())
+    {
+        if (ToggleStates.Contains(Slot->GetFName()) && ToggleStates[Slot->GetFName()] == "False")
+        {
+            continue;
+        }
+        const FString* Member = Pack->GetSlots().Find(Slot->GetName());
+        const FName TargetValue = Member ? FName(*MakeFontValue(AbsolutePack / *Member)) : NAME_None;
+        if (Slot->GetPropertyValue_InContainer(this) != TargetValue)
+        {
+            Changes.Emplace(Slot, TargetValue);
+        }
+    }
+    if (Changes.Num() == 0)
+    {
+        UE_LOG(LogTemp, Log, TEXT("Font pack %s is already applied."), *PackFile);
+        return true;
+    }
+    TSharedRef<bool> bResult = MakeShared<bool>(true);
+    InstallSlotChanges(Changes, TEXT("Applying pack ") + FPaths::GetBaseFilename(PackFile),
+        [this, PackFile, NumChanges = Changes.Num(), StartTime, bResult](int32 ErrorCount)
+        {
+            *bResult = ErrorCount == 0;
+            if (ErrorCount < 0) { return; }
+            FlushFontCache();
+            RecordFontSnapshot(TEXT("Pack ") + FPaths::GetBaseFilename(PackFile));
+            SaveSettingToConfig();
+            UE_LOG(LogTemp, Warning, TEXT("Applied font pack %s: %d slots changed, %d errors, %.1f ms"), *PackFile, NumChanges, ErrorCount, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        });
+    return *bResult;
+}
+
+void UDevEditor::InstallSlotChanges(const TArray<TPair<FNameProperty*, FName>>& Changes, const FString& Label, TUniqueFunction<void(int32)> OnInstalled)
+{
+    // Everything the job reads is resolved here. A change to None installs the shipped default.
+    TArray<FEFSlotInstall> Installs;
+    TArray<FEFSlotInstall> DefaultInstalls;
+    for (const TPair<FNameProperty*, FName>& Change : Changes)
+    {
+        const FEFSlotInstall Default = MakeSlotInstall(Change.Key, Defaults / Change.Key->GetMetaData(TEXT("FileName")));
+        Installs.Add(Change.Value.IsNone() ? Default : MakeSlotInstall(Change.Key, ResolveFontValue(Change.Value)));
+        DefaultInstalls.Add(Default);
+    }
+    // Per change: whether the file backend's copy or the composite backend's install stages worked, and the file to bind.
+    TSharedRef<TArray<bool>> Copied = MakeShared<TArray<bool>>();
+    TSharedRef<TArray<FString>> Resolved = MakeShared<TArray<FString>>();
+    TSharedRef<bool> bValid = MakeShared<bool>(true);
+    FEFWorkQueue::Get().Enqueue(Label,
+        [Options = GetInstallOptions(), Changes, Installs, DefaultInstalls, Copied, Resolved, bValid](FEFWorkQueue::FProgress& Progress)
+        {
+            // Validate every source before touching the engine fonts.
+            for (int32 Index = 0; Index < Changes.Num(); Index++)
+            {
+                if (Changes[Index].Value.IsNone()) { continue; }
+                const FString& Source = Installs[Index].Source;
+                if (!FontSourceExists(Source))
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Missing font %s for %s"), *Changes[Index].Value.ToString(), *FPaths::GetCleanFilename(Installs[Index].Target));
+                    *bValid = false;
+                    return false;
+                }
+                // Pack members were checked when the pack was written.
+                const EFCore::EFontFileError Error = FEFFontPack::IsPackMember(Source)
+                    ? EFCore::EFontFileError::None
+                    : EFCore::ValidateFontFile(FEFCoreBridge::ToPath(FEFFontCollection::GetFilePart(Source)));
+                if (Error != EFCore::EFontFileError::None)
+                {
+                    UE_LOG(LogTemp, Error, TEXT("Font %s for %s is broken: %s"), *Changes[Index].Value.ToString(), *FPaths::GetCleanFilename(Installs[Index].Target), ANSI_TO_TCHAR(EFCore::LexToString(Error)));
+                    *bValid = false;
+                    return false;
+                }
+            }
+            Copied->Init(false, Installs.Num());
+            Resolved->Init(FString(), Installs.Num());
+            for (const FEFSlotInstall& Install : Installs)
+            {
+                Progress.AddTotal(FMath::Max<int64>(IFileManager::Get().FileSize(*Install.Source), 0));
+            }
+            bool bAllInstalled = true;
+            for (int32 Index = 0; Index < Installs.Num(); Index++)
+            {
+                if (Options.Backend == EEFFontBackend::CompositeFont)
+                {
+                    // Binding is in memory and happens on the game thread, only the install stages run here.
+                    (*Resolved)[Index] = Changes[Index].Value.IsNone() ? FString() : ResolveInstallSource(Options, Installs[Index].Culture, Installs[Index].Source);
+                    (*Copied)[Index] = Changes[Index].Value.IsNone() || !(*Resolved)[Index].IsEmpty();
+                }
+                else
+                {
+                    (*Copied)[Index] = CopyFontToSlot(Options, Installs[Index], &Progress);
+                    if (!(*Copied)[Index]) { CopyFontToSlot(Options, DefaultInstalls[Index]); }
+                }
+                bAllInstalled &= (*Copied)[Index];
+            }
+            return bAllInstalled;
+        },
+        [this, Backend = FontBackend, Changes, Copied, Resolved, bValid, OnInstalled = MoveTemp(OnInstalled)](bool bAllInstalled)
+        {
+            if (!*bValid)
+            {
+                OnInstalled(-1);
+                return;
+            }
+            int32 ErrorCount = 0;
+            for (int32 Index = 0; Index < Changes.Num(); Index++)
+            {
+                FNameProperty* Slot = Changes[Index].Key;
+                SlotsChangedSinceSnapshot.Add(Slot->GetFName());
+                bool bInstalled = Copied->IsValidIndex(Index) && (*Copied)[Index];
+                if (bInstalled && Backend == EEFFontBackend::CompositeFont)
+                {
+                    bInstalled = Changes[Index].Value.IsNone()
+                        ? FEFCompositeFontBackend::Get().Restore(Slot)
+                        : FEFCompositeFontBackend::Get().Bind(Slot, (*Resolved)[Index]);
+                }
+                if (!bInstalled)
                 {
                     ErrorCount++;
+                    if (Backend == EEFFontBackend::CompositeFont) { FEFCompositeFontBackend::Get().Restore(Slot); }
+                    Slot->SetPropertyValue_InContainer(this, NAME_None);
+                    continue;
                 }
+                Slot->SetPropertyValue_InContainer(this, Changes[Index].Value);
+            }
+            OnInstalled(ErrorCount);
+        });
+}
+
+TArray<FString> UDevEditor::GetFontFamilies()
+{
+    TSet<FString> Families;
+    for (const FEFFontIndexEntry& Entry : FEFFontIndex::Get().GetEntries(GetFontLibrary()))
+    {
+        if (!Entry.FamilyName.IsEmpty()) { Families.Add(Entry.FamilyName); }
+    }
+    TArray<FString> NewArray = Families.Array();
+    NewArray.Sort();
+    if (NewArray.Num() < 1){ NewArray.Add("No font families in the folder."); }
+    return NewArray;
+}
+
+bool UDevEditor::ApplyFontFamily(FName Family)
+{
+    EF_TRACE_SCOPE("EditorFont::ApplyFontFamily");
+    const double StartTime = FPlatformTime::Seconds();
+    if (Family.IsNone())
+    {
+        return false;
+    }
+    TArray<FEFFontIndexEntry> Members = FEFFontIndex::Get().GetEntries(GetFontLibrary());
+    Members.RemoveAll([&Family](const FEFFontIndexEntry& Entry) { return Entry.FamilyName != Family.ToString(); });
+    if (Members.Num() == 0)
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No fonts of family %s in the font folders"), *Family.ToString());
+        return false;
+    }
+
+    // Every unlocked slot that maps to a different member than it has now.
+    TArray<TPair<FNameProperty*, FName>> Changes;
+    for (const TPair<FNameProperty*, FString>& Mapped : FEFFamilyMapper::MapFamily(Members, GetFontSlotProperties()))
+    {
+        if (ToggleStates.Contains(Mapped.Key->GetFName()) && ToggleStates[Mapped.Key->GetFName()] == "False") { continue; }
+        const FName Value(*MakeFontValue(Mapped.Value));
+        if (Mapped.Key->GetPropertyValue_InContainer(this) != Value)
+        {
+            Changes.Emplace(Mapped.Key, Value);
+        }
+    }
+    TSharedRef<bool> bResult = MakeShared<bool>(true);
+    InstallSlotChanges(Changes, TEXT("Applying family ") + Family.ToString(),
+        [this, Family, NumMembers = Members.Num(), NumChanges = Changes.Num(), StartTime, bResult](int32 ErrorCount)
+        {
+            *bResult = ErrorCount == 0;
+            if (ErrorCount < 0) { return; }
+            FlushFontCache();
+            RecordFontSnapshot(TEXT("Family ") + Family.ToString());
+            SaveSettingToConfig();
+            UE_LOG(LogTemp, Warning, TEXT("Applied family %s (%d members): %d slots changed, %d errors, %.1f ms"), *Family.ToString(), NumMembers, NumChanges, ErrorCount, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        });
+    return *bResult;
+}
+
+bool UDevEditor::ApplyVariableFont()
+{
+    EF_TRACE_SCOPE("EditorFont::ApplyVariableFont");
+    const FString Value = ResolveFontValue(VariableFont);
+    const FString Source = VariableFont.IsNone() ? FString() : ResolveFontSource(Value);
+    if (Source.IsEmpty() || !FPaths::FileExists(Source))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("No variable font selected."));
+        return false;
+    }
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Stage 1: the instance each unlocked slot wants, and the file in FontPath it lands in.
+    const FString BaseName = FPaths::GetBaseFilename(FEFFontCollection::GetFilePart(Value));
+    TArray<FNameProperty*> Slots;
+    TArray<FString> Specs;
+    TArray<FString> FileNames;
+    for (FNameProperty* Slot : GetFontSlotProperties())
+    {
+        if (!Slot->HasMetaData(TEXT("Axes"))) { continue; }
+        if (ToggleStates.Contains(Slot->GetFName()) && ToggleStates[Slot->GetFName()] == "False") { continue; }
+        const FString* Override = VariableInstanceOverrides.Find(Slot->GetFName());
+        Slots.Add(Slot);
+        Specs.Add(Override && !Override->IsEmpty() ? *Override : Slot->GetMetaData(TEXT("Axes")));
+        FString SlotName = Slot->GetName();
+        SlotName.RemoveFromEnd(TEXT("Font"));
+        FileNames.Add(BaseName + "-" + SlotName + FPaths::GetExtension(Source, true));
+    }
+
+    // Stage 2 on the work queue: one parse of the variable font writes every instance that is not cached yet,
+    // and the instances are copied to FontPath so the slots point at real files.
+    TSharedRef<TArray<bool>> Copied = MakeShared<TArray<bool>>();
+    TSharedRef<bool> bResult = MakeShared<bool>(true);
+    FEFWorkQueue::Get().Enqueue(TEXT("Instancing ") + VariableFont.ToString(),
+        [Options = FEFVariableFont::MakeOptions(this), Source, Specs, FileNames, Dir = FontPath, Copied](FEFWorkQueue::FProgress& Progress)
+        {
+            TArray<FString> Instances;
+            const bool bAllBuilt = FEFVariableFont::GenerateInstances(Options, Source, Specs, Instances);
+            Copied->Init(false, Specs.Num());
+            if (Instances.Num() != Specs.Num()) { return false; }
+            for (int32 Index = 0; Index < Specs.Num(); Index++)
+            {
+                (*Copied)[Index] = !Instances[Index].IsEmpty() && IFileManager::Get().Copy(*(Dir / FileNames[Index]), *Instances[Index]) == COPY_OK;
+            }
+            return bAllBuilt;
+        },
+        // Stage 3: the written instances go through the queued slot install, which flushes once and records.
+        [this, Slots, FileNames, Copied, bResult, StartTime, Label = VariableFont.ToString()](bool bAllBuilt)
+        {
+            FEFFontScanner::Get().Invalidate();
+            TArray<TPair<FNameProperty*, FName>> Changes;
+            int32 MissingCount = 0;
+            for (int32 Index = 0; Index < Slots.Num(); Index++)
+            {
+                if (Copied->IsValidIndex(Index) && (*Copied)[Index]) { Changes.Emplace(Slots[Index], FName(FileNames[Index])); }
+                else { MissingCount++; }
+            }
+            *bResult = MissingCount == 0;
+            InstallSlotChanges(Changes, TEXT("Installing ") + Label,
+                [this, Label, MissingCount, NumSlots = Slots.Num(), StartTime, bResult](int32 ErrorCount)
+                {
+                    const int32 TotalErrors = ErrorCount < 0 ? NumSlots : ErrorCount + MissingCount;
+                    *bResult = TotalErrors == 0;
+                    if (ErrorCount < 0) { return; }
+                    FlushFontCache();
+                    RecordFontSnapshot(TEXT("Variable font ") + Label);
+                    SaveSettingToConfig();
+                    UE_LOG(LogTemp, Warning, TEXT("Applied %s to %d slots, %d errors, %.1f ms"), *Label, NumSlots, TotalErrors, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+                });
+        });
+    return *bResult;
+}
+
+FString UDevEditor::GetSlotSourceFont(const FNameProperty* Slot) const
+{
+    const FName Value = Slot->GetPropertyValue_InContainer(this);
+    const FString Source = Value.IsNone() ? Defaults + "/" + Slot->GetMetaData(TEXT("FileName")) : ResolveFontSource(ResolveFontValue(Value));
+    return FPaths::FileExists(Source) ? Source : FString();
+}
+
+bool UDevEditor::MergeSlotFonts(bool bInstall)
+{
+    EF_TRACE_SCOPE("EditorFont::MergeSlotFonts");
+    FNameProperty* LatinSlot = FindFProperty<FNameProperty>(GetClass(), MergeLatinSlot);
+    FNameProperty* CjkSlot = FindFProperty<FNameProperty>(GetClass(), MergeCjkSlot);
+    if (LatinSlot == nullptr || CjkSlot == nullptr || !LatinSlot->HasMetaData(TEXT("FileName")) || !CjkSlot->HasMetaData(TEXT("FileName")))
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Pick a Latin and a CJK slot to merge."));
+        return false;
+    }
+    const FString LatinFont = GetSlotSourceFont(LatinSlot);
+    const FString CjkFont = GetSlotSourceFont(CjkSlot);
+    if (LatinFont.IsEmpty() || CjkFont.IsEmpty())
+    {
+        UE_LOG(LogTemp, Warning, TEXT("Missing font for %s"), LatinFont.IsEmpty() ? *LatinSlot->GetName() : *CjkSlot->GetName());
+        return false;
+    }
+
+    // The merged face lands in FontPath like converted fonts and instances, so every slot can pick it.
+    const FString FileName = FString::Printf(TEXT("Merged/%s+%s%s"), *FPaths::GetBaseFilename(LatinFont), *FPaths::GetBaseFilename(CjkFont), *FPaths::GetExtension(LatinFont, true));
+    const FString Target = FontPath / FileName;
+    TSharedRef<bool> bResult = MakeShared<bool>(true);
+    FEFWorkQueue::Get().Enqueue(TEXT("Merging fonts"),
+        [Options = FEFFontMerger::MakeOptions(this), LatinFont, CjkFont, Target](FEFWorkQueue::FProgress& Progress)
+        {
+            const FString Merged = FEFFontMerger::MergeFonts(Options, LatinFont, CjkFont);
+            return !Merged.IsEmpty() && IFileManager::Get().MakeDirectory(*FPaths::GetPath(Target), true) && IFileManager::Get().Copy(*Target, *Merged) == COPY_OK;
+        },
+        [this, LatinSlot, FileName, bInstall, bResult](bool bMerged)
+        {
+            *bResult = bMerged;
+            if (!bMerged)
+            {
+                FEFWorkQueue::Get().Notify(TEXT("Could not merge the fonts, see the log."), false);
+                return;
             }
+            FEFFontScanner::Get().Invalidate();
+            if (!bInstall)
+            {
+                FEFWorkQueue::Get().Notify(TEXT("Merged font ready: ") + FileName, true);
+                return;
+            }
+            LatinSlot->SetPropertyValue_InContainer(this, FName(FileName));
+            *bResult = AlterFont(LatinSlot, FName(FileName), LatinSlot->GetMetaData(TEXT("FileName")));
+            SaveSettingToConfig();
+        });
+    return *bResult;
+}
+
+void UDevEditor::RecordFontSnapshot(const FString& Label)
+{
+    EF_TRACE_SCOPE("EditorFont::RecordFontSnapshot");
+    FEFContentCache& Cache = FEFContentCache::Get();
+    const FEFFontSnapshot* Previous = FontSnapshots.IsValidIndex(SnapshotCursor) ? &FontSnapshots[SnapshotCursor] : nullptr;
+    FEFFontSnapshot Snapshot;
+    Snapshot.Label = Label;
+    Snapshot.Time = FDateTime::Now();
+    for (const FNameProperty* Slot : GetFontSlotProperties())
+    {
+        FEFSnapshotSlot& Entry = Snapshot.Slots.Add(Slot->GetFName());
+        Entry.Value = Slot->GetPropertyValue_InContainer(this);
+        if (Entry.Value.IsNone()) { continue; }
+        // A slot nothing installed into still holds the content the previous snapshot hashed.
+        const FEFSnapshotSlot* Before = Previous ? Previous->Slots.Find(Slot->GetFName()) : nullptr;
+        if (Before && Before->Value == Entry.Value && !Before->Hash.IsEmpty() && !SlotsChangedSinceSnapshot.Contains(Slot->GetFName()))
+        {
+            Entry = *Before;
+            continue;
         }
-        if (ErrorCount == 0){ShowSuccess(InProperty, 3.0f);}
-        else{ShowSuccess(InProperty, 0.01f); UE_LOG(LogTemp, Error, TEXT("Some files may have failed to convert. Encountered %d errors."), ErrorCount);}
+        const FString Installed = GetInstalledFontPath(Slot);
+        Entry.Hash = FEFContentCache::HashFile(Installed);
+        Entry.Extension = FPaths::GetExtension(Installed, true);
+        if (Entry.Hash.IsEmpty() || !Cache.Find(TEXT("Snapshots"), Entry.Hash, Entry.Extension).IsEmpty()) { continue; }
+        const FString Staging = Cache.MakeStagingPath(Entry.Extension);
+        if (IFileManager::Get().Copy(*Staging, *Installed) != COPY_OK || !Cache.Publish(TEXT("Snapshots"), Entry.Hash, Entry.Extension, Staging))
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Could not keep a copy of %s, rolling back to it will reinstall %s"), *Installed, *Entry.Value.ToString());
+            Entry.Hash.Reset();
+        }
+    }
+    SlotsChangedSinceSnapshot.Reset();
+
+    if (Previous && Previous->Slots.OrderIndependentCompareEqual(Snapshot.Slots)) { return; }
+    // A change after stepping back drops the redo branch.
+    FontSnapshots.SetNum(SnapshotCursor + 1);
+    FontSnapshots.Add(MoveTemp(Snapshot));
+    if (FontSnapshots.Num() > MaxFontSnapshots)
+    {
+        FontSnapshots.RemoveAt(0, FontSnapshots.Num() - MaxFontSnapshots);
     }
+    SnapshotCursor = FontSnapshots.Num() - 1;
+    SaveSettingToConfig();
+}
+
+bool UDevEditor::RollbackToSnapshot(int32 Index)
+{
+    if (!FontSnapshots.IsValidIndex(Index))
+    {
+        UE_LOG(LogTemp, Log, TEXT("No font snapshot %d to step to."), Index);
+        return false;
+    }
+    EF_TRACE_SCOPE("EditorFont::RollbackToSnapshot");
+    FEFWorkQueue::Get().Flush();
+    const double StartTime = FPlatformTime::Seconds();
+    const FEFFontSnapshot& Target = FontSnapshots[Index];
+    const FEFFontSnapshot* Current = FontSnapshots.IsValidIndex(SnapshotCursor) ? &FontSnapshots[SnapshotCursor] : nullptr;
+    FEFContentCache& Cache = FEFContentCache::Get();
+    int32 Changed = 0;
+    TArray<FName> Failed;
+    for (FNameProperty* Slot : GetFontSlotProperties())
+    {
+        if (ToggleStates.Contains(Slot->GetFName()) && ToggleStates[Slot->GetFName()] == "False") { continue; }
+        const FEFSnapshotSlot* Wanted = Target.Slots.Find(Slot->GetFName());
+        const FEFSnapshotSlot* Now = Current ? Current->Slots.Find(Slot->GetFName()) : nullptr;
+        const FName WantedValue = Wanted ? Wanted->Value : NAME_None;
+        const bool bSame = Now
+            ? Now->Value == WantedValue && Now->Hash == (Wanted ? Wanted->Hash : FString())
+            : Slot->GetPropertyValue_InContainer(this) == WantedValue;
+        if (bSame && !SlotsChangedSinceSnapshot.Contains(Slot->GetFName())) { continue; }
+        Changed++;
+
+        bool bInstalled = false;
+        const FString Cached = Wanted && !Wanted->Hash.IsEmpty() ? Cache.Find(TEXT("Snapshots"), Wanted->Hash, Wanted->Extension) : FString();
+        if (WantedValue.IsNone())
+        {
+            bInstalled = RestoreDefaultFont(Slot);
+        }
+        else if (Cached.IsEmpty())
+        {
+            // The copy was evicted or never made, go through the install stages again.
+            bInstalled = FontSourceExists(ResolveFontValue(WantedValue)) && InstallFontFile(Slot, ResolveFontValue(WantedValue));
+        }
+        else if (FontBackend == EEFFontBackend::CompositeFont)
+        {
+            bInstalled = FEFCompositeFontBackend::Get().Bind(Slot, Cached);
+        }
+        else
+        {
+            bInstalled = ReplaceFontFile(GetFontDestinationDir(Slot) / Slot->GetMetaData(TEXT("FileName")), Cached);
+        }
+        if (!bInstalled)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("Could not roll %s back to %s"), *Slot->GetName(), *WantedValue.ToString());
+            RestoreDefaultFont(Slot);
+            Slot->SetPropertyValue_InContainer(this, NAME_None);
+            Failed.Add(Slot->GetFName());
+            continue;
+        }
+        Slot->SetPropertyValue_InContainer(this, WantedValue);
+    }
+    SnapshotCursor = Index;
+    // Failed slots no longer match the snapshot, the next one hashes them again.
+    SlotsChangedSinceSnapshot = TSet<FName>(Failed);
+    if (Changed > 0)
+    {
+        FlushFontCache();
+    }
+    SaveSettingToConfig();
+    UE_LOG(LogTemp, Warning, TEXT("Stepped to snapshot %d (%s): %d slots changed, %d errors, %.1f ms"), Index, *Target.Label, Changed, Failed.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return Failed.Num() == 0;
+}
+
+
+UDevEditor::~UDevEditor()
+{
 }
 
-bool UDevEditor::HandleConversion(FFilePath InPath)
+TSharedPtr<SWidget> UDevEditor::GetCustomSettingsWidget() const
 {
+    return TSharedPtr<SWidget>();
+}
+
+FEFConvertOptions UDevEditor::GetConvertOptions() const
+{
+    check(IsInGameThread());
+    FEFConvertOptions Options;
+    Options.FontForgeExecutable = GetFontForgeExecutable();
+    Options.Script = GetFontForgeScript(TEXT("convert_otf_ttf.py"));
+    return Options;
+}
+
+bool UDevEditor::ConvertFont(const FEFConvertOptions& Options, FString InFontPath, FString OutputPath, bool bNotify)
+{
+    EF_TRACE_SCOPE("EditorFont::ConvertFont");
+    if (!FPaths::FileExists(*InFontPath))
+    {
+        InFontPath = FPaths::Combine(FPaths::ProjectDir(), InFontPath);
+    }
+     auto TempP = InFontPath;
     FString Directory, Filename, Extension;
-    FPaths::Split(InPath.FilePath, Directory, Filename, Extension);
-    if (!Extension.Equals(TEXT("ttf"), ESearchCase::IgnoreCase) && !Extension.Equals(TEXT("otf"), ESearchCase::IgnoreCase))
+    FPaths::Split(OutputPath, Directory, Filename, Extension);
+    OutputPath = FPaths::ChangeExtension(TempP, Extension);
+    
+    UE_LOG(LogTemp, Warning, TEXT("Converting font to %s"), *OutputPath);
+    const FString& FontForgePath = Options.FontForgeExecutable;
+    const FString& ScriptFile = Options.Script;
+    
+    // auto ScriptFileExists = FPaths::FileExists(*ScriptFile);
+    // auto FontForgePathExists = FPaths::FileExists(*FontForgePath);
+    // auto InPathExists = FPaths::FileExists(*InFontPath);
+    // auto OutputPathExists = FPaths::FileExists(*OutputPath);
+    // UE_LOGFMT(LogTemp, Warning, "In: {0} Out: {1} FFPath: {2} Script: {3}", InPathExists, OutputPathExists, FontForgePathExists, ScriptFileExists);
+    if (FPaths::FileExists(*OutputPath))
     {
+        if (bNotify) { FEFWorkQueue::Get().Notify(FString("File already exists in directory"), false); }
+
+        UE_LOGFMT(LogTemp, Warning, "File already exists in directory.");
         return false;
     }
-    FString NewExtension;
-    if (Extension.Equals(TEXT("ttf"), ESearchCase::IgnoreCase))
+
+    // A font converted once, by any project when the cache is shared, is copied instead of converted again.
+    const FString SourceHash = FEFContentCache::HashFile(InFontPath);
+    const FString OutExtension = FPaths::GetExtension(OutputPath, true);
+    const FString Cached = SourceHash.IsEmpty() ? FString() : FEFContentCache::Get().Find(TEXT("Conversions"), SourceHash, OutExtension);
+    if (!Cached.IsEmpty() && IFileManager::Get().Copy(*OutputPath, *Cached) == COPY_OK)
     {
-        NewExtension = TEXT(".otf");
+        if (bNotify) { FEFWorkQueue::Get().Notify(FString("Successfully converted font: ") + Filename, true); }
+        return true;
     }
-    else
+    
+    FString Args = FString::Printf(TEXT("-lang=py -script \"%s\" \"%s\" \"%s\""), *ScriptFile, *InFontPath, *OutputPath);
+    UE_LOG(LogTemp, Warning, TEXT("FontForge args: %s %s"), *FontForgePath, *Args);
+    // Callers run this on the work queue, so FontForge is waited on there and only a real result counts.
+    TRACE_COUNTER_INCREMENT(EditorFont_ConversionsInFlight);
+    const int32 ReturnCode = LaunchAndCaptureProcessOutput(FontForgePath, Args, true);
+    TRACE_COUNTER_DECREMENT(EditorFont_ConversionsInFlight);
+    if (ReturnCode != 0 || !FPaths::FileExists(*OutputPath))
+    {
+        UE_LOG(LogTemp, Error, TEXT("FontForge failed to convert %s (exit code %d)"), *InFontPath, ReturnCode);
+        if (bNotify) { FEFWorkQueue::Get().Notify(FString("Failed to convert font: ") + Filename, false); }
+        return false;
+    }
+    if (!SourceHash.IsEmpty())
     {
-        NewExtension = TEXT(".ttf");
+        const FString Staging = FEFContentCache::Get().MakeStagingPath(OutExtension);
+        if (IFileManager::Get().Copy(*Staging, *OutputPath) == COPY_OK)
+        {
+            FEFContentCache::Get().Publish(TEXT("Conversions"), SourceHash, OutExtension, Staging);
+        }
     }
-    FString NewFileName = Filename + NewExtension;
-    FString NewOutputPath = FPaths::Combine(Directory, NewFileName);
 
-    ConvertFont(InPath.FilePath, NewOutputPath);
+    if (bNotify)
+    {
+        FString Message = "Successfully converted font: ";
+        Message.Append(Filename);
+        FEFWorkQueue::Get().Notify(Message, true);
+    }
     return true;
 }
 
+FString UDevEditor::GetFontForgeExecutable() const
+{
+    // Get the absolute PluginContentPath.
+    FString AbsolutePluginContentPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*PluginContentPath);
+    // Build the Python directory from PluginContentPath.
+    FString PythonDir = FPaths::Combine(AbsolutePluginContentPath, TEXT("Python"));
+
+    // Determine the FontForge executable name in a cross-platform way.
+    FString ExecutableName = TEXT("fontforge");
+#if PLATFORM_WINDOWS
+    ExecutableName += TEXT(".exe");
+#endif
+
+    FString FontForgePath = FPaths::Combine(PythonDir, TEXT("FontForge"), TEXT("bin"), ExecutableName);
+    if (FPaths::FileExists(FontForgePath))
+    {
+        return FontForgePath;
+    }
+    // Only the Windows build is bundled, elsewhere use the system install from PATH.
+    const FString Found = FindOnPath(ExecutableName);
+    return Found.IsEmpty() ? FontForgePath : Found;
+}
+
+FString UDevEditor::GetFontForgePython() const
+{
+    const FString BundledPython = GetFontForgeScript(TEXT("ffpython.exe"));
+    if (FPaths::FileExists(BundledPython))
+    {
+        return BundledPython;
+    }
+    const FString Found = FindOnPath(TEXT("python3"));
+    return Found.IsEmpty() ? FString(TEXT("python3")) : Found;
+}
+
+FString UDevEditor::FindOnPath(const FString& ExecutableName)
+{
+    TArray<FString> SearchDirs;
+    FPlatformMisc::GetEnvironmentVariable(TEXT("PATH")).ParseIntoArray(SearchDirs, FPlatformMisc::GetPathVarDelimiter());
+    for (const FString& Dir : SearchDirs)
+    {
+        FString Candidate = FPaths::Combine(Dir, ExecutableName);
+        if (FPaths::FileExists(Candidate))
+        {
+            return Candidate;
+        }
+    }
+    return FString();
+}
+
+FString UDevEditor::GetFontForgeScript(const FString& ScriptName) const
+{
+    FString AbsolutePluginContentPath = IFileManager::Get().ConvertToAbsolutePathForExternalAppForWrite(*PluginContentPath);
+    return FPaths::Combine(AbsolutePluginContentPath, TEXT("Python"), TEXT("FontForge"), TEXT("bin"), ScriptName);
+}
+
+int32 UDevEditor::ConvertFontFolder(FProperty* InProperty, FString Path)
+{
+    EF_TRACE_SCOPE("EditorFont::ConvertFontFolder");
+    if (!FPaths::DirectoryExists(Path)) { return -1; }
+    // Listing, hashing and launching FontForge for a whole folder runs on the work queue, from a snapshot of the settings.
+    TSharedRef<int32> ErrorCount = MakeShared<int32>(0);
+    FEFWorkQueue::Get().Enqueue(TEXT("Converting fonts"), [Options = GetConvertOptions(), Path, ErrorCount](FEFWorkQueue::FProgress& Progress)
+        {
+            std::vector<std::filesystem::path> Candidates;
+            for (const FString& File : FEFFontScanner::Get().Scan({ Path }))
+            {
+                Candidates.push_back(FEFCoreBridge::ToPath(File));
+            }
+            // Fonts whose other format is already in the folder are skipped, so a rerun does not convert its own outputs back.
+            const std::vector<EFCore::FConversion> Conversions = EFCore::PlanConversions(Candidates, true);
+            // One notification for the batch: per file results only feed its counters and the failure list.
+            Progress.AddItems(int32(Conversions.size()));
+            for (const EFCore::FConversion& Conversion : Conversions)
+            {
+                const FString Source = FEFCoreBridge::FromPath(Conversion.Source);
+                // One FontForge at a time, each waited on, so the counters and the ETA follow real exits.
+                const bool bOk = ConvertFont(Options, Source, FEFCoreBridge::FromPath(Conversion.Output), false);
+                if (!bOk)
+                {
+                    (*ErrorCount)++;
+                }
+                Progress.CompleteItem(bOk, FPaths::GetCleanFilename(Source));
+            }
+            return *ErrorCount == 0;
+        },
+        [this, InProperty, ErrorCount](bool bConverted)
+        {
+            if (bConverted){ShowSuccess(InProperty, 3.0f);}
+            else{ShowSuccess(InProperty, 0.01f); UE_LOG(LogTemp, Error, TEXT("Some files may have failed to convert. Encountered %d errors."), *ErrorCount);}
+        });
+    return *ErrorCount;
+}
+
+bool UDevEditor::HandleConversion(FFilePath InPath, FProperty* InProperty, bool bNotify)
+{
+    const std::optional<EFCore::FConversion> Conversion = EFCore::PlanConversion(FEFCoreBridge::ToPath(InPath.FilePath));
+    if (!Conversion)
+    {
+        UE_LOG(LogTemp, Error, TEXT("File conversion failed, %s is not a .ttf or .otf file."), *InPath.FilePath);
+        return false;
+    }
+    TSharedRef<bool> bResult = MakeShared<bool>(true);
+    // The source goes through as typed, ConvertFont still resolves it against the project directory.
+    FEFWorkQueue::Get().Enqueue(TEXT("Converting ") + FPaths::GetCleanFilename(InPath.FilePath),
+        [Options = GetConvertOptions(), Source = InPath.FilePath, Output = FEFCoreBridge::FromPath(Conversion->Output), bNotify](FEFWorkQueue::FProgress& Progress)
+        {
+            return ConvertFont(Options, Source, Output, bNotify);
+        },
+        [this, InProperty, bResult](bool bConverted)
+        {
+            *bResult = bConverted;
+            if (bConverted) { ShowSuccess(InProperty, 3.0f); }
+            else { UE_LOG(LogTemp, Error, TEXT("File conversion failed.")); }
+        });
+    return *bResult;
+}
+
 void UDevEditor::HandleConverterProp(FPropertyChangedEvent& PropertyChangedEvent)
 {
     if (PropertyChangedEvent.Property == NULL) { return; }
     auto propertyName = PropertyChangedEvent.GetPropertyName();
     if (propertyName == GET_MEMBER_NAME_CHECKED(UDevEditor, FontChanger) || propertyName == TEXT("FilePath"))  {
-        bool bConverted = HandleConversion(FontChanger);
-        if (!bConverted)  {
-            UE_LOG(LogTemp, Error, TEXT("File conversion failed."));
-        }
-        else
-        {
-            ShowSuccess(PropertyChangedEvent.Property, 3.0f);
-        }
+        // Failures are logged by HandleConversion, the completion shows success once FontForge exits.
+        HandleConversion(FontChanger, PropertyChangedEvent.Property);
     }
 }
 
@@ -1,4 +1,5 @@
 #pragma once
+#include "Framework/Application/SlateApplication.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
 
@@ -21,6 +22,11 @@ namespace DebugHeader {
 	}
 
 	static inline TSharedPtr<SNotificationItem> ShowNotifyInfo(const FString& Message, SNotificationItem::ECompletionState State = SNotificationItem::CS_None, float FadeOutDuration = 7.0f) {
+		if (!FSlateApplication::IsInitialized()) {
+			// Headless runs only get the log line.
+			UE_LOG(LogTemp, Display, TEXT("%s"), *Message);
+			return nullptr;
+		}
 		FNotificationInfo NotificationInfo(FText::FromString(Message));
 		NotificationInfo.bUseLargeFont = true;
 
@@ -0,0 +1,65 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+class UDevEditor;
+
+/*
+* Times the scan, install, reset, conversion and flush paths against generated font libraries.
+* Installs go to a sandbox under Saved, the engine fonts and the saved settings are never touched.
+* Run through the commandlet: -run=EditorFont -Op=Benchmark [-Sizes=100,1000,10000] [-Iterations=20]
+* [-ConvertSamples=10] [-Output=<Dir>] [-Baseline=<previous json>] [-Tolerance=0.2]
+*/
+class EDITORFONT_API FEFBenchmark
+{
+public:
+	struct FOptions
+	{
+		TArray<int32> LibrarySizes = { 100, 1000, 10000 };
+		int32 Iterations = 20;
+		int32 ConversionSamples = 10;
+		FString OutputDir;
+		FString BaselineFile;
+		/** A path regresses when its p95 exceeds the baseline p95 by more than this fraction. */
+		double Tolerance = 0.2;
+	};
+
+	struct FResult
+	{
+		FString Path;
+		int32 LibrarySize = 0;
+		/** Files or slots handled per sample, used for throughput. */
+		int32 ItemsPerSample = 1;
+		TArray<double> SamplesMs;
+
+		double Percentile(double Fraction) const;
+		double Mean() const;
+		double Throughput() const;
+	};
+
+	FEFBenchmark(UDevEditor* InSettings, const FOptions& InOptions);
+
+	/** Runs every path and writes results.csv / results.json. Returns false if a path regressed against the baseline. */
+	bool Run(TSharedRef<FJsonObject> Report);
+
+private:
+	bool GenerateLibrary(const FString& LibraryDir, int32 NumFiles) const;
+	void TimeScan(const FString& LibraryDir, int32 NumFiles);
+	void TimeInstall(const FString& LibraryDir, int32 NumFiles);
+	void TimeReset(int32 NumFiles);
+	void TimeFlush(int32 NumFiles);
+	void TimeConversion(const FString& LibraryDir, int32 NumFiles);
+
+	FResult& AddResult(const FString& Path, int32 LibrarySize, int32 ItemsPerSample);
+	TSharedRef<FJsonObject> ToJson(const FResult& Result) const;
+	bool CheckBaseline(TSharedRef<FJsonObject> Report) const;
+	void WriteOutputs(TSharedRef<FJsonObject> Report) const;
+
+	UDevEditor* Settings;
+	FOptions Options;
+	FString SandboxDir;
+	TArray<FResult> Results;
+};
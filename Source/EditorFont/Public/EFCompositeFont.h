@@ -0,0 +1,35 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Fonts/CompositeFont.h"
+
+/*
+* Font backend that rebinds the typefaces of the editor's default composite font in memory instead of replacing engine files.
+* A slot finds its entries through its Typeface metadata, in the default typeface, the sub typeface for its Culture,
+* or the fallback typeface for Culture "*". Only the composite font that changed is flushed.
+*/
+class EDITORFONT_API FEFCompositeFontBackend
+{
+public:
+	static FEFCompositeFontBackend& Get();
+
+	/** Points the slot's typeface entries at FontFile. False if the slot has no matching entry. */
+	bool Bind(const FProperty* Slot, const FString& FontFile);
+
+	/** Puts back the font data the engine shipped with. */
+	bool Restore(const FProperty* Slot);
+
+	/** The file a slot's first entry currently loads from, empty if it has none. */
+	FString GetBoundFile(const FProperty* Slot) const;
+
+	/** Re-binds the changed composite font. Cheaper than a full font cache flush. */
+	void Flush();
+
+private:
+	TArray<FFontData*> FindEntries(const FProperty* Slot) const;
+
+	TMap<FFontData*, FFontData> Originals;
+	bool bDirty = false;
+};
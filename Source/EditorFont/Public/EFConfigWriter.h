@@ -0,0 +1,47 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/WeakObjectPtr.h"
+
+/*
+* Coalesces config saves for the settings object.
+* Every change only marks the writer dirty. Once no new change has arrived for CoalesceWindow seconds,
+* the object is saved once with SaveConfig on the game thread, the same call an uncoalesced save makes.
+*/
+class EDITORFONT_API FEFConfigWriter
+{
+public:
+	static FEFConfigWriter& Get();
+
+	/** Seconds without a new change before the pending save runs. */
+	static constexpr double CoalesceWindow = 0.5;
+
+	void MarkDirty(UObject* Settings, const FString& Filename);
+
+	/** Saves any pending change right now. Used on shutdown and by non-interactive runs. */
+	void Flush();
+
+	bool HasPendingWrite() const;
+
+	/** Load-side cache. Returns false when the file is unchanged since the last load, or when memory is newer than disk. */
+	bool ShouldReload(const FString& Filename) const;
+	void NotifyLoaded(const FString& Filename);
+
+private:
+	bool Tick(float DeltaTime);
+	void Save();
+	void RecordStamp(const FString& Filename);
+
+	TWeakObjectPtr<UObject> PendingObject;
+	FString PendingFilename;
+	double LastDirtyTime = 0.0;
+	bool bDirty = false;
+
+	FTSTicker::FDelegateHandle TickerHandle;
+
+	/** Modification time and size of each config file as of the last load or write. */
+	TMap<FString, TPair<FDateTime, int64>> FileStamps;
+};
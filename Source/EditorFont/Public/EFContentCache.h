@@ -0,0 +1,45 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Content-addressed store for generated font files (subsets, conversions, extracted faces...).
+* Entries are keyed by a hash of their inputs, so an entry never needs invalidating: changed inputs produce a new key.
+* The store can live in a machine-wide directory shared by every project and engine install. Entries are published
+* by renaming a finished file into place, so concurrent editors need no lock: the first one wins, the others reuse it.
+*/
+class EDITORFONT_API FEFContentCache
+{
+public:
+	static FEFContentCache& Get();
+
+	FString GetRoot() const;
+
+	/** Moves the store under a shared directory, empty goes back to the project's Saved folder. */
+	void SetSharedRoot(const FString& Directory);
+	/** The shared directory, empty when the store is per project. */
+	FString GetSharedRoot() const;
+	/** Per-user location used when no shared directory is configured. */
+	static FString GetDefaultSharedRoot();
+
+	/** Path of the entry for Key inside Bucket. The file may or may not exist yet. */
+	FString GetEntryPath(const FString& Bucket, const FString& Key, const FString& Extension) const;
+
+	/** Returns the entry path if it already exists, empty otherwise. */
+	FString Find(const FString& Bucket, const FString& Key, const FString& Extension) const;
+
+	/** Moves a finished file into the store. Readers never see a partially written entry. */
+	bool Publish(const FString& Bucket, const FString& Key, const FString& Extension, const FString& FinishedFile) const;
+
+	/** A path to write a new entry to before calling Publish. */
+	FString MakeStagingPath(const FString& Extension) const;
+
+	static FString HashFile(const FString& Filename);
+	static FString HashString(const FString& Value);
+
+private:
+	mutable FCriticalSection Mutex;
+	FString SharedRoot;
+};
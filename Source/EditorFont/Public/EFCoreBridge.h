@@ -0,0 +1,22 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <filesystem>
+#include <string>
+
+/*
+* Conversions between engine strings and the std types the EditorFontCore library takes.
+* Paths keep their native encoding: wide on Windows, UTF-8 everywhere else.
+*/
+class EDITORFONT_API FEFCoreBridge
+{
+public:
+	/** Relative paths are made absolute against the engine's base directory first, not the process working directory. */
+	static std::filesystem::path ToPath(const FString& Path);
+	static FString FromPath(const std::filesystem::path& Path);
+
+	static std::string ToUtf8(const FString& Value);
+	static FString FromUtf8(const std::string& Value);
+};
@@ -0,0 +1,50 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class FEFSfntReader;
+
+/*
+* Sparse Unicode coverage bitmap. The code space is split into 256 code point blocks, and only non-empty blocks are stored,
+* sorted by block index. A Latin font costs a handful of blocks, a full CJK font a few hundred.
+*/
+class EDITORFONT_API FEFCoverage
+{
+public:
+	enum class EScript : uint8
+	{
+		Arabic,
+		Thai,
+		Japanese,
+		Korean,
+	};
+
+	struct alignas(16) FBlock
+	{
+		uint32 Words[8] = {};
+	};
+
+	static FEFCoverage FromFont(const FEFSfntReader& Reader);
+
+	/** Letters a font must have to be offered for Script, plus Basic Latin for mixed editor text. */
+	static const FEFCoverage& GetScriptRequirement(EScript Script);
+
+	void AddRange(uint32 First, uint32 Last);
+	bool Contains(uint32 CodePoint) const;
+
+	/** True if every code point in Required is present here. Compares 128 bits at a time. */
+	bool ContainsAll(const FEFCoverage& Required) const;
+
+	int32 NumCodePoints() const;
+	bool IsEmpty() const { return BlockIndices.Num() == 0; }
+
+	friend FArchive& operator<<(FArchive& Ar, FEFCoverage& Coverage);
+
+private:
+	FBlock& FindOrAddBlock(uint16 BlockIndex);
+
+	TArray<uint16> BlockIndices;
+	TArray<FBlock> Blocks;
+};
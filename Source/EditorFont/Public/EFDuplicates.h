@@ -0,0 +1,40 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EFFontIndex.h"
+
+struct FEFDuplicateGroup
+{
+	enum class EKind : uint8
+	{
+		/** Byte for byte the same file. */
+		Identical,
+		/** Same outline tables and cmap, only names, timestamps or other metadata differ. */
+		SameOutlines,
+	};
+
+	EKind Kind = EKind::Identical;
+	FString Keep;
+	TArray<FString> Duplicates;
+	int64 DuplicateBytes = 0;
+
+	static const TCHAR* LexKind(EKind Kind);
+};
+
+/*
+* Groups the font index entries that are the same font, from the font index hashes.
+* Each tier runs on what the previous one left, so a file lands in at most one group.
+* Files are only grouped with files of the same extension: a ConvertFontFolder result is the other format
+* the slots ask for, not a duplicate of its source. Faces of collections are never grouped, they cannot be removed on their own.
+*/
+class EDITORFONT_API FEFDuplicateFinder
+{
+public:
+	/** The keeper is a Preferred path if the group has one, else the oldest file. Preferred paths are never listed as duplicates. */
+	static TArray<FEFDuplicateGroup> FindGroups(const TArray<FEFFontIndexEntry>& Entries, const TSet<FString>& Preferred);
+
+	/** Deletes the duplicates that lie under one of Roots. Returns how many were deleted. */
+	static int32 RemoveDuplicates(const TArray<FEFDuplicateGroup>& Groups, const TArray<FString>& Roots, int64& OutBytes);
+};
@@ -0,0 +1,26 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EFFontIndex.h"
+
+/*
+* Maps the members of a font family onto the font slots by their OS/2 weight, width and italic bits.
+* Each slot's wanted style comes from its Axes metadata. A slot with no exact member gets the nearest one.
+*/
+class EDITORFONT_API FEFFamilyMapper
+{
+public:
+	/** The style a slot asks for, from "wght=700,wdth=75,ital=1". */
+	static FEFSfntReader::FStyle GetSlotStyle(const FProperty* Slot);
+
+	/** Lower is closer. Italic mismatches outweigh width, width outweighs weight. */
+	static int32 GetDistance(const FEFSfntReader::FStyle& Wanted, const FEFSfntReader::FStyle& Candidate);
+
+	/**
+	* Slot -> member path for every slot with Axes metadata.
+	* Slots marked Monospace only take fixed pitch members and are left out when the family has none.
+	*/
+	static TMap<FNameProperty*, FString> MapFamily(const TArray<FEFFontIndexEntry>& Members, const TArray<FNameProperty*>& Slots);
+};
@@ -0,0 +1,37 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* TrueType/OpenType collections (.ttc/.otc). A face is addressed as "<collection path>#<face index>" wherever a font path is expected.
+* Extracting a face writes its table directory and tables as a standalone sfnt, straight from a mapping of the collection.
+* Extracted faces are cached by collection hash and face index, so a collection is split at most once per face.
+*/
+class EDITORFONT_API FEFFontCollection
+{
+public:
+	static bool IsCollectionFile(const FString& Path);
+
+	static FString MakeFacePath(const FString& Collection, int32 FaceIndex);
+
+	/** False for a plain path, OutFile is then Path and OutFaceIndex 0. */
+	static bool SplitFacePath(const FString& Path, FString& OutFile, int32& OutFaceIndex);
+
+	/** The file on disk behind a path or face path. */
+	static FString GetFilePart(const FString& Path);
+
+	/** Replaces every collection in Paths with one face path per face, reading only the collection headers. Unreadable collections are dropped. */
+	static TArray<FString> ExpandFaces(const TArray<FString>& Paths);
+
+	/** A standalone font for a face path, extracting it if needed. Plain paths are returned unchanged. Empty on failure. */
+	static FString ResolveFace(const FString& Path);
+
+	/** Writes one face as a standalone sfnt. Tables are streamed from Collection, only head is copied to fix its checksum. */
+	static bool WriteFace(TConstArrayView<uint8> Collection, int32 FaceIndex, FArchive& Out);
+
+private:
+	/** Content hash of the collection, remembered while its size and timestamp stay the same. */
+	static FString GetCollectionHash(const FString& Collection);
+};
@@ -0,0 +1,64 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "EFCoverage.h"
+#include "EFSfnt.h"
+
+struct FEFFontIndexEntry
+{
+	FString Path;
+	int64 Size = 0;
+	FDateTime Timestamp;
+	int32 GlyphCount = 0;
+	/** Has an fvar table. */
+	bool bVariable = false;
+	FString FamilyName;
+	FEFSfntReader::FStyle Style;
+	FEFCoverage Coverage;
+	/** MD5 of the whole file. Empty for faces of a collection. */
+	FString ContentHash;
+	/** MD5 of the outline tables (glyf/loca, CFF, CFF2) and cmap. Names and timestamps do not count. */
+	FString OutlineHash;
+	/** MD5 of cmap alone. */
+	FString CmapHash;
+
+	friend FArchive& operator<<(FArchive& Ar, FEFFontIndexEntry& Entry);
+};
+
+/*
+* Per-file facts about the font library, persisted next to the content cache. Collections have one entry per face path.
+* An entry is re-parsed only when the file's size or timestamp changes. With a shared cache the index is shared too.
+*/
+class EDITORFONT_API FEFFontIndex
+{
+public:
+	static FEFFontIndex& Get();
+
+	/** Brings the entries for Paths up to date, parsing stale files in parallel. Saves the index if anything changed. */
+	void Refresh(const TArray<FString>& Paths);
+
+	/** Copy of the entry, false if the file is not a readable font. Call Refresh first. */
+	bool GetEntry(const FString& Path, FEFFontIndexEntry& OutEntry) const;
+
+	/** Copies of the readable entries among Paths. Call Refresh first. */
+	TArray<FEFFontIndexEntry> GetEntries(const TArray<FString>& Paths) const;
+
+	/** The subset of Paths whose coverage contains Required. */
+	TArray<FString> FilterByCoverage(const TArray<FString>& Paths, const FEFCoverage& Required);
+
+	/** Drops the entries in memory, the next Refresh loads the index file of the current cache root. */
+	void Unload();
+
+private:
+	static bool ReadIndexFile(const FString& IndexFile, TArray<FEFFontIndexEntry>& OutEntries);
+	void Load();
+	void Save();
+	FString GetIndexFile() const;
+	static bool ParseFont(const FString& Path, FEFFontIndexEntry& OutEntry);
+
+	mutable FCriticalSection Mutex;
+	TMap<FString, FEFFontIndexEntry> Entries;
+	bool bLoaded = false;
+};
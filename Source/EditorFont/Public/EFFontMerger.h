@@ -0,0 +1,28 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDevEditor;
+
+/*
+* Merges a Latin font and a CJK font into one face, so mixed-script text resolves in a single font instead of going through fallback lookups.
+* The Latin font's glyphs, names and em win. Every code point it does not map is filled from the CJK font, scaled to the Latin em,
+* and the line metrics are widened to fit both. Merged faces are cached by the hashes of both inputs.
+*/
+class EDITORFONT_API FEFFontMerger
+{
+public:
+	/** What a merge reads from the settings, copied on the game thread so the merge can run on a worker. */
+	struct FOptions
+	{
+		FString FontForgeExecutable;
+		FString Script;
+	};
+
+	static FOptions MakeOptions(const UDevEditor* Settings);
+
+	/** Returns the merged font, building it if needed. Thread safe, runs FontForge on the calling thread. Empty on failure. */
+	static FString MergeFonts(const FOptions& Options, const FString& LatinFont, const FString& CjkFont);
+};
@@ -0,0 +1,32 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Install-time optimization pass. Drops the tables the editor never reads (signatures, embedded bitmaps, color layers),
+* optionally strips the TrueType hinting programs and glyph instructions, and rewrites glyf/loca without padding or slack.
+* Outlines, metrics, cmap and the layout and kerning tables are kept byte for byte. Optimized fonts are cached by source hash and options.
+*/
+class EDITORFONT_API FEFFontOptimizer
+{
+public:
+	struct FOptions
+	{
+		bool bStripHinting = true;
+	};
+
+	/** Returns the optimized font for SourceFont, building it if needed. Empty on failure. */
+	static FString OptimizeFont(const FString& SourceFont, const FOptions& Options);
+
+	/** Writes the optimized Font to Out. False if Font is not a font this pass understands. */
+	static bool Optimize(TConstArrayView<uint8> Font, const FOptions& Options, FArchive& Out);
+
+private:
+	/** Rebuilds glyf and loca glyph by glyph, without instructions if bStripInstructions. False on a malformed table. */
+	static bool CompactGlyphs(TConstArrayView<uint8> Glyf, TConstArrayView<uint8> Loca, bool bLongLoca, int32 NumGlyphs, bool bStripInstructions,
+		TArray<uint8>& OutGlyf, TArray<uint8>& OutLoca, bool& bOutLongLoca);
+	/** Appends one glyph cut to its exact length, without instructions if bStripInstructions. False if malformed. */
+	static bool CopyGlyph(TConstArrayView<uint8> Glyph, bool bStripInstructions, TArray<uint8>& Out);
+};
@@ -0,0 +1,68 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+/*
+* Single-file font theme (.efpack): header, table of contents, slot mapping, then the font files aligned to pages.
+* A pack is memory mapped once and its members are read straight from the mapping.
+* A member is addressed as "<pack path>/<member name>", so packs behave like read-only folders in FontPath.
+*/
+class EDITORFONT_API FEFFontPack
+{
+public:
+	struct FMember
+	{
+		FString Name;
+		uint64 Offset = 0;
+		uint64 Size = 0;
+		/** MD5 of the member bytes. */
+		FString Hash;
+	};
+
+	/** Packs Fonts (member name -> source file) with a slot -> member name mapping, writing the members in the given order. */
+	static bool Write(const FString& PackFile, const TArray<TPair<FString, FString>>& Fonts, const TMap<FString, FString>& Slots);
+
+	/** Mapped pack, shared by every caller until the file changes. Null if it is not a readable pack. */
+	static TSharedPtr<FEFFontPack> Open(const FString& PackFile);
+
+	static bool IsPackFile(const FString& Path);
+	static bool IsPackMember(const FString& Path);
+	/** False for a path that is not inside a pack. */
+	static bool SplitMemberPath(const FString& Path, FString& OutPack, FString& OutMember);
+	/** The pack file behind a member path, other paths unchanged. */
+	static FString GetPackFile(const FString& Path);
+
+	/** Replaces every pack in Paths with its member paths. Unreadable packs are dropped. */
+	static TArray<FString> ExpandMembers(const TArray<FString>& Paths);
+
+	/** Writes a member to Target straight from the mapping. */
+	static bool ExtractMember(const FString& MemberPath, const FString& Target);
+
+	/** A real file for a member path, written once into the content cache by member hash. Other paths unchanged. Empty on failure. */
+	static FString ResolveMember(const FString& MemberPath);
+
+	const TArray<FMember>& GetMembers() const { return Members; }
+	/** Slot property name -> member name. */
+	const TMap<FString, FString>& GetSlots() const { return Slots; }
+	const FMember* FindMember(const FString& Name) const;
+	/** Empty if the member is missing. */
+	TConstArrayView<uint8> GetMemberData(const FMember& Member) const;
+
+	~FEFFontPack();
+
+private:
+	bool Map(const FString& PackFile);
+
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region;
+	/** Used where the platform cannot map files. */
+	TArray<uint8> Loaded;
+	TConstArrayView<uint8> Data;
+	TArray<FMember> Members;
+	TMap<FString, FString> Slots;
+};
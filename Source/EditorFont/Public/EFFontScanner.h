@@ -0,0 +1,44 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Recursive scan of the font library roots. Each depth of the tree is listed in parallel, one directory per task.
+* Directories are visited once by their resolved path, so symlink loops and overlapping roots are walked once.
+* Extensions match regardless of case. Each root set's last result is reused for a few seconds, the details panel asks once per slot
+* and alternates between the library and single folders.
+*/
+class EDITORFONT_API FEFFontScanner
+{
+public:
+	static FEFFontScanner& Get();
+
+	/** Sorted absolute paths of every font file under Roots, collections as one face path per face and packs as one path per member. bOutRescanned is false when the cached result was reused. */
+	TArray<FString> Scan(const TArray<FString>& Roots, bool* bOutRescanned = nullptr);
+
+	/** Forgets every cached result, call after writing into a root. */
+	void Invalidate();
+
+	/** .ttf, .otf, .ttc, .otc and .efpack. */
+	static const TArray<FString>& GetFontExtensions();
+
+	/** Where this platform keeps system and per-user fonts. Only existing directories. */
+	static TArray<FString> GetSystemFontDirectories();
+
+private:
+	static TArray<FString> Walk(const TArray<FString>& Roots);
+	/** Absolute path with symlinks resolved, empty if Directory does not exist. */
+	static FString ResolveDirectory(const FString& Directory);
+
+	struct FCachedScan
+	{
+		TArray<FString> Files;
+		double Time = 0.0;
+	};
+
+	FCriticalSection Mutex;
+	/** Keyed by the roots joined in the order given, the order decides which root prefixes a font found under two. */
+	TMap<FString, FCachedScan> Cache;
+};
@@ -0,0 +1,52 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+struct FEFFontStatsEntry
+{
+	int64 FileBytes = 0;
+	int32 GlyphCount = 0;
+	/** What FreeType allocates for the open face and the glyphs of a short Latin sample. */
+	int64 FaceBytes = 0;
+	/** Read + face open + sample glyph loads, in milliseconds. */
+	double LoadMs = 0.0;
+	bool bValid = false;
+
+	/** Slate keeps lazily loaded font files in memory for as long as the face is alive, so the file counts in full. */
+	int64 GetResidentBytes() const { return FileBytes + FaceBytes; }
+};
+
+/*
+* Measures what an installed font costs once Slate has loaded it.
+* The face is opened with a private FreeType library whose allocator counts bytes, the same way Slate opens it.
+* Results are cached per file until the file is replaced.
+*/
+class EDITORFONT_API FEFFontStats
+{
+public:
+	static FEFFontStats& Get();
+
+	/** Cached stats for Path, measured on first request. */
+	FEFFontStatsEntry GetStats(const FString& Path);
+
+	/** Cached stats only, false if Path has not been measured yet. */
+	bool FindStats(const FString& Path, FEFFontStatsEntry& OutEntry);
+
+	/** Cached stats if there are any. Otherwise queues a measurement on the work queue and returns false. Game thread only. */
+	bool FindOrRequestStats(const FString& Path, FEFFontStatsEntry& OutEntry);
+
+	/** Drops the cached stats, called whenever a file is installed over Path. */
+	void Invalidate(const FString& Path);
+
+	static bool Measure(const FString& Path, FEFFontStatsEntry& OutEntry);
+
+private:
+	static FString MakeKey(const FString& Path);
+
+	FCriticalSection Mutex;
+	TMap<FString, FEFFontStatsEntry> Entries;
+	/** Keys with a measurement on the work queue, so a widget polling every frame queues one. */
+	TSet<FString> Pending;
+};
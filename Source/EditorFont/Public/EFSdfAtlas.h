@@ -0,0 +1,56 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDevEditor;
+
+struct FEFSdfGlyph
+{
+	uint32 CodePoint = 0;
+	/** Cell in the atlas, including the Spread padding on every side. */
+	uint16 X = 0;
+	uint16 Y = 0;
+	uint16 Width = 0;
+	uint16 Height = 0;
+	/** Pen offsets and advance at EmSize, in atlas pixels. */
+	int16 BearingX = 0;
+	int16 BearingY = 0;
+	uint16 Advance = 0;
+
+	friend FArchive& operator<<(FArchive& Ar, FEFSdfGlyph& Glyph);
+};
+
+/*
+* Signed distance field glyph atlases for installed fonts.
+* Glyphs are rendered oversampled, distance transformed and downsampled on worker threads, one FreeType face per worker.
+* 128 is the outline, values above are inside. One atlas serves every text size.
+* Atlases are cached by font hash, code points and options. Format: "EFSD" header, glyph table, 8 bit pixels.
+* The editor does not read them, they are an export for tools that render SDF text, built only when bGenerateSdfAtlases is on.
+*/
+class EDITORFONT_API FEFSdfAtlas
+{
+public:
+	struct FOptions
+	{
+		int32 EmSize = 32;
+		/** Distance range in atlas pixels on each side of the outline. */
+		int32 Spread = 4;
+		int32 Oversample = 4;
+		int32 AtlasWidth = 1024;
+	};
+
+	/** Returns the cached atlas for the font, building it if needed. Empty on failure. Blocks. */
+	static FString GetOrBuild(const FString& FontFile, const TArray<uint32>& CodePoints, const FOptions& Options);
+
+	/** Queues atlases for the active slots on the work queue. Slots whose installed file has not changed since their last build are skipped. */
+	static void QueueForSlots(const UDevEditor* Settings);
+
+private:
+	static FString GetOrBuild(const FString& FontFile, const FString& FontHash, const TArray<uint32>& CodePoints, const FOptions& Options);
+	static bool Build(const FString& FontFile, const TArray<uint32>& CodePoints, const FOptions& Options, const FString& OutputFile);
+
+	/** Font hash each slot's atlas was last built from. Only touched by queue jobs, which run one at a time. */
+	static TMap<FName, FString> BuiltHashes;
+};
@@ -0,0 +1,95 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Minimal read-only view over an OpenType/TrueType file (or one face of a collection).
+* Only reads the tables the plugin needs. Every read is bounds checked, malformed fonts fail to open instead of crashing.
+*/
+class EDITORFONT_API FEFSfntReader
+{
+public:
+	struct FTable
+	{
+		uint32 Tag = 0;
+		uint32 Checksum = 0;
+		uint32 Offset = 0;
+		uint32 Length = 0;
+	};
+
+	static constexpr uint32 MakeTag(char A, char B, char C, char D)
+	{
+		return (uint32(uint8(A)) << 24) | (uint32(uint8(B)) << 16) | (uint32(uint8(C)) << 8) | uint32(uint8(D));
+	}
+
+	static uint16 ReadU16(const uint8* Ptr) { return uint16((Ptr[0] << 8) | Ptr[1]); }
+	static int16 ReadS16(const uint8* Ptr) { return int16(ReadU16(Ptr)); }
+	static uint32 ReadU32(const uint8* Ptr) { return (uint32(Ptr[0]) << 24) | (uint32(Ptr[1]) << 16) | (uint32(Ptr[2]) << 8) | uint32(Ptr[3]); }
+
+	/** 1 for a plain font, the face count for a collection, 0 if Data is not a font. */
+	static int32 GetFaceCount(TConstArrayView<uint8> Data);
+
+	/** Data must outlive the reader. */
+	bool Open(TConstArrayView<uint8> Data, int32 FaceIndex = 0);
+
+	bool IsValid() const { return SfntVersion != 0; }
+	uint32 GetSfntVersion() const { return SfntVersion; }
+	const TArray<FTable>& GetTables() const { return Tables; }
+	const FTable* FindTable(uint32 Tag) const;
+	/** Empty if the table is missing. */
+	TConstArrayView<uint8> GetTableData(uint32 Tag) const;
+	TConstArrayView<uint8> GetFileData() const { return FileData; }
+
+	/** Number of glyphs from maxp, 0 if unknown. */
+	int32 GetGlyphCount() const;
+
+	struct FStyle
+	{
+		uint16 WeightClass = 400;
+		/** 1 (ultra-condensed) to 9 (ultra-expanded), 5 is normal. */
+		uint16 WidthClass = 5;
+		bool bItalic = false;
+		bool bFixedPitch = false;
+	};
+
+	/** Style from OS/2 and post. Defaults when the tables are missing. */
+	FStyle GetStyle() const;
+
+	/** First Unicode or Mac Roman record for NameID, empty if none. */
+	FString GetName(uint16 NameID) const;
+
+	/** Typographic family (name 16), falling back to the legacy family (name 1). */
+	FString GetFamilyName() const;
+
+	/** Calls Visitor with inclusive ranges of code points that map to a real glyph. Returns false if no usable cmap. */
+	bool ForEachMappedRange(TFunctionRef<void(uint32 First, uint32 Last)> Visitor) const;
+
+private:
+	TConstArrayView<uint8> FileData;
+	uint32 SfntVersion = 0;
+	TArray<FTable> Tables;
+};
+
+/*
+* Builds a standalone font from whole tables. Fills in the table directory, the table checksums and head.checkSumAdjustment.
+*/
+class EDITORFONT_API FEFSfntWriter
+{
+public:
+	static void WriteU16(uint8* Ptr, uint16 Value);
+	static void WriteU32(uint8* Ptr, uint32 Value);
+	/** Sum of big-endian words, the last one zero padded. */
+	static uint32 CalcChecksum(TConstArrayView<uint8> Data);
+
+	explicit FEFSfntWriter(uint32 InSfntVersion) : SfntVersion(InSfntVersion) {}
+
+	void AddTable(uint32 Tag, TArray<uint8> Data);
+
+	bool Write(FArchive& Out) const;
+
+private:
+	uint32 SfntVersion = 0;
+	TArray<TPair<uint32, TArray<uint8>>> Tables;
+};
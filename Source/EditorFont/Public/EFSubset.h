@@ -0,0 +1,43 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDevEditor;
+
+/*
+* Install-time glyph subsetting for the localized slots.
+* The kept set is every code point the editor's localization archives use for the slot's culture,
+* Basic Latin, and the user's ExtraSubsetRanges. Trimmed fonts are cached by source and code point hash.
+*/
+class EDITORFONT_API FEFSubsetter
+{
+public:
+	/** What a subset reads from the settings, copied on the game thread so install jobs can subset on a worker. */
+	struct FOptions
+	{
+		/** UDevEditor::ExtraSubsetRanges. */
+		FString ExtraRanges;
+		FString FontForgeExecutable;
+		FString Script;
+	};
+
+	static FOptions MakeOptions(const UDevEditor* Settings);
+
+	/** Culture "*" collects every culture found under the editor localization folders. */
+	static void CollectCultureCodePoints(const FString& Culture, TSet<uint32>& OutCodePoints);
+
+	/** Parses "U+3000-U+30FF, 0x4E00-0x9FFF, 20AC" style lists. Returns false on a malformed entry. */
+	static bool ParseRanges(const FString& Ranges, TSet<uint32>& OutCodePoints);
+
+	/**
+	* Returns the trimmed font for SourceFont, building it if needed. Empty on failure.
+	* SourceFont itself when the culture has no localization text beyond Basic Latin to keep.
+	*/
+	static FString SubsetFont(const FOptions& Options, const FString& SourceFont, const FString& Culture);
+
+private:
+	static void CollectArchiveText(const TSharedPtr<class FJsonObject>& Node, TSet<uint32>& OutCodePoints);
+	static void AddString(const FString& Text, TSet<uint32>& OutCodePoints);
+};
@@ -0,0 +1,62 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "EFBenchmark.h"
+
+class UDevEditor;
+
+/*
+* Shapes and rasterizes a fixed editor-like corpus with candidate fonts on the CPU, the way Slate does:
+* HarfBuzz runs GSUB/GPOS over log lines, node titles and the localized preview samples, then FreeType renders every glyph the shaping produced.
+* Fonts with heavy layout tables, hinting programs or huge glyph sets show up as low glyphs per second or a large atlas.
+* Run through the commandlet: -run=EditorFont -Op=TextBenchmark [-Fonts=<value>,<value>|Library] [-Iterations=20] [-Output=<Dir>]
+* Without -Fonts the fonts in the slots now are measured.
+*/
+class EDITORFONT_API FEFTextBenchmark
+{
+public:
+	struct FOptions
+	{
+		/** Slot values or paths. Empty measures the slot fonts, "Library" every font in the library. */
+		TArray<FString> Fonts;
+		int32 Iterations = 20;
+		FString OutputDir;
+	};
+
+	struct FFontResult
+	{
+		FString Font;
+		int64 FileBytes = 0;
+		int32 GlyphCount = 0;
+		/** GDEF + GSUB + GPOS. */
+		int64 LayoutBytes = 0;
+		/** fpgm + prep + cvt, the TrueType hinting programs. */
+		int64 HintingBytes = 0;
+		/** Glyphs out of one shaping pass over the corpus. */
+		int32 ShapedGlyphs = 0;
+		/** Distinct glyph and size pairs, what Slate rasterizes once and keeps in the atlas. */
+		int32 UniqueGlyphs = 0;
+		/** 8-bit coverage with Slate's one pixel of padding around each glyph. */
+		int64 AtlasBytes = 0;
+		FEFBenchmark::FResult Shape;
+		FEFBenchmark::FResult Raster;
+	};
+
+	FEFTextBenchmark(UDevEditor* InSettings, const FOptions& InOptions);
+
+	/** Measures every font and writes text.csv / text.json. False if no font could be measured. */
+	bool Run(TSharedRef<FJsonObject> Report);
+
+private:
+	bool MeasureFont(const FString& Font, FFontResult& OutResult) const;
+	TArray<FString> GetCandidateFonts() const;
+	TSharedRef<FJsonObject> ToJson(const FFontResult& Result) const;
+	void WriteOutputs(TSharedRef<FJsonObject> Report) const;
+
+	UDevEditor* Settings;
+	FOptions Options;
+	TArray<FFontResult> Results;
+};
@@ -0,0 +1,21 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "ProfilingDebugging/CountersTrace.h"
+
+/*
+* Insights instrumentation for font operations.
+* Capture with -trace=cpu,counters,EditorFont to see the scopes and counters below.
+*/
+UE_TRACE_CHANNEL_EXTERN(EditorFontChannel, EDITORFONT_API);
+
+#define EF_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, EditorFontChannel)
+
+TRACE_DECLARE_INT_COUNTER_EXTERN(EditorFont_BytesCopied);
+TRACE_DECLARE_INT_COUNTER_EXTERN(EditorFont_FilesTouched);
+TRACE_DECLARE_INT_COUNTER_EXTERN(EditorFont_ConversionsInFlight);
+TRACE_DECLARE_INT_COUNTER_EXTERN(EditorFont_FlushCount);
@@ -0,0 +1,28 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UDevEditor;
+
+/*
+* Static instances of a variable font for the font slots.
+* A spec is either axis values ("wght=700,wdth=75,ital=1") or the name of one of the font's named instances.
+* Instances are cached by source hash and spec, and every missing one is written by a single script run.
+*/
+class EDITORFONT_API FEFVariableFont
+{
+public:
+	/** What instancing reads from the settings, copied on the game thread so it can run on a worker. */
+	struct FOptions
+	{
+		FString Python;
+		FString Script;
+	};
+
+	static FOptions MakeOptions(const UDevEditor* Settings);
+
+	/** Returns one path per spec, empty where the instance could not be built. False if any failed. Thread safe, blocks on the script. */
+	static bool GenerateInstances(const FOptions& Options, const FString& SourceFont, const TArray<FString>& Specs, TArray<FString>& OutPaths);
+};
@@ -0,0 +1,94 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "HAL/FileManager.h"
+#include <atomic>
+
+class SNotificationItem;
+
+/*
+* Runs the disk-heavy settings operations off the game thread, one job at a time in submission order,
+* so a reset queued behind an install always sees the installed file.
+* Workers hand results and notifications back through a lock-free queue that a ticker drains on the game thread,
+* which also keeps a progress notification up to date while a long job runs.
+* Commandlets have nobody to keep responsive and no ticker to drain the queue, there every job runs inline.
+*/
+class EDITORFONT_API FEFWorkQueue
+{
+public:
+	/**
+	* Written by the worker, read by the notification. Batch jobs count items and the notification shows counts,
+	* throughput and an ETA instead of bytes. Counters are lock-free, only failures take a lock to keep their names.
+	*/
+	struct FProgress
+	{
+		std::atomic<int64> BytesDone{ 0 };
+		std::atomic<int64> BytesTotal{ 0 };
+		std::atomic<int32> ItemsDone{ 0 };
+		std::atomic<int32> ItemsFailed{ 0 };
+		std::atomic<int32> ItemsTotal{ 0 };
+
+		void AddTotal(int64 Bytes) { BytesTotal += FMath::Max<int64>(Bytes, 0); }
+		void AddDone(int64 Bytes) { BytesDone += FMath::Max<int64>(Bytes, 0); }
+		void AddItems(int32 Count) { ItemsTotal += FMath::Max(Count, 0); }
+		void CompleteItem(bool bSucceeded, const FString& Name);
+		TArray<FString> GetFailures() const;
+
+	private:
+		mutable FCriticalSection FailureMutex;
+		TArray<FString> Failures;
+	};
+
+	static FEFWorkQueue& Get();
+
+	/** Work runs on a worker and returns whether it succeeded, OnComplete then runs on the game thread with that result. */
+	void Enqueue(const FString& Label, TUniqueFunction<bool(FProgress&)> Work, TUniqueFunction<void(bool)> OnComplete = nullptr);
+
+	/** Runs Callback on the game thread: right away when called there, from the completion queue otherwise. */
+	void PostToGameThread(TUniqueFunction<void()> Callback);
+
+	/** A notification that is safe to raise from a job. */
+	void Notify(const FString& Message, bool bSuccess);
+
+	/** Blocks until every queued job and completion has run. Used on shutdown and by the benchmark. */
+	void Flush();
+
+	bool IsBusy() const;
+
+	/** False in commandlets and unattended runs, where jobs run inline. */
+	static bool RunsInBackground();
+
+private:
+	struct FJob
+	{
+		FString Label;
+		TUniqueFunction<bool(FProgress&)> Work;
+		TUniqueFunction<void(bool)> OnComplete;
+	};
+
+	bool Tick(float DeltaTime);
+	void StartNext();
+	void FinishRunning(bool bSucceeded);
+	void DrainCompletions();
+	void UpdateNotification();
+	/** Progress line for the running job, or the summary once it is done. */
+	static FText FormatProgress(const FString& Label, const FProgress& Progress, double Elapsed, bool bFinished);
+	void EnsureTicker();
+
+	TArray<TUniquePtr<FJob>> Pending;
+	TUniquePtr<FJob> Running;
+	TSharedPtr<FProgress> RunningProgress;
+	/** Set while a completion runs, the next job waits for it. */
+	bool bCompleting = false;
+	double RunningSince = 0.0;
+	double LastNotifyUpdate = 0.0;
+	TSharedPtr<SNotificationItem> Notification;
+
+	/** Filled by workers, drained by the game thread. */
+	TQueue<TUniqueFunction<void()>, EQueueMode::Mpsc> Completions;
+	FTSTicker::FDelegateHandle TickerHandle;
+};
@@ -0,0 +1,55 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "Dom/JsonObject.h"
+
+#include "EditorFontCommandlet.generated.h"
+
+class UDevEditor;
+
+/*
+* Runs the font settings operations without the Details panel.
+*
+* UnrealEditor-Cmd <Project>.uproject -run=EditorFont -Op=<Operation> [-Report=<file.json>]
+*	-Op=ApplyProfile -Profile=<Name>	Installs a profile from FontProfiles.
+*	-Op=ExportPack -Profile=<Name> -Pack=<file.efpack>	Writes a profile's fonts and slot mapping into one pack file.
+*	-Op=ApplyPack -Pack=<file.efpack>	Installs the slots of a pack straight from the mapped file.
+*	-Op=Rollback [-Snapshot=<Index>]	Steps the slots to a recorded snapshot, the previous one by default.
+*	-Op=ApplyFamily -Family=<Name>		Maps a family in FontPath onto the slots by weight, width and italic.
+*	-Op=Reset							Restores every unlocked slot to the shipped default and reports each slot's previous value.
+*	-Op=ConvertFolder -Path=<Dir>		Converts every .ttf/.otf in Dir to the other type.
+*	-Op=MergeFonts [-Latin=<Slot>] [-Cjk=<Slot>] [-Install]	Merges two slots' fonts into FontPath/Merged, -Install puts it in the Latin slot.
+*	-Op=Verify							Checks each installed slot file against its expected source.
+*	-Op=Dedupe [-DryRun]				Reports copies of the same font in the font folders and deletes them unless -DryRun.
+*	-Op=Benchmark						Times the scan/install/reset/convert/flush paths, see FEFBenchmark.
+*	-Op=TextBenchmark [-Fonts=<a>,<b>]	Shaping and rasterization cost per font, see FEFTextBenchmark.
+*
+* The result is logged as a single "EditorFontResult:" JSON line and optionally written to -Report.
+* The exit code is 0 on success.
+*/
+UCLASS()
+class UEditorFontCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UEditorFontCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+
+private:
+	bool RunApplyProfile(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report);
+	bool RunFontPack(UDevEditor* Settings, const FString& Op, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report);
+	bool RunRollback(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report);
+	bool RunApplyFamily(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report);
+	bool RunReset(UDevEditor* Settings, TSharedRef<FJsonObject> Report);
+	bool RunConvertFolder(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report);
+	bool RunMergeFonts(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, const TArray<FString>& Switches, TSharedRef<FJsonObject> Report);
+	bool RunVerify(UDevEditor* Settings, TSharedRef<FJsonObject> Report);
+	bool RunDedupe(UDevEditor* Settings, const TArray<FString>& Switches, TSharedRef<FJsonObject> Report);
+	bool RunBenchmark(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report);
+	bool RunTextBenchmark(UDevEditor* Settings, const TMap<FString, FString>& ParamsMap, TSharedRef<FJsonObject> Report);
+};
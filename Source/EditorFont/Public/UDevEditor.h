@@ -7,11 +7,107 @@
 #include "DesktopPlatformModule.h"
 #include "Framework/Notifications/NotificationManager.h"
 #include "Widgets/Notifications/SNotificationList.h"
+#include "EFCoverage.h"
+#include "EFDuplicates.h"
+#include "EFFontOptimizer.h"
+#include "EFSubset.h"
+#include "EFWorkQueue.h"
 //#include "Interfaces/IPluginManager.h"
 //#include "EditorFont.h"
 //#include "PropertyEditorDelegates.h"
 
 #include "UDevEditor.generated.h"
+
+UENUM()
+enum class EEFFontBackend : uint8
+{
+	/* Copy the chosen font over the engine file named by the slot's FileName. */
+	ReplaceFiles,
+	/* Point the slot's typeface in the editor's default composite font at the chosen file. Nothing on disk changes. */
+	CompositeFont,
+};
+
+/* The settings an install reads, copied on the game thread so work queue jobs never read the settings object. */
+struct FEFInstallOptions
+{
+	EEFFontBackend Backend = EEFFontBackend::ReplaceFiles;
+	bool bSubsetLocalizedFonts = false;
+	bool bOptimizeInstalledFonts = false;
+	FEFSubsetter::FOptions Subset;
+	FEFFontOptimizer::FOptions Optimize;
+};
+
+/* The settings a FontForge conversion reads, copied on the game thread like FEFInstallOptions. */
+struct FEFConvertOptions
+{
+	FString FontForgeExecutable;
+	FString Script;
+};
+
+/* One slot's file install, resolved on the game thread. */
+struct FEFSlotInstall
+{
+	/** The slot's Culture metadata, empty for slots that are not localized. */
+	FString Culture;
+	/** The engine file the slot's font is copied over. */
+	FString Target;
+	FString Source;
+};
+
+/*
+* A complete slot -> font mapping. Keys are font property names, values are file names inside FontPath.
+* A slot missing from the mapping uses the shipped default.
+*/
+USTRUCT()
+struct FEFFontProfile
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config, EditAnywhere, Category = Profiles)
+	FName Name;
+
+	UPROPERTY(Config, EditAnywhere, Category = Profiles, meta = (GetKeyOptions = "GetFontSlotNames", GetValueOptions = "GetAllFonts"))
+	TMap<FName, FName> Slots;
+};
+
+/* What one slot held when a snapshot was taken. */
+USTRUCT()
+struct FEFSnapshotSlot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	FName Value;
+
+	/** Content hash of the installed file, its copy lives in the content cache. Empty for the shipped default. */
+	UPROPERTY(Config)
+	FString Hash;
+
+	UPROPERTY(Config)
+	FString Extension;
+
+	bool operator==(const FEFSnapshotSlot& Other) const { return Value == Other.Value && Hash == Other.Hash; }
+};
+
+/*
+* The slot state after one font change. Stepping to a snapshot re-links only the slots whose content differs,
+* from the copies in the content cache, so nothing is converted or subset again.
+*/
+USTRUCT()
+struct FEFFontSnapshot
+{
+	GENERATED_BODY()
+
+	UPROPERTY(Config)
+	FString Label;
+
+	UPROPERTY(Config)
+	FDateTime Time;
+
+	UPROPERTY(Config)
+	TMap<FName, FEFSnapshotSlot> Slots;
+};
+
 #if WITH_EDITOR
 
 UCLASS(Config = "EditorSettings", meta = (DisplayName = "Editor Font Settings"))
@@ -27,6 +123,7 @@ public:
 	static UDevEditor* Get() { return CastChecked<UDevEditor>(UDevEditor::StaticClass()->GetDefaultObject()); }
 
 	virtual TSharedPtr<SWidget> GetCustomSettingsWidget() const override;
+	virtual void PostInitProperties() override;
 
 
 	UPROPERTY()
@@ -34,6 +131,21 @@ public:
 
 	UPROPERTY(Config, EditAnywhere, Category = Settings, meta = (EditCondition = "ToggleSettingsEditable"))
 	FString FontPath;
+
+	UPROPERTY(Config, EditAnywhere, Category = Settings, meta = (EditCondition = "ToggleSettingsEditable", Tooltip = "More folders to pick fonts from. Fonts here are stored by absolute path."))
+	TArray<FDirectoryPath> AdditionalFontDirectories;
+
+	UPROPERTY(Config, EditAnywhere, Category = Settings, meta = (EditCondition = "ToggleSettingsEditable", Tooltip = "Also offer the fonts installed on this machine."))
+	bool bScanSystemFontDirectories{ false };
+
+	UPROPERTY(Config, EditAnywhere, Category = Settings, meta = (EditCondition = "ToggleSettingsEditable", Tooltip = "Keep generated fonts, the font index and the engine font backup in one directory shared by every project and engine install on this machine. Fonts placed in its Fonts folder are offered in every project."))
+	bool bUseSharedCache{ false };
+
+	UPROPERTY(Config, EditAnywhere, Category = Settings, meta = (EditCondition = "ToggleSettingsEditable && bUseSharedCache", Tooltip = "Empty uses EditorFont in the user settings directory."))
+	FDirectoryPath SharedCacheDirectory;
+
+	UPROPERTY(Config, EditAnywhere, Category = Settings, meta = (EditCondition = "ToggleSettingsEditable", Tooltip = "List each font once in the dropdowns, even when the folders hold several copies of it. A copy a slot uses is always listed."))
+	bool bCollapseDuplicateFonts{ true };
 	
 
 	UPROPERTY()
@@ -48,27 +160,27 @@ public:
 	* ======Font Properties======
 	============================*/
 	
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Black.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayPriority = "-1"))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Black.ttf", Typeface = "Black", Axes = "wght=900", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayPriority = "-1"))
 	FName BlackFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-BlackItalic.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-BlackItalic.ttf", Typeface = "BlackItalic", Axes = "wght=900,ital=1", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
 	FName BlackItalicFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Bold.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont", Tooltip = "Font used for blueprint titles."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Bold.ttf", Typeface = "Bold", Axes = "wght=700", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont", Tooltip = "Font used for blueprint titles."))
 	FName BoldFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-BoldCondensed.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont", Tooltip = "Row widget titles"))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-BoldCondensed.ttf", Typeface = "BoldCondensed", Axes = "wght=700,wdth=75", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont", Tooltip = "Row widget titles"))
 	FName BoldCondensedFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-BoldCondensedItalic.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-BoldCondensedItalic.ttf", Typeface = "BoldCondensedItalic", Axes = "wght=700,wdth=75,ital=1", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
 	FName BoldCondensedItalicFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-BoldItalic.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-BoldItalic.ttf", Typeface = "BoldItalic", Axes = "wght=700,ital=1", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
 	FName BoldItalicFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Italic.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont", Tooltip = "Font used under the blueprint titles."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Italic.ttf", Typeface = "Italic", Axes = "wght=400,ital=1", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont", Tooltip = "Font used under the blueprint titles."))
 	FName ItalicFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Light.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Light.ttf", Typeface = "Light", Axes = "wght=300", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
 	FName LightFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Medium.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Medium.ttf", Typeface = "Medium", Axes = "wght=500", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont"))
 	FName MediumFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Regular.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont", Tooltip = "Font used for most things in the editor."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "Roboto-Regular.ttf", Typeface = "Regular", Axes = "wght=400", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", DisplayAfter = "BlackFont", Tooltip = "Font used for most things in the editor."))
 	FName RegularFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "DroidSansMono.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", Tooltip = "Used for the output log and viewport log, I suggest only using a mono font for it."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "DroidSansMono.ttf", Typeface = "Mono", Axes = "wght=400", Monospace = true, GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable", Tooltip = "Used for the output log and viewport log, I suggest only using a mono font for it."))
 	FName MonoFont;
 	/*===========================
 	* ======Font Properties======
@@ -77,31 +189,93 @@ public:
 	/*===========================
 	* ========Other Fonts========
 	============================*/
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "NotoNaskhArabicUI-Regular.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides="bEditLocalizedFonts", Tooltip = "The Arabic localized font."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "NotoNaskhArabicUI-Regular.ttf", Typeface = "Regular", Culture = "ar", GetOptions = "GetArabicFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides="bEditLocalizedFonts", Tooltip = "The Arabic localized font."))
 	FName ArabicFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "NotoSansThai-Regular.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "The Thai localized font."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "NotoSansThai-Regular.ttf", Typeface = "Regular", Culture = "th", GetOptions = "GetThaiFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "The Thai localized font."))
 	FName ThaiFont;
 	/*TODO:Reenable these later when you have it ready*/
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-Regular.otf", GetOptions = "GetOtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Japanese localized font used for most things in the editor."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-Regular.otf", Typeface = "Regular", Culture = "ja", GetOptions = "GetJapaneseFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Japanese localized font used for most things in the editor."))
 	FName JapaneseRegularFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-Bold.otf", GetOptions = "GetOtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Japanese localized font used for bold things in the editor."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-Bold.otf", Typeface = "Bold", Culture = "ja", GetOptions = "GetJapaneseFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Japanese localized font used for bold things in the editor."))
 	FName JapaneseBoldFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-SemiBold.otf", GetOptions = "GetOtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-SemiBold.otf", Typeface = "SemiBold", Culture = "ja", GetOptions = "GetJapaneseFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides))
 	FName JapaneseSemiBoldFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-Heavy.otf", GetOptions = "GetOtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-Heavy.otf", Typeface = "Black", Culture = "ja", GetOptions = "GetJapaneseFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides))
 	FName JapaneseHeavyFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-Light.otf", GetOptions = "GetOtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "GenEiGothicPro-Light.otf", Typeface = "Light", Culture = "ja", GetOptions = "GetJapaneseFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides))
 	FName JapaneseLightFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "NanumGothic.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Korean localized font used for most things in the editor."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "NanumGothic.ttf", Typeface = "Regular", Culture = "ko", GetOptions = "GetKoreanFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Korean localized font used for most things in the editor."))
 	FName KoreanRegularFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "NanumGothicBold.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Korean localized font used for bold things in the editor."))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "NanumGothicBold.ttf", Typeface = "Bold", Culture = "ko", GetOptions = "GetKoreanFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Korean localized font used for bold things in the editor."))
 	FName KoreanBoldFont;
-	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "NanumGothicExtraBold.ttf", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides))
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = true, FileName = "NanumGothicExtraBold.ttf", Typeface = "Black", Culture = "ko", GetOptions = "GetKoreanFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides))
 	FName KoreanBlackFont;
+	UPROPERTY(Config, EditAnywhere, Category = Fonts, meta = (AlternateFont = false, FileName = "DroidSansFallback.ttf", Typeface = "Fallback", Culture = "*", GetOptions = "GetTtfFonts", ShowInnerProperties, EditCondition = "ToggleSettingsEditable && bEditLocalizedFonts", EditConditionHides, Tooltip = "Fallback used for any character the other fonts do not have."))
+	FName FallbackFont;
+
+	/*===========================
+	* =========Subsetting========
+	============================*/
+	UPROPERTY(Config, EditAnywhere, Category = Subsetting, meta = (EditCondition = "ToggleSettingsEditable", Tooltip = "Install the localized fonts trimmed to the characters the editor's localization for that language uses."))
+	bool bSubsetLocalizedFonts{ false };
+
+	UPROPERTY(Config, EditAnywhere, Category = Subsetting, meta = (EditCondition = "ToggleSettingsEditable && bSubsetLocalizedFonts", Tooltip = "Extra code points kept in every subset, e.g. U+3000-U+30FF, U+FF01-U+FF5E"))
+	FString ExtraSubsetRanges;
+
+	/*===========================
+	* ========Optimization=======
+	============================*/
+	UPROPERTY(Config, EditAnywhere, Category = Optimization, meta = (EditCondition = "ToggleSettingsEditable", Tooltip = "Install fonts without the tables the editor never reads (signatures, embedded bitmaps, color layers) and with glyf/loca compacted."))
+	bool bOptimizeInstalledFonts{ false };
+
+	UPROPERTY(Config, EditAnywhere, Category = Optimization, meta = (EditCondition = "ToggleSettingsEditable && bOptimizeInstalledFonts", Tooltip = "Also remove the TrueType hinting programs and glyph instructions. Slate draws small text anti-aliased, where hinting mostly costs load time and memory."))
+	bool bStripFontHinting{ true };
+
+	/*===========================
+	* ===========Family==========
+	============================*/
+	UPROPERTY(Config, EditAnywhere, Category = Family, meta = (GetOptions = "GetFontFamilies", EditCondition = "ToggleSettingsEditable", Tooltip = "Fill the Latin slots from the members of one family, matched by weight, width and italic. Missing styles get the nearest member."))
+	FName FontFamily;
+
+	/*===========================
+	* =======Variable Font=======
+	============================*/
+	UPROPERTY(Config, EditAnywhere, Category = VariableFont, meta = (GetOptions = "GetVariableFonts", EditCondition = "ToggleSettingsEditable", Tooltip = "A variable font to generate every Latin slot from. Each slot gets the instance named by its Axes."))
+	FName VariableFont;
+
+	UPROPERTY(Config, EditAnywhere, Category = VariableFont, meta = (GetKeyOptions = "GetFontSlotNames", EditCondition = "ToggleSettingsEditable", Tooltip = "Per slot axis values (wght=650,wdth=90) or a named instance (SemiBold) used instead of the slot's default."))
+	TMap<FName, FString> VariableInstanceOverrides;
+
+	/*===========================
+	* ==========Merging==========
+	============================*/
+	UPROPERTY(Config, EditAnywhere, Category = Merging, meta = (GetOptions = "GetLatinSlotNames", EditCondition = "ToggleSettingsEditable", Tooltip = "The slot whose font gives the merged face its Latin glyphs, names and line spacing."))
+	FName MergeLatinSlot{ TEXT("RegularFont") };
+
+	UPROPERTY(Config, EditAnywhere, Category = Merging, meta = (GetOptions = "GetCjkSlotNames", EditCondition = "ToggleSettingsEditable", Tooltip = "The slot whose font fills in every character the Latin font does not have."))
+	FName MergeCjkSlot{ TEXT("JapaneseRegularFont") };
+
+	/*===========================
+	* ==========Profiles=========
+	============================*/
+	UPROPERTY(Config, EditAnywhere, Category = Profiles, meta = (EditCondition = "ToggleSettingsEditable", TitleProperty = "Name"))
+	TArray<FEFFontProfile> FontProfiles;
+
+	UPROPERTY(Config, EditAnywhere, Category = Profiles, meta = (GetOptions = "GetProfileNames", EditCondition = "ToggleSettingsEditable", Tooltip = "Switching profile installs only the slots that differ and flushes the font cache once."))
+	FName ActiveProfile;
 
 	UPROPERTY(Config, Category = Settings, EditAnywhere, meta = (DisplayPriority = 3, ToolTip="Show and allow editing of available foreign alphabets."))
 	bool bEditLocalizedFonts{false};
 
+	UPROPERTY(Config, Category = Settings, EditAnywhere, meta = (DisplayPriority = 3, EditCondition = "ToggleSettingsEditable", ToolTip = "How a chosen font reaches the editor. Switching puts the engine back the way it shipped under the old backend and applies the current slots with the new one."))
+	EEFFontBackend FontBackend{ EEFFontBackend::ReplaceFiles };
+
+	UPROPERTY(Config, Category = Settings, EditAnywhere, meta = (DisplayPriority = 4, ToolTip = "Export only, the editor itself does not use them. After each font change, build signed distance field atlases of the active slot fonts that changed, in the background. Cached by font hash in the content cache."))
+	bool bGenerateSdfAtlases{ false };
+
+	UPROPERTY(Config, Category = Settings, EditAnywhere, meta = (DisplayPriority = 4, ClampMin = "1", ToolTip = "Warn when the installed fonts together would take more memory than this once loaded."))
+	int32 FontMemoryBudgetMB{ 32 };
+
 	/*===========================
 	* ========Other Fonts========
 	============================*/
@@ -119,22 +293,82 @@ public:
 
 	UFUNCTION()
 	FString FilePicker(const FString& DialogueTitle);
+	/** Absolute path of a .efpack to open or to save as, empty if cancelled. */
+	FString PackFilePicker(const FString& DialogueTitle, bool bSave);
 
+	/* Lists the fonts anywhere under path, relative to it. */
 	UFUNCTION()
 	bool GetFontsFromFolder(TArray<FString>& string_array, const FString& path);
+	/** FontPath, the additional directories and, unless bWritableOnly, the shared cache's fonts and the system font directories if enabled. */
+	TArray<FString> GetFontRoots(bool bWritableOnly = false) const;
+	/**
+	* Absolute paths of every font under the roots. The font index is refreshed whenever the library is rescanned.
+	* Copies of the same font are left out when bCollapseDuplicateFonts is set, unless bIncludeDuplicates.
+	*/
+	TArray<FString> GetFontLibrary(bool bIncludeDuplicates = false);
+	/** Absolute paths of the fonts the slots and the variable font use now. */
+	TSet<FString> GetSlotFontPaths() const;
+	/** Fonts in the library that are the same font as another one. */
+	TArray<FEFDuplicateGroup> FindDuplicateFonts();
+	/** Deletes the duplicates found in FontPath and the additional directories, never the system fonts. Returns how many were deleted. */
+	int32 RemoveDuplicateFonts(int64& OutBytes);
+	/** Slot value for a library font: relative to FontPath when inside it, absolute otherwise. */
+	FString MakeFontValue(const FString& FontFile) const;
+	/** The file a slot value points at. */
+	FString ResolveFontValue(FName Value) const;
+	/** A real font file for a resolved value: faces and pack members are extracted into the content cache. Empty on failure. */
+	static FString ResolveFontSource(const FString& Path);
+	/** Whether a resolved value points at a font that is there, including faces and pack members. */
+	static bool FontSourceExists(const FString& Path);
+	/** Library fonts with Extension as slot values, every font if Extension is empty. */
+	TArray<FString> GetFontsWithExtension(const FString& Extension);
 	UFUNCTION()
 	TArray<FString> GetOtfFonts();
 	UFUNCTION()
 	TArray<FString> GetTtfFonts();
+	UFUNCTION()
+	TArray<FString> GetAllFonts();
 
+	/* Dropdowns for the localized slots only offer fonts whose cmap covers the script. */
+	UFUNCTION()
+	TArray<FString> GetArabicFonts();
+	UFUNCTION()
+	TArray<FString> GetThaiFonts();
+	UFUNCTION()
+	TArray<FString> GetJapaneseFonts();
+	UFUNCTION()
+	TArray<FString> GetKoreanFonts();
+	TArray<FString> GetFontsCoveringScript(FEFCoverage::EScript Script, const FString& Extension);
+	UFUNCTION()
+	TArray<FString> GetVariableFonts();
+	UFUNCTION()
+	TArray<FString> GetFontFamilies();
+	UFUNCTION()
+	TArray<FString> GetFontSlotNames();
+	UFUNCTION()
+	TArray<FString> GetProfileNames();
+	/** Slots without a Culture, the ones that hold Latin fonts. */
+	UFUNCTION()
+	TArray<FString> GetLatinSlotNames();
+	/** Japanese, Korean, Chinese and fallback slots. */
+	UFUNCTION()
+	TArray<FString> GetCjkSlotNames();
 
+
+	/** Queues the backup of the engine fonts into Defaults, skipped when it already exists. */
 	void CreateDefaultFolder();
+	/** Copies the engine fonts into Target. Runs on the work queue. */
+	bool BuildDefaultFolder(const FString& Target) const;
+	/** Points the content cache, the font index and Defaults at the shared or the per-project location. */
+	void ApplySharedCacheSettings();
 	void CreateTempFontsFolder();
 
 	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
 	virtual void PreEditChange(FProperty* PropertyAboutToChange) override;
 	UPROPERTY()
 	FString CurrentPropValue;
+	/** Library paths GetFontLibrary leaves out, recomputed on each rescan. */
+	TSet<FString> HiddenDuplicateFonts;
 
 #endif
 
@@ -143,36 +377,150 @@ public:
 	void LoadConfigFile();
 	/*
 	* Saves changed setting to config.*
+	* Writes are coalesced by FEFConfigWriter and land on disk shortly after the last change.
 	*/
 	void SaveSettingToConfig();
 
 	UFUNCTION()
 	void MyOnResetDefaults();
 
+	/** Under the file backend the copies run on the work queue: true means queued, the flush and snapshot follow on completion. */
 	bool ResetToDefaults(FProperty* InProperty = nullptr);
 
 	// UFUNCTION(CallInEditor, Category = Settings, meta = (DisplayPriority = 3))
 	// void Reset();
 	
+	/**
+	* Installs one slot, on the work queue under the file backend. A failed install resets the slot.
+	* A queued install returns true right away and only its completion knows the result, inline and composite installs return it.
+	*/
 	bool AlterFont(FNameProperty* Property, FName Value, FString Font);
+
+	/** Every FName property carrying FileName metadata. */
+	TArray<FNameProperty*> GetFontSlotProperties() const;
+	FString GetFontDestinationDir(const FProperty* Property) const;
+	/** The engine-side file Slate loads for the slot. */
+	FString GetInstalledFontPath(const FProperty* Property) const;
+	/**
+	* True unless the slot is localized for a language other than the editor's. The plugin never loads inactive slots eagerly.
+	* Installing one does not load it either, Slate opens slot fonts on first use under both backends.
+	*/
+	bool IsFontSlotActive(const FProperty* Property) const;
+	/** Resident memory of the installed slot fonts. Fonts are measured on the work queue and count with their file size until then. */
+	int64 GetTotalFontResidentBytes() const;
+
+	/*
+	* Install primitives. None of these flush the font cache, callers flush once when they are done.
+	* The synchronous ones wait for queued installs first, so two writers never touch the same engine file.
+	*/
+	static bool ReplaceFontFile(const FString& FontToChange, const FString& SourceFont, FEFWorkQueue::FProgress* Progress = nullptr);
+	bool InstallFontFile(const FProperty* Property, const FString& SourceFont);
+	/** Snapshot of the install settings, taken on the game thread. */
+	FEFInstallOptions GetInstallOptions() const;
+	FEFSlotInstall MakeSlotInstall(const FProperty* Property, const FString& SourceFont) const;
+	/** The file backend's half of InstallFontFile. Reads nothing but its arguments, so work queue jobs can call it. */
+	static bool CopyFontToSlot(const FEFInstallOptions& Options, const FEFSlotInstall& Install, FEFWorkQueue::FProgress* Progress = nullptr);
+	bool RestoreDefaultFont(const FProperty* Property);
+	/**
+	* Restores the slots' shipped fonts, copying on the work queue under the file backend, then flushes and records a snapshot.
+	* Queued restores return true right away, the completion logs the errors.
+	*/
+	bool RestoreDefaultFonts(const TArray<const FProperty*>& Slots, const FString& Label);
+	/** The file that actually gets installed for SourceFont, after the optional install stages (subsetting, then optimization). */
+	static FString ResolveInstallSource(const FEFInstallOptions& Options, const FString& Culture, const FString& SourceFont);
+	void FlushFontCache();
+	/** Restores the engine fonts under the current backend, switches, and applies every slot with the new one. */
+	void SwitchFontBackend(EEFFontBackend NewBackend);
+	/** The composite backend lives in memory only, this rebinds every slot at startup. */
+	void ApplyCompositeFontBindings();
+
+	/** Diffs the profile against the current slots, installs only what changed and flushes once. In the editor true means queued. */
+	bool ApplyFontProfile(FName ProfileName);
+	/** Stores the current slot values under ProfileName, creating the profile if needed. */
+	void CaptureFontProfile(FName ProfileName);
+	/** Writes the profile's fonts and slot mapping into a single .efpack. */
+	bool ExportFontPack(FName ProfileName, const FString& PackFile);
+	/** Points the unlocked slots at the pack's members, installs what changed straight from the mapping and flushes once. In the editor true means queued. */
+	bool ApplyFontPack(const FString& PackFile);
+	/** Maps the family's members onto the slots by OS/2 style, installs the changed slots and flushes once. In the editor true means queued. */
+	bool ApplyFontFamily(FName Family);
+	/**
+	* Validates and installs slot -> FontPath file changes on the work queue without flushing.
+	* OnInstalled runs on the game thread once the slots are set, with the error count, -1 if a source is missing or broken.
+	*/
+	void InstallSlotChanges(const TArray<TPair<FNameProperty*, FName>>& Changes, const FString& Label, TUniqueFunction<void(int32)> OnInstalled);
+	/**
+	* Fills every slot with Axes metadata from instances of VariableFont, installs them and flushes once.
+	* The instances are written on the work queue. In the editor true means queued, inline runs return the result.
+	*/
+	bool ApplyVariableFont();
+	/**
+	* Queues a merge of the fonts in MergeLatinSlot and MergeCjkSlot into FontPath/Merged, where it shows up as a choice for every slot.
+	* With bInstall the Latin slot is switched to it once it is written. In the editor true means queued, inline runs return the result.
+	*/
+	bool MergeSlotFonts(bool bInstall);
+	/** The font file a slot loads now: its value, or the shipped default when it has none. Empty if it cannot be resolved. */
+	FString GetSlotSourceFont(const FNameProperty* Slot) const;
+
+	/** Records the current slots after a change. Only slots installed since the last snapshot are hashed again. */
+	void RecordFontSnapshot(const FString& Label);
+	/** Re-links the unlocked slots that differ from the snapshot and flushes once. Later snapshots stay for redo. */
+	bool RollbackToSnapshot(int32 Index);
+	bool UndoFontChange() { return RollbackToSnapshot(SnapshotCursor - 1); }
+	bool RedoFontChange() { return RollbackToSnapshot(SnapshotCursor + 1); }
+
+	/** Oldest first, the newest is dropped once a change is made after stepping back. */
+	UPROPERTY(Config)
+	TArray<FEFFontSnapshot> FontSnapshots;
+
+	/** The snapshot the slots match now. */
+	UPROPERTY(Config)
+	int32 SnapshotCursor{ INDEX_NONE };
 	
 	UPROPERTY(Config) 
 	TMap<FName, FString> ToggleStates;
 
 	
-	void ConvertFont(FString InFontPath, FString OutputPath);
-	void ConvertFontFolder(FProperty* InProperty, FString Path);
-	bool HandleConversion(FFilePath InPath);
+	/**
+	* Runs FontForge and waits for it, true only on exit code 0 with the output written. Blocks, call it from the work queue.
+	* bNotify false leaves reporting to the caller, folder conversions show one notification for the whole batch.
+	*/
+	static bool ConvertFont(const FEFConvertOptions& Options, FString InFontPath, FString OutputPath, bool bNotify = true);
+	/** Snapshot of the conversion settings, taken on the game thread. */
+	FEFConvertOptions GetConvertOptions() const;
+	/** Returns the number of failed conversions, or -1 if Path is not a directory. In the editor the folder is converted on the work queue and 0 means queued. */
+	int32 ConvertFontFolder(FProperty* InProperty, FString Path);
+	/** Converts on the work queue and waits for FontForge there. In the editor true means queued, inline runs return the result. */
+	bool HandleConversion(FFilePath InPath, FProperty* InProperty = nullptr, bool bNotify = true);
 	void HandleConverterProp(FPropertyChangedEvent& PropertyChangedEvent);
 	void ShowSuccess(FProperty* InProperty, float Duration);
+
+	/** Bundled FontForge when present, otherwise the one found on PATH. */
+	FString GetFontForgeExecutable() const;
+	FString GetFontForgeScript(const FString& ScriptName) const;
+	/** The Python bundled with FontForge, for scripts that need packages rather than the fontforge module. */
+	FString GetFontForgePython() const;
+	/** Full path of ExecutableName in the first PATH directory that has it, empty if none. */
+	static FString FindOnPath(const FString& ExecutableName);
+
+	/** Replaces the engine content dir as install target when set. Lets the benchmark run against a sandbox. */
+	FString FontDestinationOverride;
+	/** Makes SaveSettingToConfig a no-op. The benchmark sets it so its installs and resets never reach the ini. */
+	bool bSuppressConfigSave = false;
 	
 	
-	static void LaunchAndCaptureProcessOutput(const FString& FontForgePath, const FString& Args)
+	/** Returns the process exit code when waiting, 0 otherwise. */
+	static int32 LaunchAndCaptureProcessOutput(const FString& FontForgePath, const FString& Args, bool bWaitForExit = false)
 	{
 	    UE_LOG(LogTemp, Log, TEXT("Launching process:"));
 	    UE_LOG(LogTemp, Log, TEXT("Executable: %s"), *FontForgePath);
 	    UE_LOG(LogTemp, Log, TEXT("Arguments: %s"), *Args);
+	    void* ReadPipe = nullptr;
 	    void* WritePipe = nullptr;
+	    if (bWaitForExit)
+	    {
+	        FPlatformProcess::CreatePipe(ReadPipe, WritePipe);
+	    }
 	    FProcHandle ProcHandle = FPlatformProcess::CreateProc(
 	        *FontForgePath, 
 	        *Args, 
@@ -184,9 +532,32 @@ public:
 	        nullptr,
 	        WritePipe
 	    );
+	    int32 ReturnCode = 0;
+	    if (bWaitForExit)
+	    {
+	        FString Output;
+	        while (FPlatformProcess::IsProcRunning(ProcHandle))
+	        {
+	            Output += FPlatformProcess::ReadPipe(ReadPipe);
+	            FPlatformProcess::Sleep(0.01f);
+	        }
+	        Output += FPlatformProcess::ReadPipe(ReadPipe);
+	        if (!FPlatformProcess::GetProcReturnCode(ProcHandle, &ReturnCode))
+	        {
+	            ReturnCode = -1;
+	        }
+	        if (!Output.IsEmpty())
+	        {
+	            UE_LOG(LogTemp, Log, TEXT("%s"), *Output);
+	        }
+	        FPlatformProcess::ClosePipe(ReadPipe, WritePipe);
+	    }
 	    FPlatformProcess::CloseProc(ProcHandle);
 
 	    UE_LOG(LogTemp, Log, TEXT("Process has completed."));
+	    return ReturnCode;
 	}
 protected:
+	/** Slots installed or restored since the last snapshot. */
+	TSet<FName> SlotsChangedSinceSnapshot;
 };
@@ -0,0 +1,20 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Font file logic in plain C++17: nothing in Public/ or Private/ includes an engine header except the module registration,
+// so the same sources compile outside the editor. The CMakeLists.txt at the plugin root builds them headless with their tests.
+public class EditorFontCore : ModuleRules
+{
+	public EditorFontCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+			}
+			);
+	}
+}
@@ -0,0 +1,230 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFCoreFontFile.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <set>
+#include <system_error>
+
+
+namespace
+{
+    constexpr uint32_t TagTtcf = 0x74746366; // 'ttcf'
+    constexpr uint32_t TagTrue = 0x74727565; // 'true'
+    constexpr uint32_t TagOtto = 0x4F54544F; // 'OTTO'
+    constexpr uint32_t SfntHeaderBytes = 12;
+    constexpr uint32_t TableRecordBytes = 16;
+    // The directory of any real font is far below this, a larger count is garbage rather than a font.
+    constexpr uint32_t MaxTables = 256;
+    constexpr uint32_t MaxFaces = 4096;
+
+    uint16_t ReadU16(const uint8_t* Ptr) { return uint16_t((Ptr[0] << 8) | Ptr[1]); }
+    uint32_t ReadU32(const uint8_t* Ptr) { return (uint32_t(Ptr[0]) << 24) | (uint32_t(Ptr[1]) << 16) | (uint32_t(Ptr[2]) << 8) | uint32_t(Ptr[3]); }
+
+    std::string TagToString(uint32_t Tag)
+    {
+        return { char(Tag >> 24), char(Tag >> 16), char(Tag >> 8), char(Tag) };
+    }
+
+    bool IsSfntVersion(uint32_t Version)
+    {
+        return Version == 0x00010000 || Version == TagTrue || Version == TagOtto;
+    }
+
+    // Reads byte ranges either from memory or from an open file, so a file is validated without loading its glyphs.
+    class FRangeReader
+    {
+    public:
+        FRangeReader(const uint8_t* InData, size_t InSize) : Data(InData), Size(InSize) {}
+        FRangeReader(std::ifstream& InFile, size_t InSize) : File(&InFile), Size(InSize) {}
+
+        size_t GetSize() const { return Size; }
+
+        bool Read(uint64_t Offset, size_t Bytes, std::vector<uint8_t>& Out) const
+        {
+            if (Offset + Bytes > Size) { return false; }
+            Out.resize(Bytes);
+            if (Data)
+            {
+                std::memcpy(Out.data(), Data + Offset, Bytes);
+                return true;
+            }
+            File->clear();
+            File->seekg(std::streamoff(Offset));
+            File->read(reinterpret_cast<char*>(Out.data()), std::streamsize(Bytes));
+            return size_t(File->gcount()) == Bytes;
+        }
+
+    private:
+        const uint8_t* Data = nullptr;
+        std::ifstream* File = nullptr;
+        size_t Size = 0;
+    };
+
+    EFCore::EFontFileError ValidateFace(const FRangeReader& Reader, uint64_t FaceOffset, EFCore::FFontFileInfo* OutInfo)
+    {
+        using EFCore::EFontFileError;
+        std::vector<uint8_t> Header;
+        if (!Reader.Read(FaceOffset, SfntHeaderBytes, Header)) { return EFontFileError::Truncated; }
+        if (!IsSfntVersion(ReadU32(Header.data()))) { return EFontFileError::UnknownFormat; }
+        const uint32_t NumTables = ReadU16(Header.data() + 4);
+        if (NumTables == 0 || NumTables > MaxTables) { return EFontFileError::UnknownFormat; }
+
+        std::vector<uint8_t> Directory;
+        if (!Reader.Read(FaceOffset + SfntHeaderBytes, size_t(NumTables) * TableRecordBytes, Directory)) { return EFontFileError::Truncated; }
+        std::set<std::string> Tags;
+        for (uint32_t Index = 0; Index < NumTables; Index++)
+        {
+            const uint8_t* Record = Directory.data() + Index * TableRecordBytes;
+            const uint64_t Offset = ReadU32(Record + 8);
+            const uint64_t Length = ReadU32(Record + 12);
+            if (Offset + Length > Reader.GetSize()) { return EFontFileError::Truncated; }
+            Tags.insert(TagToString(ReadU32(Record)));
+        }
+
+        for (const char* Required : { "cmap", "head", "hhea", "hmtx", "maxp" })
+        {
+            if (Tags.count(Required) == 0) { return EFontFileError::MissingTable; }
+        }
+        const bool bTrueType = Tags.count("glyf") && Tags.count("loca");
+        const bool bCff = Tags.count("CFF ") || Tags.count("CFF2");
+        if (!bTrueType && !bCff) { return EFontFileError::MissingTable; }
+
+        if (OutInfo && OutInfo->Tables.empty())
+        {
+            OutInfo->bCff = bCff && !bTrueType;
+            OutInfo->Tables.assign(Tags.begin(), Tags.end());
+        }
+        return EFontFileError::None;
+    }
+
+    EFCore::EFontFileError Validate(const FRangeReader& Reader, EFCore::FFontFileInfo* OutInfo)
+    {
+        using EFCore::EFontFileError;
+        if (OutInfo) { *OutInfo = EFCore::FFontFileInfo(); }
+        std::vector<uint8_t> Header;
+        if (!Reader.Read(0, SfntHeaderBytes, Header)) { return EFontFileError::UnknownFormat; }
+
+        if (ReadU32(Header.data()) != TagTtcf)
+        {
+            const EFontFileError Error = ValidateFace(Reader, 0, OutInfo);
+            if (Error == EFontFileError::None && OutInfo) { OutInfo->NumFaces = 1; }
+            return Error;
+        }
+
+        const uint32_t NumFaces = ReadU32(Header.data() + 8);
+        if (NumFaces == 0 || NumFaces > MaxFaces) { return EFontFileError::UnknownFormat; }
+        std::vector<uint8_t> Offsets;
+        if (!Reader.Read(SfntHeaderBytes, size_t(NumFaces) * 4, Offsets)) { return EFontFileError::Truncated; }
+        for (uint32_t Face = 0; Face < NumFaces; Face++)
+        {
+            const EFontFileError Error = ValidateFace(Reader, ReadU32(Offsets.data() + Face * 4), OutInfo);
+            if (Error != EFontFileError::None) { return Error; }
+        }
+        if (OutInfo) { OutInfo->NumFaces = int32_t(NumFaces); }
+        return EFontFileError::None;
+    }
+
+    bool IsHidden(const std::filesystem::path& Path)
+    {
+        const std::string Name = EFCore::PathToUtf8(Path.filename());
+        return !Name.empty() && Name[0] == '.';
+    }
+}
+
+namespace EFCore
+{
+    const char* LexToString(EFontFileError Error)
+    {
+        switch (Error)
+        {
+        case EFontFileError::None: return "valid";
+        case EFontFileError::Unreadable: return "file could not be read";
+        case EFontFileError::UnknownFormat: return "not a TrueType, OpenType or collection file";
+        case EFontFileError::Truncated: return "table directory points past the end of the file";
+        case EFontFileError::MissingTable: return "a table needed for text layout is missing";
+        }
+        return "unknown error";
+    }
+
+    const std::vector<std::string>& GetFontExtensions()
+    {
+        static const std::vector<std::string> Extensions = { ".ttf", ".otf", ".ttc", ".otc" };
+        return Extensions;
+    }
+
+    bool IsFontFileName(std::string_view Name)
+    {
+        for (const std::string& Extension : GetFontExtensions())
+        {
+            if (Name.size() < Extension.size()) { continue; }
+            const std::string_view Tail = Name.substr(Name.size() - Extension.size());
+            const bool bMatches = std::equal(Tail.begin(), Tail.end(), Extension.begin(),
+                [](char A, char B) { return (A >= 'A' && A <= 'Z' ? char(A - 'A' + 'a') : A) == B; });
+            if (bMatches) { return true; }
+        }
+        return false;
+    }
+
+    EFontFileError ValidateFont(const uint8_t* Data, size_t Size, FFontFileInfo* OutInfo)
+    {
+        return Validate(FRangeReader(Data, Size), OutInfo);
+    }
+
+    EFontFileError ValidateFontFile(const std::filesystem::path& Filename, FFontFileInfo* OutInfo)
+    {
+        std::error_code Error;
+        const uintmax_t Size = std::filesystem::file_size(Filename, Error);
+        std::ifstream File(Filename, std::ios::binary);
+        if (Error || !File) { return EFontFileError::Unreadable; }
+        return Validate(FRangeReader(File, size_t(Size)), OutInfo);
+    }
+
+    std::vector<std::filesystem::path> ScanFontFiles(const std::vector<std::filesystem::path>& Roots, int32_t MaxDepth)
+    {
+        namespace fs = std::filesystem;
+        std::set<fs::path> Visited;
+        std::vector<fs::path> Frontier;
+        for (const fs::path& Root : Roots)
+        {
+            std::error_code Error;
+            const fs::path Canonical = fs::canonical(Root, Error);
+            if (Error || !fs::is_directory(Canonical, Error)) { continue; }
+            if (Visited.insert(Canonical).second)
+            {
+                Frontier.push_back(fs::absolute(Root, Error).lexically_normal());
+            }
+        }
+
+        std::vector<fs::path> Files;
+        for (int32_t Depth = 0; !Frontier.empty() && Depth < MaxDepth; Depth++)
+        {
+            std::vector<fs::path> Next;
+            for (const fs::path& Directory : Frontier)
+            {
+                std::error_code Error;
+                for (fs::directory_iterator It(Directory, Error), End; !Error && It != End; It.increment(Error))
+                {
+                    const fs::path& Path = It->path();
+                    if (IsHidden(Path)) { continue; }
+                    std::error_code StatusError;
+                    if (It->is_directory(StatusError))
+                    {
+                        // Listed by the path it was reached through, deduplicated by where it really is.
+                        const fs::path Canonical = fs::canonical(Path, StatusError);
+                        if (!StatusError && Visited.insert(Canonical).second) { Next.push_back(Path); }
+                    }
+                    else if (IsFontFileName(PathToUtf8(Path.filename())))
+                    {
+                        Files.push_back(Path);
+                    }
+                }
+            }
+            Frontier = std::move(Next);
+        }
+        std::sort(Files.begin(), Files.end());
+        return Files;
+    }
+}
@@ -0,0 +1,154 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFCoreHash.h"
+
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+
+namespace
+{
+    // Large enough to amortize the read calls, small enough to hash fonts on a worker without a heap spike.
+    constexpr size_t ReadChunkBytes = 64 * 1024;
+
+    constexpr uint32_t Shifts[64] = {
+        7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22, 7, 12, 17, 22,
+        5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20, 5, 9, 14, 20,
+        4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23, 4, 11, 16, 23,
+        6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21, 6, 10, 15, 21 };
+
+    // floor(abs(sin(i + 1)) * 2^32)
+    constexpr uint32_t Constants[64] = {
+        0xd76aa478, 0xe8c7b756, 0x242070db, 0xc1bdceee, 0xf57c0faf, 0x4787c62a, 0xa8304613, 0xfd469501,
+        0x698098d8, 0x8b44f7af, 0xffff5bb1, 0x895cd7be, 0x6b901122, 0xfd987193, 0xa679438e, 0x49b40821,
+        0xf61e2562, 0xc040b340, 0x265e5a51, 0xe9b6c7aa, 0xd62f105d, 0x02441453, 0xd8a1e681, 0xe7d3fbc8,
+        0x21e1cde6, 0xc33707d6, 0xf4d50d87, 0x455a14ed, 0xa9e3e905, 0xfcefa3f8, 0x676f02d9, 0x8d2a4c8a,
+        0xfffa3942, 0x8771f681, 0x6d9d6122, 0xfde5380c, 0xa4beea44, 0x4bdecfa9, 0xf6bb4b60, 0xbebfbc70,
+        0x289b7ec6, 0xeaa127fa, 0xd4ef3085, 0x04881d05, 0xd9d4d039, 0xe6db99e5, 0x1fa27cf8, 0xc4ac5665,
+        0xf4292244, 0x432aff97, 0xab9423a7, 0xfc93a039, 0x655b59c3, 0x8f0ccc92, 0xffeff47d, 0x85845dd1,
+        0x6fa87e4f, 0xfe2ce6e0, 0xa3014314, 0x4e0811a1, 0xf7537e82, 0xbd3af235, 0x2ad7d2bb, 0xeb86d391 };
+
+    uint32_t RotateLeft(uint32_t Value, uint32_t Bits)
+    {
+        return (Value << Bits) | (Value >> (32 - Bits));
+    }
+}
+
+namespace EFCore
+{
+    FMD5::FMD5()
+        : State{ 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 }
+    {
+    }
+
+    void FMD5::Update(const void* Data, size_t Size)
+    {
+        const uint8_t* Bytes = static_cast<const uint8_t*>(Data);
+        size_t Used = size_t(Length % 64);
+        Length += Size;
+        if (Used > 0)
+        {
+            const size_t Fill = Size < 64 - Used ? Size : 64 - Used;
+            std::memcpy(Buffer + Used, Bytes, Fill);
+            Bytes += Fill;
+            Size -= Fill;
+            if (Used + Fill < 64) { return; }
+            Transform(Buffer);
+        }
+        for (; Size >= 64; Bytes += 64, Size -= 64)
+        {
+            Transform(Bytes);
+        }
+        std::memcpy(Buffer, Bytes, Size);
+    }
+
+    void FMD5::Final(uint8_t OutDigest[16])
+    {
+        const uint64_t BitLength = Length * 8;
+        const uint8_t Padding = 0x80;
+        Update(&Padding, 1);
+        const uint8_t Zero = 0;
+        while (Length % 64 != 56)
+        {
+            Update(&Zero, 1);
+        }
+        uint8_t LengthBytes[8];
+        for (int Index = 0; Index < 8; Index++)
+        {
+            LengthBytes[Index] = uint8_t(BitLength >> (8 * Index));
+        }
+        Update(LengthBytes, 8);
+        for (int Index = 0; Index < 16; Index++)
+        {
+            OutDigest[Index] = uint8_t(State[Index / 4] >> (8 * (Index % 4)));
+        }
+    }
+
+    std::string FMD5::ToHex(const uint8_t Digest[16])
+    {
+        static const char Digits[] = "0123456789abcdef";
+        std::string Hex(32, '0');
+        for (int Index = 0; Index < 16; Index++)
+        {
+            Hex[Index * 2] = Digits[Digest[Index] >> 4];
+            Hex[Index * 2 + 1] = Digits[Digest[Index] & 0xf];
+        }
+        return Hex;
+    }
+
+    void FMD5::Transform(const uint8_t Block[64])
+    {
+        uint32_t Words[16];
+        for (int Index = 0; Index < 16; Index++)
+        {
+            Words[Index] = uint32_t(Block[Index * 4]) | (uint32_t(Block[Index * 4 + 1]) << 8)
+                | (uint32_t(Block[Index * 4 + 2]) << 16) | (uint32_t(Block[Index * 4 + 3]) << 24);
+        }
+        uint32_t A = State[0], B = State[1], C = State[2], D = State[3];
+        for (uint32_t Round = 0; Round < 64; Round++)
+        {
+            uint32_t F;
+            uint32_t Word;
+            if (Round < 16) { F = (B & C) | (~B & D); Word = Round; }
+            else if (Round < 32) { F = (D & B) | (~D & C); Word = (5 * Round + 1) % 16; }
+            else if (Round < 48) { F = B ^ C ^ D; Word = (3 * Round + 5) % 16; }
+            else { F = C ^ (B | ~D); Word = (7 * Round) % 16; }
+            const uint32_t Next = B + RotateLeft(A + F + Constants[Round] + Words[Word], Shifts[Round]);
+            A = D;
+            D = C;
+            C = B;
+            B = Next;
+        }
+        State[0] += A;
+        State[1] += B;
+        State[2] += C;
+        State[3] += D;
+    }
+
+    std::string HashBytes(const void* Data, size_t Size)
+    {
+        FMD5 Hasher;
+        Hasher.Update(Data, Size);
+        uint8_t Digest[16];
+        Hasher.Final(Digest);
+        return FMD5::ToHex(Digest);
+    }
+
+    std::string HashFile(const std::filesystem::path& Filename)
+    {
+        std::ifstream File(Filename, std::ios::binary);
+        if (!File) { return std::string(); }
+        FMD5 Hasher;
+        std::vector<char> Chunk(ReadChunkBytes);
+        while (File)
+        {
+            File.read(Chunk.data(), std::streamsize(Chunk.size()));
+            Hasher.Update(Chunk.data(), size_t(File.gcount()));
+        }
+        if (File.bad()) { return std::string(); }
+        uint8_t Digest[16];
+        Hasher.Final(Digest);
+        return FMD5::ToHex(Digest);
+    }
+}
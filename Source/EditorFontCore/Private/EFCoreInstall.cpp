@@ -0,0 +1,78 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFCoreInstall.h"
+
+#include <atomic>
+#include <fstream>
+#include <random>
+#include <system_error>
+#include <vector>
+
+
+namespace
+{
+    // Progress granularity: a multi-megabyte CJK font still reports a few dozen times.
+    constexpr size_t CopyChunkBytes = 256 * 1024;
+
+    // Unique per call: a per-process token keeps two editors apart, the counter two writers in one process.
+    std::filesystem::path MakeTempPath(const std::filesystem::path& Target)
+    {
+        static const uint32_t ProcessToken = std::random_device()();
+        static std::atomic<uint32_t> Counter{ 0 };
+        std::filesystem::path Temp = Target;
+        Temp += ".eftmp." + std::to_string(ProcessToken) + "." + std::to_string(Counter++);
+        return Temp;
+    }
+
+    bool Fail(std::string* OutError, const std::string& Reason)
+    {
+        if (OutError) { *OutError = Reason; }
+        return false;
+    }
+}
+
+namespace EFCore
+{
+    bool ReplaceFile(const std::filesystem::path& Target, const std::filesystem::path& Source, const FCopyProgressFunc& OnProgress, std::string* OutError)
+    {
+        namespace fs = std::filesystem;
+        std::error_code Error;
+        if (!fs::is_regular_file(Source, Error)) { return Fail(OutError, "source is not a file: " + PathToUtf8(Source)); }
+        const fs::path Temp = MakeTempPath(Target);
+        {
+            std::ifstream In(Source, std::ios::binary);
+            std::ofstream Out(Temp, std::ios::binary | std::ios::trunc);
+            if (!In || !Out)
+            {
+                Out.close();
+                fs::remove(Temp, Error);
+                return Fail(OutError, !In ? "could not open " + PathToUtf8(Source) : "could not write " + PathToUtf8(Temp));
+            }
+            std::vector<char> Chunk(CopyChunkBytes);
+            while (In)
+            {
+                In.read(Chunk.data(), std::streamsize(Chunk.size()));
+                const std::streamsize Read = In.gcount();
+                if (Read <= 0) { break; }
+                if (!Out.write(Chunk.data(), Read)) { break; }
+                if (OnProgress) { OnProgress(uint64_t(Read)); }
+            }
+            Out.close();
+            if (In.bad() || !Out)
+            {
+                fs::remove(Temp, Error);
+                return Fail(OutError, "copy failed: " + PathToUtf8(Source));
+            }
+        }
+        // rename replaces an existing target atomically on POSIX. Windows refuses while the file is mapped,
+        // which is the same condition the old delete-then-copy stopped on.
+        fs::rename(Temp, Target, Error);
+        if (Error)
+        {
+            std::error_code Ignored;
+            fs::remove(Temp, Ignored);
+            return Fail(OutError, "could not replace " + PathToUtf8(Target) + ": " + Error.message());
+        }
+        return true;
+    }
+}
@@ -0,0 +1,71 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#include "EFCorePlan.h"
+
+#include <system_error>
+
+
+namespace
+{
+    std::string ToLower(std::string Value)
+    {
+        for (char& Char : Value)
+        {
+            if (Char >= 'A' && Char <= 'Z') { Char = char(Char - 'A' + 'a'); }
+        }
+        return Value;
+    }
+}
+
+namespace EFCore
+{
+    std::vector<FSlotChange> PlanInstall(const std::vector<FSlotState>& Slots, const std::map<std::string, std::string>& Targets)
+    {
+        std::vector<FSlotChange> Changes;
+        for (const FSlotState& Slot : Slots)
+        {
+            if (!Slot.bEnabled) { continue; }
+            const auto Target = Targets.find(Slot.Name);
+            const std::string TargetValue = Target != Targets.end() ? Target->second : std::string();
+            if (Slot.Value != TargetValue)
+            {
+                Changes.push_back({ Slot.Name, TargetValue });
+            }
+        }
+        return Changes;
+    }
+
+    std::vector<FSlotChange> PlanReset(const std::vector<FSlotState>& Slots)
+    {
+        std::vector<FSlotChange> Changes;
+        for (const FSlotState& Slot : Slots)
+        {
+            if (Slot.bEnabled) { Changes.push_back({ Slot.Name, std::string() }); }
+        }
+        return Changes;
+    }
+
+    std::optional<FConversion> PlanConversion(const std::filesystem::path& Source)
+    {
+        const std::string Extension = ToLower(PathToUtf8(Source.extension()));
+        if (Extension != ".ttf" && Extension != ".otf") { return std::nullopt; }
+        std::filesystem::path Output = Source;
+        Output.replace_extension(Extension == ".ttf" ? ".otf" : ".ttf");
+        return FConversion{ Source, Output };
+    }
+
+    std::vector<FConversion> PlanConversions(const std::vector<std::filesystem::path>& Files, bool bSkipExisting)
+    {
+        std::vector<FConversion> Conversions;
+        for (const std::filesystem::path& File : Files)
+        {
+            std::error_code Error;
+            if (!std::filesystem::is_regular_file(File, Error)) { continue; }
+            std::optional<FConversion> Conversion = PlanConversion(File);
+            if (!Conversion) { continue; }
+            if (bSkipExisting && std::filesystem::exists(Conversion->Output, Error)) { continue; }
+            Conversions.push_back(*Conversion);
+        }
+        return Conversions;
+    }
+}
@@ -0,0 +1,6 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+// The only engine-facing file of the module, leave it out to build the core on its own.
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_MODULE(FDefaultModuleImpl, EditorFontCore)
@@ -0,0 +1,22 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+// UnrealBuildTool defines the export macro, a plain compiler build of the core gets an empty one.
+#ifndef EDITORFONTCORE_API
+#define EDITORFONTCORE_API
+#endif
+
+#include <filesystem>
+#include <string>
+
+namespace EFCore
+{
+	/** A path as UTF-8. path::string() converts to the ANSI code page on Windows and throws for names it cannot hold. */
+	inline std::string PathToUtf8(const std::filesystem::path& Path)
+	{
+		// u8string() returns std::string in C++17 and std::u8string from C++20 on, copying the bytes works for both.
+		const auto Utf8 = Path.u8string();
+		return std::string(Utf8.begin(), Utf8.end());
+	}
+}
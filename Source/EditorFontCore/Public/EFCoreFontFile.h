@@ -0,0 +1,56 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "EFCoreDefines.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace EFCore
+{
+	enum class EFontFileError
+	{
+		None,
+		Unreadable,
+		/** Not an sfnt or collection. */
+		UnknownFormat,
+		/** The table directory, or a table it points to, runs past the end of the file. */
+		Truncated,
+		/** cmap, head, hhea, hmtx, maxp or the outlines are missing. */
+		MissingTable,
+	};
+
+	struct FFontFileInfo
+	{
+		/** Faces in a collection, 1 for a plain font. */
+		int32_t NumFaces = 0;
+		bool bCff = false;
+		/** Table tags of the first face. */
+		std::vector<std::string> Tables;
+	};
+
+	EDITORFONTCORE_API const char* LexToString(EFontFileError Error);
+
+	/** TrueType, OpenType and collection extensions, with the leading dot. */
+	EDITORFONTCORE_API const std::vector<std::string>& GetFontExtensions();
+	/** True if Name ends in one of GetFontExtensions(), in any case. */
+	EDITORFONTCORE_API bool IsFontFileName(std::string_view Name);
+
+	/**
+	* Checks the structure the editor relies on before a font is installed over an engine one:
+	* the header, every table directory entry in bounds, and the tables Slate needs to lay out text.
+	*/
+	EDITORFONTCORE_API EFontFileError ValidateFont(const uint8_t* Data, size_t Size, FFontFileInfo* OutInfo = nullptr);
+	EDITORFONTCORE_API EFontFileError ValidateFontFile(const std::filesystem::path& Filename, FFontFileInfo* OutInfo = nullptr);
+
+	/**
+	* Font files under Roots, sorted. Hidden entries are skipped, directories reached twice
+	* through links are listed once and MaxDepth stops loops the canonical paths cannot see.
+	*/
+	EDITORFONTCORE_API std::vector<std::filesystem::path> ScanFontFiles(const std::vector<std::filesystem::path>& Roots, int32_t MaxDepth = 32);
+}
@@ -0,0 +1,43 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "EFCoreDefines.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace EFCore
+{
+	/*
+	* MD5 (RFC 1321), bit for bit what FMD5 produces, so content cache keys, pack manifests and snapshots
+	* written by earlier versions keep matching.
+	*/
+	class EDITORFONTCORE_API FMD5
+	{
+	public:
+		FMD5();
+
+		void Update(const void* Data, size_t Size);
+		/** Finishes the digest. The hasher must not be updated afterwards. */
+		void Final(uint8_t OutDigest[16]);
+
+		/** Lowercase hex of a 16 byte digest. */
+		static std::string ToHex(const uint8_t Digest[16]);
+
+	private:
+		void Transform(const uint8_t Block[64]);
+
+		uint32_t State[4];
+		uint64_t Length = 0;
+		uint8_t Buffer[64];
+	};
+
+	/** Lowercase hex MD5 of Size bytes. */
+	EDITORFONTCORE_API std::string HashBytes(const void* Data, size_t Size);
+
+	/** Lowercase hex MD5 of a file's content, empty if it cannot be read. */
+	EDITORFONTCORE_API std::string HashFile(const std::filesystem::path& Filename);
+}
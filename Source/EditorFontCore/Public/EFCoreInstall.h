@@ -0,0 +1,24 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "EFCoreDefines.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+
+namespace EFCore
+{
+	/** Called with the bytes written since the last call. */
+	using FCopyProgressFunc = std::function<void(uint64_t)>;
+
+	/**
+	* Copies Source over Target through a uniquely named temporary file next to Target, then renames it into place.
+	* A failed or interrupted copy leaves the old Target untouched instead of a half written engine font.
+	* OutError gets a readable reason on failure.
+	*/
+	EDITORFONTCORE_API bool ReplaceFile(const std::filesystem::path& Target, const std::filesystem::path& Source,
+		const FCopyProgressFunc& OnProgress = nullptr, std::string* OutError = nullptr);
+}
@@ -0,0 +1,54 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include "EFCoreDefines.h"
+
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace EFCore
+{
+	/** One font slot as the planner sees it. An empty Value is the shipped default. */
+	struct FSlotState
+	{
+		std::string Name;
+		std::string Value;
+		/** False for slots the user toggled off, plans never touch them. */
+		bool bEnabled = true;
+	};
+
+	struct FSlotChange
+	{
+		std::string Name;
+		/** Empty restores the shipped default. */
+		std::string Value;
+	};
+
+	/**
+	* The slots whose value differs from Targets, in slot order. A slot missing from Targets goes back to the default,
+	* the way a profile that does not mention a slot means the shipped font.
+	*/
+	EDITORFONTCORE_API std::vector<FSlotChange> PlanInstall(const std::vector<FSlotState>& Slots, const std::map<std::string, std::string>& Targets);
+
+	/** Every enabled slot, defaults included: a reset also repairs engine files changed behind the plugin's back. */
+	EDITORFONTCORE_API std::vector<FSlotChange> PlanReset(const std::vector<FSlotState>& Slots);
+
+	struct FConversion
+	{
+		std::filesystem::path Source;
+		std::filesystem::path Output;
+	};
+
+	/** TrueType goes to OpenType and back, next to the source. Nothing for any other extension. */
+	EDITORFONTCORE_API std::optional<FConversion> PlanConversion(const std::filesystem::path& Source);
+
+	/**
+	* Conversions for the given files, in order. Files that do not exist are dropped, and with bSkipExisting
+	* so are files whose output is already there, which keeps a second run over a folder from redoing the first.
+	*/
+	EDITORFONTCORE_API std::vector<FConversion> PlanConversions(const std::vector<std::filesystem::path>& Files, bool bSkipExisting);
+}
@@ -0,0 +1,117 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+// Synthetic fonts for the tests and the benchmark: a valid header and table directory around tables
+// filled with a repeating pattern. Nothing here parses outlines, so that is all a font needs to be.
+namespace EFCoreTestFonts
+{
+	inline const std::vector<std::string>& GetTrueTypeTables()
+	{
+		static const std::vector<std::string> Tables = { "cmap", "glyf", "head", "hhea", "hmtx", "loca", "maxp", "name" };
+		return Tables;
+	}
+
+	inline void AppendU16(std::vector<uint8_t>& Out, uint32_t Value)
+	{
+		Out.push_back(uint8_t(Value >> 8));
+		Out.push_back(uint8_t(Value));
+	}
+
+	inline void AppendU32(std::vector<uint8_t>& Out, uint32_t Value)
+	{
+		AppendU16(Out, Value >> 16);
+		AppendU16(Out, Value & 0xFFFF);
+	}
+
+	/** One face. Table offsets count from BaseOffset, where the face starts inside a collection. */
+	inline std::vector<uint8_t> MakeFont(const std::vector<std::string>& Tables, uint32_t TableBytes = 64, uint32_t BaseOffset = 0)
+	{
+		std::vector<uint8_t> Font;
+		AppendU32(Font, 0x00010000);
+		AppendU16(Font, uint32_t(Tables.size()));
+		AppendU16(Font, 0);
+		AppendU16(Font, 0);
+		AppendU16(Font, 0);
+		const uint32_t Padded = (TableBytes + 3) & ~3u;
+		uint32_t Offset = BaseOffset + 12 + 16 * uint32_t(Tables.size());
+		for (const std::string& Tag : Tables)
+		{
+			for (char Char : Tag) { Font.push_back(uint8_t(Char)); }
+			AppendU32(Font, 0);
+			AppendU32(Font, Offset);
+			AppendU32(Font, TableBytes);
+			Offset += Padded;
+		}
+		for (size_t Table = 0; Table < Tables.size(); Table++)
+		{
+			for (uint32_t Byte = 0; Byte < Padded; Byte++)
+			{
+				Font.push_back(uint8_t(Table * 31 + Byte));
+			}
+		}
+		return Font;
+	}
+
+	inline std::vector<uint8_t> MakeCollection(uint32_t NumFaces, uint32_t TableBytes = 64)
+	{
+		const uint32_t HeaderBytes = 12 + 4 * NumFaces;
+		const size_t FaceBytes = MakeFont(GetTrueTypeTables(), TableBytes).size();
+		std::vector<uint8_t> Collection;
+		AppendU32(Collection, 0x74746366); // 'ttcf'
+		AppendU32(Collection, 0x00010000);
+		AppendU32(Collection, NumFaces);
+		for (uint32_t Face = 0; Face < NumFaces; Face++)
+		{
+			AppendU32(Collection, HeaderBytes + Face * uint32_t(FaceBytes));
+		}
+		for (uint32_t Face = 0; Face < NumFaces; Face++)
+		{
+			const std::vector<uint8_t> Font = MakeFont(GetTrueTypeTables(), TableBytes, HeaderBytes + Face * uint32_t(FaceBytes));
+			Collection.insert(Collection.end(), Font.begin(), Font.end());
+		}
+		return Collection;
+	}
+
+	inline bool WriteFile(const std::filesystem::path& Path, const std::vector<uint8_t>& Data)
+	{
+		std::ofstream Out(Path, std::ios::binary | std::ios::trunc);
+		Out.write(reinterpret_cast<const char*>(Data.data()), std::streamsize(Data.size()));
+		return bool(Out);
+	}
+
+	inline std::vector<uint8_t> ReadFile(const std::filesystem::path& Path)
+	{
+		std::ifstream In(Path, std::ios::binary);
+		return std::vector<uint8_t>((std::istreambuf_iterator<char>(In)), std::istreambuf_iterator<char>());
+	}
+
+	/** A fresh empty directory under the system temp folder, removed again by the destructor. */
+	class FTempDir
+	{
+	public:
+		explicit FTempDir(const std::string& Name)
+		{
+			Path = std::filesystem::temp_directory_path() / (Name + "-" + std::to_string(std::random_device()()));
+			std::filesystem::remove_all(Path);
+			std::filesystem::create_directories(Path);
+		}
+		~FTempDir()
+		{
+			std::error_code Ignored;
+			std::filesystem::remove_all(Path, Ignored);
+		}
+		const std::filesystem::path& Get() const { return Path; }
+
+	private:
+		std::filesystem::path Path;
+	};
+}
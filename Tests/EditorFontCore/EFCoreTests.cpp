@@ -0,0 +1,255 @@
+// Copyright 2024 Daniel Karasov Lerner. All Rights Reserved.
+
+// Headless tests for EditorFontCore. Build with the CMakeLists.txt at the plugin root and run through ctest.
+
+#include "EFCoreFontFile.h"
+#include "EFCoreHash.h"
+#include "EFCoreInstall.h"
+#include "EFCorePlan.h"
+#include "EFCoreTestFonts.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+
+
+namespace
+{
+    int Failures = 0;
+
+    void Check(bool bCondition, const char* Expression, const char* File, int Line)
+    {
+        if (!bCondition)
+        {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", File, Line, Expression);
+            Failures++;
+        }
+    }
+
+    #define EF_CHECK(Expression) Check(bool(Expression), #Expression, __FILE__, __LINE__)
+
+    namespace fs = std::filesystem;
+    using EFCore::EFontFileError;
+    using namespace EFCoreTestFonts;
+
+    std::string Md5(const std::string& Text)
+    {
+        return EFCore::HashBytes(Text.data(), Text.size());
+    }
+
+    void TestMd5()
+    {
+        // RFC 1321 appendix A.5.
+        EF_CHECK(Md5("") == "d41d8cd98f00b204e9800998ecf8427e");
+        EF_CHECK(Md5("a") == "0cc175b9c0f1b6a831c399e269772661");
+        EF_CHECK(Md5("abc") == "900150983cd24fb0d6963f7d28e17f72");
+        EF_CHECK(Md5("message digest") == "f96b697d7cb7938d525a2f31aaf161d0");
+        EF_CHECK(Md5("abcdefghijklmnopqrstuvwxyz") == "c3fcd3d76192e4007dfb496cca67e13b");
+        EF_CHECK(Md5("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789") == "d174ab98d277d9f5a5611c2c9f419d9f");
+        EF_CHECK(Md5("12345678901234567890123456789012345678901234567890123456789012345678901234567890") == "57edf4a22be3c955ac49da2e2107b67a");
+        EF_CHECK(Md5(std::string(1000000, 'a')) == "7707d6ae4e027c70eea2a935c2296f21");
+
+        // Updates split across block boundaries give the same digest as one update.
+        const std::string Text(1000, 'x');
+        EFCore::FMD5 Hasher;
+        for (size_t Offset = 0; Offset < Text.size(); Offset += 37)
+        {
+            Hasher.Update(Text.data() + Offset, std::min<size_t>(37, Text.size() - Offset));
+        }
+        uint8_t Digest[16];
+        Hasher.Final(Digest);
+        EF_CHECK(EFCore::FMD5::ToHex(Digest) == Md5(Text));
+
+        FTempDir Dir("efcore-md5");
+        const std::vector<uint8_t> Font = MakeFont(GetTrueTypeTables(), 100000);
+        EF_CHECK(WriteFile(Dir.Get() / "a.ttf", Font));
+        EF_CHECK(EFCore::HashFile(Dir.Get() / "a.ttf") == EFCore::HashBytes(Font.data(), Font.size()));
+        EF_CHECK(EFCore::HashFile(Dir.Get() / "missing.ttf").empty());
+    }
+
+    void TestValidate()
+    {
+        EFCore::FFontFileInfo Info;
+        const std::vector<uint8_t> Font = MakeFont(GetTrueTypeTables());
+        EF_CHECK(EFCore::ValidateFont(Font.data(), Font.size(), &Info) == EFontFileError::None);
+        EF_CHECK(Info.NumFaces == 1);
+        EF_CHECK(!Info.bCff);
+        EF_CHECK(Info.Tables.size() == GetTrueTypeTables().size());
+
+        const std::vector<uint8_t> Cff = MakeFont({ "CFF ", "cmap", "head", "hhea", "hmtx", "maxp" });
+        EF_CHECK(EFCore::ValidateFont(Cff.data(), Cff.size(), &Info) == EFontFileError::None);
+        EF_CHECK(Info.bCff);
+
+        const std::vector<uint8_t> Collection = MakeCollection(3);
+        EF_CHECK(EFCore::ValidateFont(Collection.data(), Collection.size(), &Info) == EFontFileError::None);
+        EF_CHECK(Info.NumFaces == 3);
+
+        // Cut inside the table directory, then inside the last table.
+        EF_CHECK(EFCore::ValidateFont(Font.data(), 40, nullptr) == EFontFileError::Truncated);
+        EF_CHECK(EFCore::ValidateFont(Font.data(), Font.size() - 8, nullptr) == EFontFileError::Truncated);
+        EF_CHECK(EFCore::ValidateFont(Collection.data(), Collection.size() - 100, nullptr) == EFontFileError::Truncated);
+        EF_CHECK(EFCore::ValidateFont(Font.data(), 4, nullptr) == EFontFileError::UnknownFormat);
+
+        const std::vector<uint8_t> NoCmap = MakeFont({ "glyf", "head", "hhea", "hmtx", "loca", "maxp" });
+        EF_CHECK(EFCore::ValidateFont(NoCmap.data(), NoCmap.size(), nullptr) == EFontFileError::MissingTable);
+        const std::vector<uint8_t> NoOutlines = MakeFont({ "cmap", "head", "hhea", "hmtx", "maxp" });
+        EF_CHECK(EFCore::ValidateFont(NoOutlines.data(), NoOutlines.size(), nullptr) == EFontFileError::MissingTable);
+
+        const std::string Text = "This is not a font, only some text that is long enough.";
+        EF_CHECK(EFCore::ValidateFont(reinterpret_cast<const uint8_t*>(Text.data()), Text.size(), nullptr) == EFontFileError::UnknownFormat);
+        // Packs belong to the plugin, the core does not accept them.
+        const uint8_t Pack[16] = { 'E', 'F', 'P', 'K' };
+        EF_CHECK(EFCore::ValidateFont(Pack, sizeof(Pack), nullptr) == EFontFileError::UnknownFormat);
+
+        FTempDir Dir("efcore-validate");
+        EF_CHECK(WriteFile(Dir.Get() / "good.ttf", Font));
+        EF_CHECK(WriteFile(Dir.Get() / "cut.ttf", std::vector<uint8_t>(Font.begin(), Font.end() - 8)));
+        EF_CHECK(EFCore::ValidateFontFile(Dir.Get() / "good.ttf", &Info) == EFontFileError::None);
+        EF_CHECK(EFCore::ValidateFontFile(Dir.Get() / "cut.ttf", nullptr) == EFontFileError::Truncated);
+        EF_CHECK(EFCore::ValidateFontFile(Dir.Get() / "missing.ttf", nullptr) == EFontFileError::Unreadable);
+        EF_CHECK(std::strlen(EFCore::LexToString(EFontFileError::Truncated)) > 0);
+    }
+
+    void TestFileNames()
+    {
+        EF_CHECK(EFCore::IsFontFileName("Roboto-Regular.ttf"));
+        EF_CHECK(EFCore::IsFontFileName("NotoSansCJK.TTC"));
+        EF_CHECK(EFCore::IsFontFileName(".otf"));
+        EF_CHECK(!EFCore::IsFontFileName("Fonts.efpack"));
+        EF_CHECK(!EFCore::IsFontFileName("readme.txt"));
+        EF_CHECK(!EFCore::IsFontFileName("ttf"));
+        EF_CHECK(std::find(EFCore::GetFontExtensions().begin(), EFCore::GetFontExtensions().end(), ".efpack") == EFCore::GetFontExtensions().end());
+    }
+
+    void TestPlans()
+    {
+        const std::vector<EFCore::FSlotState> Slots = {
+            { "RegularFont", "Roboto.ttf", true },
+            { "BoldFont", "", true },
+            { "ItalicFont", "Old.ttf", false },
+            { "JapaneseFont", "Noto.otf", true },
+        };
+        const std::map<std::string, std::string> Targets = {
+            { "RegularFont", "Roboto.ttf" },
+            { "BoldFont", "Inter-Bold.ttf" },
+            { "ItalicFont", "New.ttf" },
+        };
+        const std::vector<EFCore::FSlotChange> Install = EFCore::PlanInstall(Slots, Targets);
+        // Unchanged and disabled slots are left alone, a slot missing from the targets goes back to the default.
+        EF_CHECK(Install.size() == 2);
+        EF_CHECK(Install.size() == 2 && Install[0].Name == "BoldFont" && Install[0].Value == "Inter-Bold.ttf");
+        EF_CHECK(Install.size() == 2 && Install[1].Name == "JapaneseFont" && Install[1].Value.empty());
+        EF_CHECK(EFCore::PlanInstall({}, Targets).empty());
+
+        const std::vector<EFCore::FSlotChange> Reset = EFCore::PlanReset(Slots);
+        EF_CHECK(Reset.size() == 3);
+        EF_CHECK(std::all_of(Reset.begin(), Reset.end(), [](const EFCore::FSlotChange& Change) { return Change.Value.empty() && Change.Name != "ItalicFont"; }));
+
+        const std::optional<EFCore::FConversion> ToOtf = EFCore::PlanConversion("fonts/A.ttf");
+        EF_CHECK(ToOtf && ToOtf->Output == fs::path("fonts/A.otf"));
+        const std::optional<EFCore::FConversion> ToTtf = EFCore::PlanConversion("fonts/B.OTF");
+        EF_CHECK(ToTtf && ToTtf->Output == fs::path("fonts/B.ttf"));
+        EF_CHECK(!EFCore::PlanConversion("fonts/C.ttc"));
+        EF_CHECK(!EFCore::PlanConversion("fonts/D"));
+
+        FTempDir Dir("efcore-plan");
+        const std::vector<uint8_t> Font = MakeFont(GetTrueTypeTables());
+        EF_CHECK(WriteFile(Dir.Get() / "One.ttf", Font));
+        EF_CHECK(WriteFile(Dir.Get() / "Two.ttf", Font));
+        EF_CHECK(WriteFile(Dir.Get() / "Two.otf", Font));
+        EF_CHECK(WriteFile(Dir.Get() / "Three.ttc", Font));
+        const std::vector<fs::path> Files = { Dir.Get() / "One.ttf", Dir.Get() / "Two.ttf", Dir.Get() / "Three.ttc", Dir.Get() / "Missing.ttf" };
+        const std::vector<EFCore::FConversion> Skipping = EFCore::PlanConversions(Files, true);
+        EF_CHECK(Skipping.size() == 1 && Skipping[0].Output == Dir.Get() / "One.otf");
+        EF_CHECK(EFCore::PlanConversions(Files, false).size() == 2);
+    }
+
+    void TestReplaceFile()
+    {
+        FTempDir Dir("efcore-replace");
+        const std::vector<uint8_t> NewFont = MakeFont(GetTrueTypeTables(), 300000);
+        const std::vector<uint8_t> OldFont = MakeFont(GetTrueTypeTables(), 16);
+        EF_CHECK(WriteFile(Dir.Get() / "new.ttf", NewFont));
+        EF_CHECK(WriteFile(Dir.Get() / "engine.ttf", OldFont));
+
+        uint64_t Reported = 0;
+        std::string Error;
+        EF_CHECK(EFCore::ReplaceFile(Dir.Get() / "engine.ttf", Dir.Get() / "new.ttf", [&Reported](uint64_t Bytes) { Reported += Bytes; }, &Error));
+        EF_CHECK(Error.empty());
+        EF_CHECK(ReadFile(Dir.Get() / "engine.ttf") == NewFont);
+        EF_CHECK(Reported == NewFont.size());
+
+        // A missing source fails without touching the target.
+        EF_CHECK(WriteFile(Dir.Get() / "engine.ttf", OldFont));
+        EF_CHECK(!EFCore::ReplaceFile(Dir.Get() / "engine.ttf", Dir.Get() / "missing.ttf", nullptr, &Error));
+        EF_CHECK(!Error.empty());
+        EF_CHECK(ReadFile(Dir.Get() / "engine.ttf") == OldFont);
+        // Names outside the ANSI code page come back as UTF-8 instead of throwing on Windows.
+        const std::string Utf8Name = "\xE6\x96\x87\xE5\xAD\x97.ttf";
+        EF_CHECK(!EFCore::ReplaceFile(Dir.Get() / "engine.ttf", Dir.Get() / fs::u8path(Utf8Name), nullptr, &Error));
+        EF_CHECK(Error.find(Utf8Name) != std::string::npos);
+
+        // A target folder that does not exist fails, and no temporary file is left behind anywhere.
+        Error.clear();
+        EF_CHECK(!EFCore::ReplaceFile(Dir.Get() / "nowhere" / "engine.ttf", Dir.Get() / "new.ttf", nullptr, &Error));
+        EF_CHECK(!Error.empty());
+        // Replacing a directory cannot succeed either, the temp file is written and must be cleaned up.
+        fs::create_directories(Dir.Get() / "folder.ttf" / "child");
+        EF_CHECK(!EFCore::ReplaceFile(Dir.Get() / "folder.ttf", Dir.Get() / "new.ttf", nullptr, &Error));
+        for (const fs::directory_entry& Entry : fs::directory_iterator(Dir.Get()))
+        {
+            EF_CHECK(Entry.path().filename().string().find(".eftmp") == std::string::npos);
+        }
+    }
+
+    void TestScan()
+    {
+        FTempDir Dir("efcore-scan");
+        const std::vector<uint8_t> Font = MakeFont(GetTrueTypeTables());
+        fs::create_directories(Dir.Get() / "Latin" / "Serif");
+        fs::create_directories(Dir.Get() / ".hidden");
+        EF_CHECK(WriteFile(Dir.Get() / "Top.ttf", Font));
+        EF_CHECK(WriteFile(Dir.Get() / "Latin" / "Sans.OTF", Font));
+        EF_CHECK(WriteFile(Dir.Get() / "Latin" / "Serif" / "Serif.ttc", Font));
+        EF_CHECK(WriteFile(Dir.Get() / "Latin" / "notes.txt", Font));
+        EF_CHECK(WriteFile(Dir.Get() / "Latin" / "Fonts.efpack", Font));
+        EF_CHECK(WriteFile(Dir.Get() / ".hidden" / "Hidden.ttf", Font));
+        EF_CHECK(WriteFile(Dir.Get() / ".Dot.ttf", Font));
+
+        // A link back to the root is followed once, its fonts are not listed twice.
+        std::error_code LinkError;
+        fs::create_directory_symlink(Dir.Get(), Dir.Get() / "Latin" / "Loop", LinkError);
+
+        const std::vector<fs::path> Files = EFCore::ScanFontFiles({ Dir.Get(), Dir.Get() / "Latin" });
+        EF_CHECK(Files.size() == 3);
+        EF_CHECK(std::is_sorted(Files.begin(), Files.end()));
+        auto Contains = [&Files](const fs::path& Path) { return std::find(Files.begin(), Files.end(), Path) != Files.end(); };
+        const fs::path Root = fs::absolute(Dir.Get()).lexically_normal();
+        EF_CHECK(Contains(Root / "Top.ttf"));
+        EF_CHECK(Contains(Root / "Latin" / "Sans.OTF"));
+        EF_CHECK(Contains(Root / "Latin" / "Serif" / "Serif.ttc"));
+
+        EF_CHECK(EFCore::ScanFontFiles({ Dir.Get() }, 1).size() == 1);
+        EF_CHECK(EFCore::ScanFontFiles({ Dir.Get() / "missing" }).empty());
+    }
+}
+
+int main()
+{
+    const std::pair<const char*, std::function<void()>> Tests[] = {
+        { "Md5", TestMd5 },
+        { "Validate", TestValidate },
+        { "FileNames", TestFileNames },
+        { "Plans", TestPlans },
+        { "ReplaceFile", TestReplaceFile },
+        { "Scan", TestScan },
+    };
+    for (const auto& Test : Tests)
+    {
+        const int Before = Failures;
+        Test.second();
+        std::printf("%-12s %s\n", Test.first, Failures == Before ? "ok" : "FAILED");
+    }
+    return Failures == 0 ? 0 : 1;
+}